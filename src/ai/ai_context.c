@@ -59,9 +59,9 @@ static gchar *build_space_summary(CanvasData *data) {
     return g_strdup("No model data available.");
   }
 
-  GHashTableIter iter;
-  gpointer key, value;
-  g_hash_table_iter_init(&iter, data->model->elements);
+  GPtrArray *elements = g_ptr_array_new();
+  model_collect_space_elements(data->model, data->model->current_space_uuid,
+                               MODEL_TYPE_MASK_ALL, elements);
 
   GHashTable *counts = g_hash_table_new(g_direct_hash, g_direct_equal);
   GPtrArray *titles = g_ptr_array_new_with_free_func(g_free);
@@ -70,14 +70,8 @@ static gchar *build_space_summary(CanvasData *data) {
   guint media_video = 0;
   guint media_audio = 0;
 
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *element = value;
-    if (!element || element->state == MODEL_STATE_DELETED) {
-      continue;
-    }
-    if (g_strcmp0(element->space_uuid, data->model->current_space_uuid) != 0) {
-      continue;
-    }
+  for (guint i = 0; i < elements->len; i++) {
+    ModelElement *element = g_ptr_array_index(elements, i);
     total++;
 
     gpointer count_ptr = g_hash_table_lookup(counts, GINT_TO_POINTER(element->type->type));
@@ -155,6 +149,7 @@ static gchar *build_space_summary(CanvasData *data) {
   }
 
   g_hash_table_destroy(counts);
+  g_ptr_array_free(elements, TRUE);
   g_ptr_array_free(titles, TRUE);
   g_free(space_name);
   return g_string_free(summary, FALSE);
@@ -250,16 +245,14 @@ static gchar *build_recent_element_index(CanvasData *data, guint max_items) {
     return NULL;
   }
 
-  // Build reverse map: uuid -> alias from dsl_aliases
-  GHashTable *uuid_to_alias = g_hash_table_new(g_str_hash, g_str_equal);
+  // Build reverse map: handle -> alias from dsl_aliases
+  GHashTable *handle_to_alias = g_hash_table_new(g_direct_hash, g_direct_equal);
   if (data->dsl_aliases) {
     GHashTableIter alias_iter;
     gpointer alias_key, alias_value;
     g_hash_table_iter_init(&alias_iter, data->dsl_aliases);
     while (g_hash_table_iter_next(&alias_iter, &alias_key, &alias_value)) {
-      const gchar *alias = alias_key;
-      const gchar *uuid = alias_value;
-      g_hash_table_insert(uuid_to_alias, (gpointer)uuid, (gpointer)alias);
+      g_hash_table_insert(handle_to_alias, alias_value, alias_key);
     }
   }
 
@@ -283,7 +276,7 @@ static gchar *build_recent_element_index(CanvasData *data, guint max_items) {
 
   if (entries->len == 0) {
     g_ptr_array_free(entries, TRUE);
-    g_hash_table_destroy(uuid_to_alias);
+    g_hash_table_destroy(handle_to_alias);
     return NULL;
   }
 
@@ -311,7 +304,7 @@ static gchar *build_recent_element_index(CanvasData *data, guint max_items) {
     // Use DSL alias if available, otherwise fall back to UUID
     const gchar *element_id = element->uuid;
     if (element->uuid) {
-      const gchar *alias = g_hash_table_lookup(uuid_to_alias, element->uuid);
+      const gchar *alias = g_hash_table_lookup(handle_to_alias, UUID_HANDLE_TO_POINTER(model_element_handle(element)));
       if (alias) {
         element_id = alias;
       }
@@ -327,7 +320,7 @@ static gchar *build_recent_element_index(CanvasData *data, guint max_items) {
   }
 
   g_ptr_array_free(entries, TRUE);
-  g_hash_table_destroy(uuid_to_alias);
+  g_hash_table_destroy(handle_to_alias);
   return g_string_free(summary, FALSE);
 }
 
@@ -355,15 +348,13 @@ static gchar *build_element_label_summary(CanvasData *data, guint max_items) {
     return NULL;
   }
 
-  GHashTable *uuid_to_alias = g_hash_table_new(g_str_hash, g_str_equal);
+  GHashTable *handle_to_alias = g_hash_table_new(g_direct_hash, g_direct_equal);
   if (data->dsl_aliases) {
     GHashTableIter alias_iter;
     gpointer alias_key, alias_value;
     g_hash_table_iter_init(&alias_iter, data->dsl_aliases);
     while (g_hash_table_iter_next(&alias_iter, &alias_key, &alias_value)) {
-      const gchar *alias = alias_key;
-      const gchar *uuid = alias_value;
-      g_hash_table_insert(uuid_to_alias, (gpointer)uuid, (gpointer)alias);
+      g_hash_table_insert(handle_to_alias, alias_value, alias_key);
     }
   }
 
@@ -393,7 +384,7 @@ static gchar *build_element_label_summary(CanvasData *data, guint max_items) {
     ElementLabelEntry *entry = g_new0(ElementLabelEntry, 1);
     const gchar *alias = element->uuid;
     if (element->uuid) {
-      const gchar *mapped = g_hash_table_lookup(uuid_to_alias, element->uuid);
+      const gchar *mapped = g_hash_table_lookup(handle_to_alias, UUID_HANDLE_TO_POINTER(model_element_handle(element)));
       if (mapped) {
         alias = mapped;
       }
@@ -407,7 +398,7 @@ static gchar *build_element_label_summary(CanvasData *data, guint max_items) {
     g_ptr_array_add(entries, entry);
   }
 
-  g_hash_table_destroy(uuid_to_alias);
+  g_hash_table_destroy(handle_to_alias);
 
   if (entries->len == 0) {
     g_ptr_array_free(entries, TRUE);
@@ -132,6 +132,7 @@ void animation_engine_init(AnimationEngine *engine, bool cycled) {
     engine->animations = NULL;
     engine->count = 0;
     engine->capacity = 0;
+    engine->by_element = NULL;
     engine->elapsed_time = 0.0;
     engine->running = false;
     engine->cycled = cycled;
@@ -143,15 +144,13 @@ void animation_engine_init(AnimationEngine *engine, bool cycled) {
 
 void animation_engine_cleanup(AnimationEngine *engine) {
     if (engine->animations) {
-        // Free UUID strings
-        for (int i = 0; i < engine->count; i++) {
-            if (engine->animations[i].element_uuid) {
-                free(engine->animations[i].element_uuid);
-            }
-        }
         free(engine->animations);
         engine->animations = NULL;
     }
+    if (engine->by_element) {
+        g_hash_table_destroy(engine->by_element);
+        engine->by_element = NULL;
+    }
     engine->count = 0;
     engine->capacity = 0;
     if (engine->tick_callback_id && engine->widget) {
@@ -169,6 +168,34 @@ static void ensure_capacity(AnimationEngine *engine) {
     }
 }
 
+static void animation_slots_free(gpointer slots) {
+    g_array_free(slots, TRUE);
+}
+
+// Record that animations[index] belongs to an element and return its handle.
+// Getters walk only the element's own animations, in the order they were added.
+static UuidHandle animation_engine_track(AnimationEngine *engine, const char *element_uuid, int index) {
+    UuidHandle element = uuid_intern(element_uuid);
+    if (element == UUID_HANDLE_NONE) return element;
+
+    if (!engine->by_element) {
+        engine->by_element = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                                   NULL, animation_slots_free);
+    }
+    GArray *slots = g_hash_table_lookup(engine->by_element, UUID_HANDLE_TO_POINTER(element));
+    if (!slots) {
+        slots = g_array_new(FALSE, FALSE, sizeof(int));
+        g_hash_table_insert(engine->by_element, UUID_HANDLE_TO_POINTER(element), slots);
+    }
+    g_array_append_val(slots, index);
+    return element;
+}
+
+static GArray* animation_engine_slots(AnimationEngine *engine, UuidHandle element) {
+    if (!engine->by_element || element == UUID_HANDLE_NONE) return NULL;
+    return g_hash_table_lookup(engine->by_element, UUID_HANDLE_TO_POINTER(element));
+}
+
 void animation_add_move(AnimationEngine *engine, const char *element_uuid,
                        double start_time, double duration,
                        AnimInterpolationType interp,
@@ -179,7 +206,7 @@ void animation_add_move(AnimationEngine *engine, const char *element_uuid,
     Animation *anim = &engine->animations[engine->count++];
     memset(anim, 0, sizeof(Animation));
 
-    anim->element_uuid = strdup(element_uuid);
+    anim->element = animation_engine_track(engine, element_uuid, engine->count - 1);
     anim->type = ANIM_TYPE_MOVE;
     anim->interp = interp;
     anim->start_time = start_time;
@@ -201,7 +228,7 @@ void animation_add_resize(AnimationEngine *engine, const char *element_uuid,
     Animation *anim = &engine->animations[engine->count++];
     memset(anim, 0, sizeof(Animation));
 
-    anim->element_uuid = strdup(element_uuid);
+    anim->element = animation_engine_track(engine, element_uuid, engine->count - 1);
     anim->type = ANIM_TYPE_RESIZE;
     anim->interp = interp;
     anim->start_time = start_time;
@@ -222,7 +249,7 @@ void animation_add_color(AnimationEngine *engine, const char *element_uuid,
     Animation *anim = &engine->animations[engine->count++];
     memset(anim, 0, sizeof(Animation));
 
-    anim->element_uuid = strdup(element_uuid);
+    anim->element = animation_engine_track(engine, element_uuid, engine->count - 1);
     anim->type = ANIM_TYPE_COLOR;
     anim->interp = interp;
     anim->start_time = start_time;
@@ -241,7 +268,7 @@ void animation_add_rotate(AnimationEngine *engine, const char *element_uuid,
     Animation *anim = &engine->animations[engine->count++];
     memset(anim, 0, sizeof(Animation));
 
-    anim->element_uuid = strdup(element_uuid);
+    anim->element = animation_engine_track(engine, element_uuid, engine->count - 1);
     anim->type = ANIM_TYPE_ROTATE;
     anim->interp = interp;
     anim->start_time = start_time;
@@ -259,7 +286,7 @@ void animation_add_create(AnimationEngine *engine, const char *element_uuid,
     Animation *anim = &engine->animations[engine->count++];
     memset(anim, 0, sizeof(Animation));
 
-    anim->element_uuid = strdup(element_uuid);
+    anim->element = animation_engine_track(engine, element_uuid, engine->count - 1);
     anim->type = ANIM_TYPE_CREATE;
     anim->interp = interp;
     anim->start_time = start_time;
@@ -275,7 +302,7 @@ void animation_add_delete(AnimationEngine *engine, const char *element_uuid,
     Animation *anim = &engine->animations[engine->count++];
     memset(anim, 0, sizeof(Animation));
 
-    anim->element_uuid = strdup(element_uuid);
+    anim->element = animation_engine_track(engine, element_uuid, engine->count - 1);
     anim->type = ANIM_TYPE_DELETE;
     anim->interp = interp;
     anim->start_time = start_time;
@@ -313,20 +340,22 @@ void animation_engine_start(AnimationEngine *engine, GtkWidget *widget, gpointer
         widget, on_animation_tick, engine, NULL);
 }
 
-// Returns animation values for a given element_uuid
+// Returns animation values for a given element
 // Returns true if the element has an active animation
-bool animation_engine_get_position(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_position(AnimationEngine *engine, UuidHandle element,
                                   double *out_x, double *out_y) {
-    if (!engine->running || !element_uuid) return false;
+    if (!engine->running) return false;
+
+    GArray *slots = animation_engine_slots(engine, element);
+    if (!slots) return false;
 
     Animation *current_anim = NULL;
     Animation *last_completed = NULL;
 
     // Find the current active animation or the last completed one
-    for (int i = 0; i < engine->count; i++) {
-        Animation *anim = &engine->animations[i];
+    for (guint i = 0; i < slots->len; i++) {
+        Animation *anim = &engine->animations[g_array_index(slots, int, i)];
 
-        if (!anim->element_uuid || strcmp(anim->element_uuid, element_uuid) != 0) continue;
         if (anim->type != ANIM_TYPE_MOVE) continue;
 
         double anim_end_time = anim->start_time + anim->duration;
@@ -374,18 +403,20 @@ bool animation_engine_get_position(AnimationEngine *engine, const char *element_
     return false;
 }
 
-bool animation_engine_get_size(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_size(AnimationEngine *engine, UuidHandle element,
                               double *out_width, double *out_height) {
-    if (!engine->running || !element_uuid) return false;
+    if (!engine->running) return false;
+
+    GArray *slots = animation_engine_slots(engine, element);
+    if (!slots) return false;
 
     Animation *current_anim = NULL;
     Animation *last_completed = NULL;
 
     // Find the current active animation or the last completed one
-    for (int i = 0; i < engine->count; i++) {
-        Animation *anim = &engine->animations[i];
+    for (guint i = 0; i < slots->len; i++) {
+        Animation *anim = &engine->animations[g_array_index(slots, int, i)];
 
-        if (!anim->element_uuid || strcmp(anim->element_uuid, element_uuid) != 0) continue;
         if (anim->type != ANIM_TYPE_RESIZE) continue;
 
         double anim_end_time = anim->start_time + anim->duration;
@@ -431,17 +462,19 @@ bool animation_engine_get_size(AnimationEngine *engine, const char *element_uuid
     return false;
 }
 
-bool animation_engine_get_color(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_color(AnimationEngine *engine, UuidHandle element,
                                double *out_r, double *out_g, double *out_b, double *out_a) {
-    if (!engine->running || !element_uuid) return false;
+    if (!engine->running) return false;
+
+    GArray *slots = animation_engine_slots(engine, element);
+    if (!slots) return false;
 
     Animation *current_anim = NULL;
     Animation *last_completed = NULL;
 
-    for (int i = 0; i < engine->count; i++) {
-        Animation *anim = &engine->animations[i];
+    for (guint i = 0; i < slots->len; i++) {
+        Animation *anim = &engine->animations[g_array_index(slots, int, i)];
 
-        if (!anim->element_uuid || strcmp(anim->element_uuid, element_uuid) != 0) continue;
         if (anim->type != ANIM_TYPE_COLOR) continue;
 
         double anim_end_time = anim->start_time + anim->duration;
@@ -492,17 +525,19 @@ bool animation_engine_get_color(AnimationEngine *engine, const char *element_uui
     return false;
 }
 
-bool animation_engine_get_rotation(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_rotation(AnimationEngine *engine, UuidHandle element,
                                    double *out_rotation) {
-    if (!engine->running || !element_uuid) return false;
+    if (!engine->running) return false;
+
+    GArray *slots = animation_engine_slots(engine, element);
+    if (!slots) return false;
 
     Animation *current_anim = NULL;
     Animation *last_completed = NULL;
 
-    for (int i = 0; i < engine->count; i++) {
-        Animation *anim = &engine->animations[i];
+    for (guint i = 0; i < slots->len; i++) {
+        Animation *anim = &engine->animations[g_array_index(slots, int, i)];
 
-        if (!anim->element_uuid || strcmp(anim->element_uuid, element_uuid) != 0) continue;
         if (anim->type != ANIM_TYPE_ROTATE) continue;
 
         double anim_end_time = anim->start_time + anim->duration;
@@ -545,17 +580,19 @@ bool animation_engine_get_rotation(AnimationEngine *engine, const char *element_
     return false;
 }
 
-bool animation_engine_get_visibility(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_visibility(AnimationEngine *engine, UuidHandle element,
                                     double *out_alpha) {
-    if (!engine->running || !element_uuid) return false;
+    if (!engine->running) return false;
+
+    GArray *slots = animation_engine_slots(engine, element);
+    if (!slots) return false;
 
     Animation *current_anim = NULL;
     Animation *last_completed = NULL;
 
-    for (int i = 0; i < engine->count; i++) {
-        Animation *anim = &engine->animations[i];
+    for (guint i = 0; i < slots->len; i++) {
+        Animation *anim = &engine->animations[g_array_index(slots, int, i)];
 
-        if (!anim->element_uuid || strcmp(anim->element_uuid, element_uuid) != 0) continue;
         if (anim->type != ANIM_TYPE_CREATE && anim->type != ANIM_TYPE_DELETE) continue;
 
         double anim_end_time = anim->start_time + anim->duration;
@@ -626,8 +663,8 @@ bool animation_engine_tick(AnimationEngine *engine, double delta_time) {
             if (!anim->completed) {
                 anim->completed = true;
                 CanvasData *data = (CanvasData *)engine->user_data;
-                if (data && anim->element_uuid) {
-                    ModelElement *model_element = g_hash_table_lookup(data->model->elements, anim->element_uuid);
+                if (data) {
+                    ModelElement *model_element = model_get_element(data->model, anim->element);
                     if (model_element) {
                         int current_z = model_element->position ? model_element->position->z :
                                          (model_element->visual_element ? model_element->visual_element->z : 0);
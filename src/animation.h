@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <gtk/gtk.h>
+#include "uuid_intern.h"
 
 typedef enum {
     ANIM_INTERP_IMMEDIATE,  // No interpolation, jump to end
@@ -25,7 +26,7 @@ typedef enum {
 } AnimationType;
 
 typedef struct {
-    char *element_uuid;  // Element UUID string
+    UuidHandle element;  // Interned element uuid
     AnimationType type;
     AnimInterpolationType interp;
 
@@ -56,6 +57,7 @@ typedef struct {
     Animation *animations;
     int count;
     int capacity;
+    GHashTable *by_element;  // UuidHandle -> GArray of int indices into animations, in order
 
     double elapsed_time;
     bool running;
@@ -110,20 +112,21 @@ void animation_engine_reset(AnimationEngine *engine);
 // Update (called every frame)
 bool animation_engine_tick(AnimationEngine *engine, double delta_time);
 
-// Get animated values for an element
-bool animation_engine_get_position(AnimationEngine *engine, const char *element_uuid,
+// Get animated values for an element. Called per element per frame, so
+// elements are passed by interned handle rather than uuid string.
+bool animation_engine_get_position(AnimationEngine *engine, UuidHandle element,
                                   double *out_x, double *out_y);
 
-bool animation_engine_get_size(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_size(AnimationEngine *engine, UuidHandle element,
                               double *out_width, double *out_height);
 
-bool animation_engine_get_color(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_color(AnimationEngine *engine, UuidHandle element,
                                double *out_r, double *out_g, double *out_b, double *out_a);
 
-bool animation_engine_get_rotation(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_rotation(AnimationEngine *engine, UuidHandle element,
                                    double *out_rotation);
 
-bool animation_engine_get_visibility(AnimationEngine *engine, const char *element_uuid,
+bool animation_engine_get_visibility(AnimationEngine *engine, UuidHandle element,
                                     double *out_alpha);
 
 // Interpolation helpers
@@ -8,7 +8,9 @@
 #include "../elements/connection.h"
 #include "../elements/freehand_drawing.h"
 #include "../elements/shape.h"
-#include "../quadtree.h"
+#include "../spatial_index.h"
+#include "../display_list.h"
+#include "canvas_tile_cache.h"
 #include "../animation.h"
 #include "../ui_event_bus.h"
 
@@ -54,6 +56,7 @@ struct _CanvasData {
   double offset_x;
   double offset_y;
   double zoom_scale;
+  ElementLodSettings lod_settings;  // Zoomed-out rendering thresholds
 
   double last_mouse_x;
   double last_mouse_y;
@@ -91,9 +94,9 @@ struct _CanvasData {
   GdkRGBA grid_color;
 
   // Hidden elements tracking
-  GHashTable *hidden_elements; // uuid string -> gboolean
+  GHashTable *hidden_elements; // Set of UuidHandle
   // OPTIMIZATION: Cache which elements have hidden children for O(1) lookups
-  GHashTable *hidden_children_cache; // parent_uuid string -> gboolean
+  GHashTable *hidden_children_cache; // Set of parent UuidHandle
 
   // Audio playback state persistence
   GHashTable *audio_playback_states; // uuid string -> AudioPlaybackState*
@@ -145,8 +148,16 @@ struct _CanvasData {
   // Copy/paste management
   GList *copied_elements;
 
-  // Spatial index for fast element picking
-  QuadTree *quadtree;
+  // Spatial index for fast element picking and viewport culling; the
+  // backend is chosen by the canvas.spatial_index setting
+  SpatialIndex *spatial_index;
+
+  // Z-ordered render list for the current space
+  DisplayList *display_list;
+  GPtrArray *visible_elements;  // Scratch buffer for the per-frame viewport query
+
+  // Rasterized tiles of static content, reused across frames
+  CanvasTileCache *tile_cache;
 
   // UI event bus subscriptions
   guint ui_event_subscriptions[UI_EVENT_TYPE_COUNT];
@@ -158,7 +169,7 @@ struct _CanvasData {
   Element *dsl_pressed_element;
   gboolean dsl_pressed_valid;
 
-  GHashTable *dsl_aliases;   // alias string -> uuid string
+  GHashTable *dsl_aliases;   // alias string -> UuidHandle
 
   AiRuntime *ai_runtime;
 
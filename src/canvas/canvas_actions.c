@@ -611,12 +611,14 @@ static void apply_stroke_color_to_element(CanvasData *data, Element *element, co
       shape->stroke_b = color->blue;
       shape->stroke_a = color->alpha;
       // Update model's stroke_color hex string
-      g_free(model_el->stroke_color);
-      model_el->stroke_color = g_strdup_printf("#%02x%02x%02x%02x",
+      gchar *stroke_color = g_strdup_printf("#%02x%02x%02x%02x",
         (int)(color->red * 255),
         (int)(color->green * 255),
         (int)(color->blue * 255),
         (int)(color->alpha * 255));
+      model_element_set_string(model_el, &model_el->stroke_color, stroke_color);
+      g_free(stroke_color);
+      model_mark_updated(data->model, model_el, MODEL_FIELD_SHAPE);
       break;
     }
     case ELEMENT_CONNECTION: {
@@ -1,6 +1,7 @@
 #include "canvas_core.h"
 #include "canvas_input.h"
 #include "canvas_spaces.h"
+#include "canvas_tile_cache.h"
 #include "../elements/connection.h"
 #include "../elements/element.h"
 #include "../elements/freehand_drawing.h"
@@ -17,10 +18,47 @@
 #include "../database.h"
 #include "../ai/ai_runtime.h"
 
-static gint compare_elements_by_z_index(gconstpointer a, gconstpointer b) {
-  const Element *element_a = (const Element*)a;
-  const Element *element_b = (const Element*)b;
-  return element_a->z - element_b->z;
+#define KEY_LOD_DETAIL_ZOOM "canvas.lod_detail_zoom"
+#define KEY_LOD_BLOCK_PIXELS "canvas.lod_block_pixels"
+#define KEY_LOD_MIN_TEXT_PIXELS "canvas.lod_min_text_pixels"
+
+#define DEFAULT_LOD_DETAIL_ZOOM 0.3
+#define DEFAULT_LOD_BLOCK_PIXELS 6.0
+#define DEFAULT_LOD_MIN_TEXT_PIXELS 5.0
+
+#define KEY_SPATIAL_INDEX "canvas.spatial_index"
+
+static double parse_setting_double(sqlite3 *db, const char *key, double fallback) {
+  gchar *value = NULL;
+  if (!db || !database_get_setting(db, key, &value)) {
+    return fallback;
+  }
+
+  char *endptr = NULL;
+  double parsed = g_ascii_strtod(value, &endptr);
+  gboolean valid = endptr && endptr != value && *endptr == '\0' && parsed >= 0.0;
+  g_free(value);
+  return valid ? parsed : fallback;
+}
+
+// Thresholds can be tuned per database through app_settings
+static void canvas_load_lod_settings(CanvasData *data) {
+  sqlite3 *db = data->model ? data->model->db : NULL;
+  data->lod_settings.detail_zoom = parse_setting_double(db, KEY_LOD_DETAIL_ZOOM, DEFAULT_LOD_DETAIL_ZOOM);
+  data->lod_settings.block_pixels = parse_setting_double(db, KEY_LOD_BLOCK_PIXELS, DEFAULT_LOD_BLOCK_PIXELS);
+  data->lod_settings.min_text_pixels = parse_setting_double(db, KEY_LOD_MIN_TEXT_PIXELS, DEFAULT_LOD_MIN_TEXT_PIXELS);
+}
+
+// "quadtree" (default) or "rtree", see spatial_index.h
+static SpatialIndex* canvas_create_spatial_index(CanvasData *data) {
+  sqlite3 *db = data->model ? data->model->db : NULL;
+  gchar *value = NULL;
+  SpatialIndexKind kind = SPATIAL_INDEX_QUADTREE;
+  if (db && database_get_setting(db, KEY_SPATIAL_INDEX, &value)) {
+    kind = spatial_index_kind_from_string(value, SPATIAL_INDEX_QUADTREE);
+    g_free(value);
+  }
+  return spatial_index_new(kind);
 }
 
 static gboolean parse_hex_color(const char *hex_color, double *r, double *g, double *b) {
@@ -67,16 +105,16 @@ static gboolean parse_hex_color_rgba(const char *hex_color, ElementColor *color)
 }
 
 static void canvas_remove_alias_for_uuid(CanvasData *data, const char *uuid) {
-  if (!data || !data->dsl_aliases || !uuid) {
+  UuidHandle handle = uuid_intern_lookup(uuid);
+  if (!data || !data->dsl_aliases || handle == UUID_HANDLE_NONE) {
     return;
   }
 
   GHashTableIter iter;
-  gpointer key, value;
+  gpointer value;
   g_hash_table_iter_init(&iter, data->dsl_aliases);
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    const gchar *stored_uuid = value;
-    if (g_strcmp0(stored_uuid, uuid) == 0) {
+  while (g_hash_table_iter_next(&iter, NULL, &value)) {
+    if (UUID_POINTER_TO_HANDLE(value) == handle) {
       g_hash_table_iter_remove(&iter);
     }
   }
@@ -138,7 +176,7 @@ CanvasData* canvas_data_new_with_db(GtkWidget *drawing_area, GtkWidget *overlay,
   data->dsl_runtime = NULL;
   data->dsl_pressed_element = NULL;
   data->dsl_pressed_valid = FALSE;
-  data->dsl_aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  data->dsl_aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 
   // Initialize grid settings
   data->show_grid = FALSE;
@@ -147,10 +185,12 @@ CanvasData* canvas_data_new_with_db(GtkWidget *drawing_area, GtkWidget *overlay,
   // Initialize space name display (default to shown)
   data->show_space_name = TRUE;
 
+  canvas_load_lod_settings(data);
+
   // Initialize hidden elements tracking
-  data->hidden_elements = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  data->hidden_elements = g_hash_table_new(g_direct_hash, g_direct_equal);
   // OPTIMIZATION: Initialize hidden children cache
-  data->hidden_children_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  data->hidden_children_cache = g_hash_table_new(g_direct_hash, g_direct_equal);
 
   data->audio_playback_states = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 
@@ -160,9 +200,10 @@ CanvasData* canvas_data_new_with_db(GtkWidget *drawing_area, GtkWidget *overlay,
   data->animation_timer_id = 0;
   data->is_loading_space = FALSE;
 
-  // Initialize quadtree with a large canvas bounds
-  // The quadtree will cover a 100000x100000 canvas centered at origin
-  data->quadtree = quadtree_new(-50000, -50000, 100000, 100000);
+  data->spatial_index = canvas_create_spatial_index(data);
+  data->display_list = display_list_new();
+  data->visible_elements = g_ptr_array_new();
+  data->tile_cache = canvas_tile_cache_new();
 
   if (data->model != NULL && data->model->db != NULL) {
     canvas_sync_with_model(data);
@@ -171,16 +212,11 @@ CanvasData* canvas_data_new_with_db(GtkWidget *drawing_area, GtkWidget *overlay,
   return data;
 }
 
-GList* sort_model_elements_for_serialization(GHashTable *elements_table) {
-  GList *elements_list = g_hash_table_get_values(elements_table);
-  return g_list_sort(elements_list, (GCompareFunc)model_compare_for_saving_loading);
-}
-
-static void update_text_base(char **dest_text,
-                             char **dest_font,
-                             double *r, double *g, double *b, double *a,
-                             ModelText *src_text) {
-  if (!src_text || !src_text->text) return;
+static gboolean update_text_base(char **dest_text,
+                                 char **dest_font,
+                                 double *r, double *g, double *b, double *a,
+                                 ModelText *src_text) {
+  if (!src_text || !src_text->text) return FALSE;
 
   if (*dest_text == NULL ||
       strcmp(*dest_text, src_text->text) != 0 ||
@@ -199,10 +235,32 @@ static void update_text_base(char **dest_text,
     *g = src_text->g;
     *b = src_text->b;
     *a = src_text->a;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+// Visual of the element with this handle, if it has been built yet
+static Element* canvas_lookup_visual(CanvasData *data, UuidHandle handle) {
+  ModelElement *model_element = model_get_element(data->model, handle);
+  return model_element ? model_element->visual_element : NULL;
+}
+
+static gboolean connection_endpoints_ready(CanvasData *data, ModelElement *model_element) {
+  return canvas_lookup_visual(data, model_connection_from(model_element)) &&
+         canvas_lookup_visual(data, model_connection_to(model_element));
+}
+
+static void canvas_build_visual(CanvasData *data, ModelElement *model_element) {
+  Element *visual_element = create_visual_element(model_element, data);
+  if (visual_element) {
+    model_element->visual_element = visual_element;
+    visual_element->model_element = model_element;  // OPTIMIZATION: Set reverse pointer
   }
 }
 
 void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data) {
+  GList *deferred = NULL;
   GList *iter = sorted_elements;
   while (iter != NULL) {
     ModelElement *model_element = (ModelElement*)iter->data;
@@ -214,8 +272,7 @@ void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data)
         canvas_remove_alias_for_uuid(data, model_element->uuid);
       }
       if (visual_element) {
-        data->selected_elements = g_list_remove(data->selected_elements, visual_element);
-        element_free(visual_element);
+        canvas_free_visual_element(data, visual_element);
         model_element->visual_element = NULL;
       }
       iter = iter->next;
@@ -254,10 +311,26 @@ void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data)
         if (visual_element->x != model_element->position->x ||
             visual_element->y != model_element->position->y ||
             visual_element->z != model_element->position->z) {
+          int old_z = visual_element->z;
           visual_element->x = model_element->position->x;
           visual_element->y = model_element->position->y;
           visual_element->z = model_element->position->z;
+          if (old_z != visual_element->z) {
+            display_list_update_z(data->display_list, visual_element, old_z);
+          }
+        }
+      }
+
+      // Keep the render list in step with space membership
+      if (g_strcmp0(model_element->space_uuid, data->model->current_space_uuid) == 0) {
+        if (!display_list_contains(data->display_list, visual_element)) {
+          display_list_insert(data->display_list, visual_element);
+        }
+      } else {
+        if (display_list_contains(data->display_list, visual_element)) {
+          display_list_remove(data->display_list, visual_element);
         }
+        spatial_index_remove(data->spatial_index, visual_element);
       }
 
       // Update size if changed
@@ -289,37 +362,38 @@ void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data)
 
       // Handle text updates for specific element types
       if (model_element->text && model_element->text->text) {
+        gboolean appearance_changed = FALSE;
         switch (visual_element->type) {
         case ELEMENT_NOTE: {
           Note *note = (Note *)visual_element;
-          update_text_base(&note->text, &note->font_description,
-                           &note->text_r, &note->text_g,
-                           &note->text_b, &note->text_a,
-                           model_element->text);
+          appearance_changed = update_text_base(&note->text, &note->font_description,
+                                                &note->text_r, &note->text_g,
+                                                &note->text_b, &note->text_a,
+                                                model_element->text);
           break;
         }
         case ELEMENT_PAPER_NOTE: {
           PaperNote *note = (PaperNote *)visual_element;
-          update_text_base(&note->text, &note->font_description,
-                           &note->text_r, &note->text_g,
-                           &note->text_b, &note->text_a,
-                           model_element->text);
+          appearance_changed = update_text_base(&note->text, &note->font_description,
+                                                &note->text_r, &note->text_g,
+                                                &note->text_b, &note->text_a,
+                                                model_element->text);
           break;
         }
         case ELEMENT_MEDIA_FILE: {
           MediaNote *note = (MediaNote *)visual_element;
-          update_text_base(&note->text, &note->font_description,
-                           &note->text_r, &note->text_g,
-                           &note->text_b, &note->text_a,
-                           model_element->text);
+          appearance_changed = update_text_base(&note->text, &note->font_description,
+                                                &note->text_r, &note->text_g,
+                                                &note->text_b, &note->text_a,
+                                                model_element->text);
           break;
         }
         case ELEMENT_SPACE: {
           SpaceElement *note = (SpaceElement *)visual_element;
-          update_text_base(&note->text, &note->font_description,
-                           &note->text_r, &note->text_g,
-                           &note->text_b, &note->text_a,
-                           model_element->text);
+          appearance_changed = update_text_base(&note->text, &note->font_description,
+                                                &note->text_r, &note->text_g,
+                                                &note->text_b, &note->text_a,
+                                                model_element->text);
           break;
         }
         case ELEMENT_CONNECTION:
@@ -330,10 +404,11 @@ void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data)
           break;
         case ELEMENT_SHAPE: {
           Shape *shape = (Shape *)visual_element;
-          update_text_base(&shape->text, &shape->font_description,
-                           &shape->text_r, &shape->text_g,
-                           &shape->text_b, &shape->text_a,
-                           model_element->text);
+          Shape old_style = *shape;
+          appearance_changed = update_text_base(&shape->text, &shape->font_description,
+                                                &shape->text_r, &shape->text_g,
+                                                &shape->text_b, &shape->text_a,
+                                                model_element->text);
 
           int new_stroke_width = model_element->stroke_width > 0 ? model_element->stroke_width : shape->stroke_width;
           if (shape->stroke_width != new_stroke_width) {
@@ -365,27 +440,40 @@ void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data)
             shape->stroke_b = stroke_color.b;
             shape->stroke_a = stroke_color.a;
           }
+
+          if (old_style.stroke_width != shape->stroke_width ||
+              old_style.filled != shape->filled ||
+              old_style.stroke_style != shape->stroke_style ||
+              old_style.fill_style != shape->fill_style ||
+              old_style.stroke_r != shape->stroke_r || old_style.stroke_g != shape->stroke_g ||
+              old_style.stroke_b != shape->stroke_b || old_style.stroke_a != shape->stroke_a) {
+            appearance_changed = TRUE;
+          }
           break;
         }
         case ELEMENT_INLINE_TEXT: {
           InlineText *text = (InlineText *)visual_element;
-          update_text_base(&text->text, &text->font_description,
-                           &text->text_r, &text->text_g,
-                           &text->text_b, &text->text_a,
-                           model_element->text);
+          appearance_changed = update_text_base(&text->text, &text->font_description,
+                                                &text->text_r, &text->text_g,
+                                                &text->text_b, &text->text_a,
+                                                model_element->text);
           break;
         }
         }
+
+        // Cached tiles only notice geometry and colour changes by themselves
+        if (appearance_changed) {
+          element_invalidate(visual_element);
+        }
       }
 
+    } else if (model_element->type && model_element->type->type == ELEMENT_CONNECTION &&
+               !connection_endpoints_ready(data, model_element)) {
+      // An endpoint further down the list has no visual yet; retried below
+      deferred = g_list_prepend(deferred, model_element);
     } else {
       // Create new visual element if it doesn't exist
-      Element *visual_element = create_visual_element(model_element, data);
-      if (visual_element) {
-        model_element->visual_element = visual_element;
-        visual_element->model_element = model_element;  // OPTIMIZATION: Set reverse pointer
-
-      }
+      canvas_build_visual(data, model_element);
     }
 
     // Update z-index tracking
@@ -395,6 +483,31 @@ void create_or_update_visual_elements(GList *sorted_elements, CanvasData *data)
 
     iter = iter->next;
   }
+
+  // Deferred connections may end on each other, so keep passing over them
+  // while any of them becomes buildable
+  deferred = g_list_reverse(deferred);
+  gboolean progress = TRUE;
+  while (deferred && progress) {
+    progress = FALSE;
+    GList *l = deferred;
+    while (l) {
+      GList *next = l->next;
+      ModelElement *model_element = (ModelElement*)l->data;
+      if (connection_endpoints_ready(data, model_element)) {
+        canvas_build_visual(data, model_element);
+        deferred = g_list_delete_link(deferred, l);
+        progress = TRUE;
+      }
+      l = next;
+    }
+  }
+
+  // Whatever is left has an endpoint that is not loaded; this reports it
+  for (GList *l = deferred; l != NULL; l = l->next) {
+    canvas_build_visual(data, (ModelElement*)l->data);
+  }
+  g_list_free(deferred);
 }
 
 void canvas_data_free(CanvasData *data) {
@@ -429,8 +542,11 @@ void canvas_data_free(CanvasData *data) {
     data->animation_timer_id = 0;
   }
 
-  // Clean up quadtree
-  if (data->quadtree) quadtree_free(data->quadtree);
+  // Clean up spatial index
+  spatial_index_free(data->spatial_index);
+  if (data->display_list) display_list_free(data->display_list);
+  if (data->visible_elements) g_ptr_array_free(data->visible_elements, TRUE);
+  canvas_tile_cache_free(data->tile_cache);
 
   ai_runtime_free(data->ai_runtime);
 
@@ -447,6 +563,32 @@ void canvas_data_free(CanvasData *data) {
   g_free(data);
 }
 
+// Draw indicator if element has hidden children
+static void draw_hidden_children_indicator(CanvasData *data, cairo_t *cr, Element *element) {
+  // OPTIMIZATION: Use cached reverse pointer instead of O(n) lookup
+  if (element->model_element && canvas_has_hidden_children(data, model_element_handle(element->model_element))) {
+    // Draw a small triangle indicator in the bottom-right corner
+    double indicator_size = 8.0;
+    double x = (element->x + element->width - indicator_size - 3) * data->zoom_scale + data->offset_x * data->zoom_scale;
+    double y = (element->y + element->height - indicator_size - 3) * data->zoom_scale + data->offset_y * data->zoom_scale;
+
+    cairo_save(cr);
+    cairo_set_source_rgba(cr, 1.0, 0.5, 0.0, 0.8); // Orange color
+    cairo_move_to(cr, x, y + indicator_size);
+    cairo_line_to(cr, x + indicator_size, y + indicator_size);
+    cairo_line_to(cr, x + indicator_size / 2, y);
+    cairo_close_path(cr);
+    cairo_fill(cr);
+    cairo_restore(cr);
+  }
+}
+
+static gint compare_elements_by_z(gconstpointer a, gconstpointer b) {
+  const Element *element_a = *(Element* const*)a;
+  const Element *element_b = *(Element* const*)b;
+  return (element_a->z > element_b->z) - (element_a->z < element_b->z);
+}
+
 void canvas_on_draw(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int height, gpointer user_data) {
   CanvasData *data = (CanvasData*)user_data;
   // Apply zoom and panning transformations
@@ -568,41 +710,68 @@ void canvas_on_draw(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int he
   int visible_width = gtk_widget_get_width(data->drawing_area) / data->zoom_scale;
   int visible_height = gtk_widget_get_height(data->drawing_area) / data->zoom_scale;
 
-  // OPTIMIZATION: Collect only visible elements first, then sort
-  GList *visual_elements = canvas_get_visual_elements(data);
-  GList *visible_elements = NULL;
-
-  for (GList *l = visual_elements; l != NULL; l = l->next) {
+  // Static content comes from cached tiles; must run before the viewport
+  // query below since tile queries reuse the element query stamps
+  gboolean tiles_drawn = canvas_tile_cache_draw(data->tile_cache, data, cr,
+                                                visible_x, visible_y,
+                                                visible_width, visible_height);
+
+  // Ask the spatial index for what is on screen. Drag, resize and rotate keep
+  // the index current; selected elements are still added explicitly because
+  // other in-place edits (typing, control points) reach it only on the next sync
+  GPtrArray *visible = data->visible_elements;
+  g_ptr_array_set_size(visible, 0);
+  guint stamp = spatial_index_query_rect(data->spatial_index, visible_x, visible_y,
+                                         visible_width, visible_height, visible);
+  for (GList *l = data->selected_elements; l != NULL; l = l->next) {
     Element *element = (Element*)l->data;
+    if (element->spatial_stamp != stamp) {
+      element->spatial_stamp = stamp;
+      g_ptr_array_add(visible, element);
+    }
+  }
+
+  // When most of the space is on screen, walking the z-ordered display list and
+  // picking stamped entries is cheaper than sorting the visible set
+  guint display_count = display_list_length(data->display_list);
+  gboolean use_display_list = visible->len * 4 >= display_count;
+  if (!use_display_list) {
+    g_ptr_array_sort(visible, compare_elements_by_z);
+  }
 
-    // Don't cull connections - their bounds are updated during draw and curves extend beyond bounding box
-    if (element->type != ELEMENT_CONNECTION) {
-      // View frustum culling - skip elements completely outside viewport
-      // Note: using >= and <= to ensure partially visible elements are drawn
-      if (element->x >= visible_x + visible_width ||
-          element->y >= visible_y + visible_height ||
-          element->x + element->width <= visible_x ||
-          element->y + element->height <= visible_y) {
-        continue;
+  guint draw_count = use_display_list ? display_count : visible->len;
+  for (guint i = 0; i < draw_count; i++) {
+    Element *element;
+    if (use_display_list) {
+      element = display_list_get(data->display_list, i);
+      if (element->spatial_stamp != stamp) {
+        continue;  // Outside the viewport
       }
+    } else {
+      element = g_ptr_array_index(visible, i);
     }
 
-    // Skip drawing hidden elements
-    // OPTIMIZATION: Use cached reverse pointer instead of O(n) lookup
-    if (element->model_element && canvas_is_element_hidden(data, element->model_element->uuid)) {
+    // Freed model elements leave their visual in the index until the next sync
+    if (!element->model_element) {
       continue;
     }
 
-    // Add to visible elements list
-    visible_elements = g_list_prepend(visible_elements, element);
-  }
+    // Deleted elements stay listed until the next model sync frees them
+    if (element->model_element->state == MODEL_STATE_DELETED) {
+      continue;
+    }
 
-  // Sort only the visible elements by z-index
-  visible_elements = g_list_sort(visible_elements, compare_elements_by_z_index);
+    // Skip drawing hidden elements
+    // OPTIMIZATION: Use cached reverse pointer instead of O(n) lookup
+    if (element->model_element && canvas_is_element_hidden(data, model_element_handle(element->model_element))) {
+      continue;
+    }
 
-  // Draw visible elements
-  for (GList *l = visible_elements; l != NULL; l = l->next) {
-    Element *element = (Element*)l->data;
+    // Static elements were painted by the tile cache; only dynamic ones are drawn live
+    if (tiles_drawn && !canvas_element_is_dynamic(data, element)) {
+      draw_hidden_children_indicator(data, cr, element);
+      continue;
+    }
 
     // Check for DSL animation overrides
     double anim_x, anim_y, anim_w, anim_h;
@@ -622,11 +791,12 @@ void canvas_on_draw(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int he
     bool has_rotation_anim = false;
 
     if (data->anim_engine && element->model_element && element->model_element->uuid) {
-      has_position_anim = animation_engine_get_position(data->anim_engine, element->model_element->uuid, &anim_x, &anim_y);
-      has_size_anim = animation_engine_get_size(data->anim_engine, element->model_element->uuid, &anim_w, &anim_h);
-      has_color_anim = animation_engine_get_color(data->anim_engine, element->model_element->uuid, &anim_r, &anim_g, &anim_b, &anim_a);
-      has_visibility_anim = animation_engine_get_visibility(data->anim_engine, element->model_element->uuid, &anim_alpha);
-      has_rotation_anim = animation_engine_get_rotation(data->anim_engine, element->model_element->uuid, &anim_rotation);
+      UuidHandle handle = model_element_handle(element->model_element);
+      has_position_anim = animation_engine_get_position(data->anim_engine, handle, &anim_x, &anim_y);
+      has_size_anim = animation_engine_get_size(data->anim_engine, handle, &anim_w, &anim_h);
+      has_color_anim = animation_engine_get_color(data->anim_engine, handle, &anim_r, &anim_g, &anim_b, &anim_a);
+      has_visibility_anim = animation_engine_get_visibility(data->anim_engine, handle, &anim_alpha);
+      has_rotation_anim = animation_engine_get_rotation(data->anim_engine, handle, &anim_rotation);
 
       if (has_position_anim) {
         element->x = (int)anim_x;
@@ -676,28 +846,9 @@ void canvas_on_draw(GtkDrawingArea *drawing_area, cairo_t *cr, int width, int he
     element->bg_a = saved_bg_a;
     element->rotation_degrees = saved_rotation;
 
-    // Draw indicator if element has hidden children
-    // OPTIMIZATION: Use cached reverse pointer instead of O(n) lookup
-    if (element->model_element && canvas_has_hidden_children(data, element->model_element->uuid)) {
-      // Draw a small triangle indicator in the bottom-right corner
-      double indicator_size = 8.0;
-      double x = (element->x + element->width - indicator_size - 3) * data->zoom_scale + data->offset_x * data->zoom_scale;
-      double y = (element->y + element->height - indicator_size - 3) * data->zoom_scale + data->offset_y * data->zoom_scale;
-
-      cairo_save(cr);
-      cairo_set_source_rgba(cr, 1.0, 0.5, 0.0, 0.8); // Orange color
-      cairo_move_to(cr, x, y + indicator_size);
-      cairo_line_to(cr, x + indicator_size, y + indicator_size);
-      cairo_line_to(cr, x + indicator_size / 2, y);
-      cairo_close_path(cr);
-      cairo_fill(cr);
-      cairo_restore(cr);
-    }
+    draw_hidden_children_indicator(data, cr, element);
   }
 
-  g_list_free(visible_elements);
-  g_list_free(visual_elements);
-
   // Draw current drawing in progress
   if (data->current_drawing) {
     element_draw((Element*)data->current_drawing, cr, FALSE);
@@ -776,6 +927,8 @@ gboolean canvas_is_element_selected(CanvasData *data, Element *element) {
 }
 
 void canvas_on_app_shutdown(GApplication *app, gpointer user_data) {
+  media_note_decode_shutdown();
+
   CanvasData *data = g_object_get_data(G_OBJECT(app), "canvas_data");
   if (data) {
     // Save the model before freeing
@@ -871,30 +1024,8 @@ Element* create_visual_element(ModelElement *model_element, CanvasData *data) {
   case ELEMENT_CONNECTION:
     if (model_element->from_element_uuid && model_element->to_element_uuid) {
       // Find the visual elements for the from and to elements
-      Element *from_element = NULL;
-      Element *to_element = NULL;
-
-      // Search through all model elements to find the visual elements
-      GHashTableIter iter;
-      gpointer key, value;
-      g_hash_table_iter_init(&iter, data->model->elements);
-
-      while (g_hash_table_iter_next(&iter, &key, &value)) {
-        ModelElement *current = (ModelElement*)value;
-        if (current->visual_element) {
-          if (g_strcmp0(current->uuid, model_element->from_element_uuid) == 0) {
-            from_element = current->visual_element;
-          }
-          if (g_strcmp0(current->uuid, model_element->to_element_uuid) == 0) {
-            to_element = current->visual_element;
-          }
-
-          // If we found both, break early
-          if (from_element && to_element) {
-            break;
-          }
-        }
-      }
+      Element *from_element = canvas_lookup_visual(data, model_connection_from(model_element));
+      Element *to_element = canvas_lookup_visual(data, model_connection_to(model_element));
 
       if (from_element && to_element) {
         ElementConnection connection_config = {
@@ -1093,39 +1224,52 @@ Element* create_visual_element(ModelElement *model_element, CanvasData *data) {
 
     // OPTIMIZATION: Set reverse pointer from visual to model element
     visual_element->model_element = model_element;
+    element_invalidate(visual_element);
 
-    // Add to quadtree immediately after creation, unless we're in the middle of
-    // loading a space (in which case canvas_rebuild_quadtree will be called)
-    if (data && data->quadtree && !data->is_loading_space) {
-      quadtree_insert(data->quadtree, visual_element);
+    if (data && data->display_list && data->model &&
+        g_strcmp0(model_element->space_uuid, data->model->current_space_uuid) == 0) {
+      display_list_insert(data->display_list, visual_element);
+    }
+
+    // Add to the spatial index immediately after creation, unless we're in the
+    // middle of loading a space (which bulk-loads the index once at the end)
+    if (data && data->spatial_index && !data->is_loading_space) {
+      spatial_index_update(data->spatial_index, visual_element);
     }
   }
 
   return visual_element;
 }
 
+void canvas_free_visual_element(CanvasData *data, Element *element) {
+  if (!element) return;
+
+  if (data) {
+    data->selected_elements = g_list_remove(data->selected_elements, element);
+    display_list_remove(data->display_list, element);
+    spatial_index_remove(data->spatial_index, element);
+  }
+  element_free(element);
+}
+
 GList* canvas_get_visual_elements(CanvasData *data) {
   if (!data || !data->model || !data->model->elements) {
     return NULL;
   }
 
   GList *visual_elements = NULL;
-  GHashTableIter iter;
-  gpointer key, value;
+  GPtrArray *space_elements = g_ptr_array_new();
+  model_collect_space_elements(data->model, data->model->current_space_uuid,
+                               MODEL_TYPE_MASK_ALL, space_elements);
 
-  g_hash_table_iter_init(&iter, data->model->elements);
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *model_element = (ModelElement*)value;
-
-    if (model_element->state == MODEL_STATE_DELETED) continue;
-
-    // Only include elements that belong to the current space
-    if (model_element->visual_element != NULL &&
-        g_strcmp0(model_element->space_uuid, data->model->current_space_uuid) == 0) {
+  for (guint i = 0; i < space_elements->len; i++) {
+    ModelElement *model_element = g_ptr_array_index(space_elements, i);
+    if (model_element->visual_element != NULL) {
       // Use prepend (O(1)) instead of append (O(n)) for massive performance gain
       visual_elements = g_list_prepend(visual_elements, model_element->visual_element);
     }
   }
+  g_ptr_array_free(space_elements, TRUE);
 
   // Note: Order doesn't matter here as we sort by z-index later in draw function
   return visual_elements;
@@ -1184,21 +1328,63 @@ static gboolean update_element_animations(gpointer user_data) {
   return G_SOURCE_CONTINUE;
 }
 
-void canvas_rebuild_quadtree(CanvasData *canvas_data) {
-  if (!canvas_data || !canvas_data->quadtree) return;
+void canvas_rebuild_spatial_index(CanvasData *canvas_data) {
+  if (!canvas_data || !canvas_data->spatial_index) return;
 
-  quadtree_clear(canvas_data->quadtree);
   GList *visual_elements = canvas_get_visual_elements(canvas_data);
+  GPtrArray *elements = g_ptr_array_sized_new(g_list_length(visual_elements));
   for (GList *l = visual_elements; l != NULL; l = l->next) {
     Element *element = (Element*)l->data;
 
-    // Update connection bounds before inserting into quadtree
+    // Update connection bounds before indexing
     if (element->type == ELEMENT_CONNECTION) {
       connection_update_bounds(element);
     }
 
-    quadtree_insert(canvas_data->quadtree, element);
+    g_ptr_array_add(elements, element);
   }
+  g_list_free(visual_elements);
+
+  spatial_index_bulk_load(canvas_data->spatial_index, (Element**)elements->pdata, elements->len);
+  g_ptr_array_free(elements, TRUE);
+}
+
+static void canvas_reindex_visual(CanvasData *canvas_data, Element *element) {
+  // Connection bounds follow their endpoints
+  if (element->type == ELEMENT_CONNECTION) {
+    connection_update_bounds(element);
+  }
+  spatial_index_update(canvas_data->spatial_index, element);
+}
+
+// Re-index the visuals of the given model elements and of the connections
+// attached to them. Elements whose bounds are unchanged cost a hash lookup;
+// removed visuals already left the index in canvas_free_visual_element.
+void canvas_update_spatial_index(CanvasData *canvas_data, GList *changed_elements) {
+  if (!canvas_data || !canvas_data->spatial_index || !canvas_data->model) {
+    return;
+  }
+
+  GPtrArray *connections = g_ptr_array_new();
+  for (GList *l = changed_elements; l != NULL; l = l->next) {
+    ModelElement *model_element = (ModelElement*)l->data;
+    Element *element = model_element->visual_element;
+    if (!element || model_element->state == MODEL_STATE_DELETED ||
+        g_strcmp0(model_element->space_uuid, canvas_data->model->current_space_uuid) != 0) {
+      continue;
+    }
+    canvas_reindex_visual(canvas_data, element);
+
+    g_ptr_array_set_size(connections, 0);
+    model_collect_element_connections(canvas_data->model, model_element, connections);
+    for (guint i = 0; i < connections->len; i++) {
+      ModelElement *connection = g_ptr_array_index(connections, i);
+      if (connection->visual_element && connection->state != MODEL_STATE_DELETED) {
+        canvas_reindex_visual(canvas_data, connection->visual_element);
+      }
+    }
+  }
+  g_ptr_array_free(connections, TRUE);
 }
 
 void canvas_sync_with_model(CanvasData *canvas_data) {
@@ -1206,12 +1392,18 @@ void canvas_sync_with_model(CanvasData *canvas_data) {
     return;
   }
 
-  GList *sorted_elements = sort_model_elements_for_serialization(canvas_data->model->elements);
-  create_or_update_visual_elements(sorted_elements, canvas_data);
-  g_list_free(sorted_elements);
+  // Only elements queued since the last sync, unless the space was reloaded
+  gboolean reloaded = FALSE;
+  GList *changed_elements = model_take_changed(canvas_data->model, &reloaded);
+  create_or_update_visual_elements(changed_elements, canvas_data);
 
-  // Rebuild quadtree with all visual elements
-  canvas_rebuild_quadtree(canvas_data);
+  // A freshly loaded space is packed in one go; later syncs apply only what changed
+  if (reloaded || canvas_data->is_loading_space) {
+    canvas_rebuild_spatial_index(canvas_data);
+  } else {
+    canvas_update_spatial_index(canvas_data, changed_elements);
+  }
+  g_list_free(changed_elements);
 
   // Start animation timer if elements were loaded and we're not already animating
   if (g_hash_table_size(canvas_data->model->elements) > 0 && canvas_data->animation_timer_id == 0) {
@@ -1248,14 +1440,14 @@ void canvas_hide_children(CanvasData *data, const char *parent_uuid) {
     ModelElement *element = (ModelElement*)iter->data;
     if (element && element->uuid) {
       // Hide all children elements (parent is already excluded by find_children_bfs)
-      g_hash_table_insert(data->hidden_elements, g_strdup(element->uuid), GINT_TO_POINTER(TRUE));
+      g_hash_table_add(data->hidden_elements, UUID_HANDLE_TO_POINTER(model_element_handle(element)));
     }
   }
   g_list_free(children);
 
   // OPTIMIZATION: Update cache - mark parent as having hidden children
   if (has_children) {
-    g_hash_table_insert(data->hidden_children_cache, g_strdup(parent_uuid), GINT_TO_POINTER(TRUE));
+    g_hash_table_add(data->hidden_children_cache, UUID_HANDLE_TO_POINTER(uuid_intern(parent_uuid)));
   }
 }
 
@@ -1267,25 +1459,25 @@ void canvas_show_children(CanvasData *data, const char *parent_uuid) {
     ModelElement *element = (ModelElement*)iter->data;
     if (element && element->uuid) {
       // Show all children elements (parent is already excluded by find_children_bfs)
-      g_hash_table_remove(data->hidden_elements, element->uuid);
+      g_hash_table_remove(data->hidden_elements, UUID_HANDLE_TO_POINTER(model_element_handle(element)));
     }
   }
   g_list_free(children);
 
   // OPTIMIZATION: Update cache - remove parent from having hidden children
-  g_hash_table_remove(data->hidden_children_cache, parent_uuid);
+  g_hash_table_remove(data->hidden_children_cache, UUID_HANDLE_TO_POINTER(uuid_intern_lookup(parent_uuid)));
 }
 
-gboolean canvas_is_element_hidden(CanvasData *data, const char *element_uuid) {
-  if (!data || !element_uuid || !data->hidden_elements) return FALSE;
-  return g_hash_table_contains(data->hidden_elements, element_uuid);
+gboolean canvas_is_element_hidden(CanvasData *data, UuidHandle element) {
+  if (!data || element == UUID_HANDLE_NONE || !data->hidden_elements) return FALSE;
+  return g_hash_table_contains(data->hidden_elements, UUID_HANDLE_TO_POINTER(element));
 }
 
-gboolean canvas_has_hidden_children(CanvasData *data, const char *parent_uuid) {
-  if (!data || !parent_uuid || !data->hidden_children_cache) return FALSE;
+gboolean canvas_has_hidden_children(CanvasData *data, UuidHandle parent) {
+  if (!data || parent == UUID_HANDLE_NONE || !data->hidden_children_cache) return FALSE;
 
   // OPTIMIZATION: Use cached result instead of expensive BFS search
-  return g_hash_table_contains(data->hidden_children_cache, parent_uuid);
+  return g_hash_table_contains(data->hidden_children_cache, UUID_HANDLE_TO_POINTER(parent));
 }
 
 void canvas_toggle_space_name_visibility(GtkToggleButton *button, gpointer user_data) {
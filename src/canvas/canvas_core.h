@@ -14,14 +14,17 @@ void canvas_on_app_shutdown(GApplication *app, gpointer user_data);
 // Expects connections to be last in elements array
 Element* create_visual_element(ModelElement *model_element, CanvasData *canvas_data);
 GList *canvas_get_visual_elements(CanvasData *data);
-// Recreates all visual elements from the model, sorted for proper serialization
-//
-// This function sorts the model elements (with connections last) and creates
-// visual elements from the sorted list. Useful for refreshing the canvas display.
+// Drop a visual element from the canvas indexes and selection, then free it
+void canvas_free_visual_element(CanvasData *data, Element *element);
+// Creates or updates the visual elements of model elements changed since the
+// last sync (model_take_changed), connections after their endpoints, and
+// re-indexes only those. After a space load every element is rebuilt.
 void canvas_sync_with_model(CanvasData *canvas_data);
 
-// Rebuild the spatial index (quadtree) with current visual elements
-void canvas_rebuild_quadtree(CanvasData *canvas_data);
+// Rebuild the spatial index with current visual elements in one bulk load
+void canvas_rebuild_spatial_index(CanvasData *canvas_data);
+// Re-index the visuals of these ModelElements and of their connections
+void canvas_update_spatial_index(CanvasData *canvas_data, GList *changed_elements);
 
 void canvas_screen_to_canvas(CanvasData *data, int screen_x, int screen_y,
                              int *canvas_x, int *canvas_y);
@@ -32,8 +35,8 @@ void canvas_update_zoom_entry(CanvasData *data);
 // Hide/show children functionality
 void canvas_hide_children(CanvasData *data, const char *parent_uuid);
 void canvas_show_children(CanvasData *data, const char *parent_uuid);
-gboolean canvas_is_element_hidden(CanvasData *data, const char *element_uuid);
-gboolean canvas_has_hidden_children(CanvasData *data, const char *parent_uuid);
+gboolean canvas_is_element_hidden(CanvasData *data, UuidHandle element);
+gboolean canvas_has_hidden_children(CanvasData *data, UuidHandle parent);
 
 // Space name visibility toggle
 void canvas_toggle_space_name_visibility(GtkToggleButton *button, gpointer user_data);
@@ -279,91 +279,105 @@ void canvas_on_leave(GtkEventControllerMotion *controller, gpointer user_data) {
   ui_event_bus_emit(&ui_event);
 }
 
-static Element* canvas_pick_element_internal(CanvasData *data, int x, int y, gboolean include_locked) {
-  Element *selected_element = NULL;
-  int highest_z_index = -1;
-
-  // Use quadtree to query only nearby elements
-  GList *candidates = NULL;
-  if (data->quadtree) {
-    candidates = quadtree_query_point(data->quadtree, x, y);
-  } else {
-    // Fallback to full scan if quadtree not available
-    candidates = canvas_get_visual_elements(data);
-  }
-
-  for (GList *l = candidates; l != NULL; l = l->next) {
-    Element *element = (Element*)l->data;
-
-    // Skip hidden elements, and optionally skip locked elements
-    ModelElement *model_element = model_get_by_visual(data->model, element);
-    if (model_element) {
-      if (canvas_is_element_hidden(data, model_element->uuid)) {
-        continue;
-      }
-      if (!include_locked && model_element->locked) {
-        continue;
-      }
+typedef struct {
+  CanvasData *data;
+  int x, y;
+  gboolean include_locked;
+  Element *selected;
+  int highest_z_index;
+} CanvasPick;
+
+// Precise hit test for one candidate; keeps the topmost element hit
+static gboolean canvas_pick_visit(Element *element, gpointer user_data) {
+  CanvasPick *pick = (CanvasPick*)user_data;
+
+  // Skip hidden elements, and optionally skip locked elements
+  ModelElement *model_element = model_get_by_visual(pick->data->model, element);
+  if (model_element) {
+    if (canvas_is_element_hidden(pick->data, model_element_handle(model_element))) {
+      return TRUE;
     }
-
-    double rotated_x = x;
-    double rotated_y = y;
-    if (element->rotation_degrees != 0.0) {
-        double center_x = element->x + element->width / 2.0;
-        double center_y = element->y + element->height / 2.0;
-        double dx = x - center_x;
-        double dy = y - center_y;
-        double angle_rad = -element->rotation_degrees * M_PI / 180.0;
-        rotated_x = center_x + dx * cos(angle_rad) - dy * sin(angle_rad);
-        rotated_y = center_y + dx * sin(angle_rad) + dy * cos(angle_rad);
+    if (!pick->include_locked && model_element->locked) {
+      return TRUE;
     }
+  }
 
-    gboolean inside = FALSE;
-
-    if (element->type == ELEMENT_CONNECTION) {
-      // For connections/arrows, use precise line-based hit detection instead of bounding box
-      inside = connection_contains_point(element, x, y, 8.0);  // 8 pixel threshold
-    } else if (element->type == ELEMENT_SHAPE) {
-      // Check if it's a line-based shape
-      if (shape_is_line_based(element)) {
-        // For line-based shapes, ONLY use precise hit detection (no bounding box fallback)
-        inside = shape_contains_point(element, x, y, 8.0);
-      } else {
-        // For other shapes (circle, rectangle, etc.), use normal bounding box check
-        if (rotated_x >= element->x && rotated_x <= element->x + element->width &&
-            rotated_y >= element->y && rotated_y <= element->y + element->height) {
-          inside = TRUE;
-        }
-      }
-    } else if (element->type == ELEMENT_MEDIA_FILE) {
-      MediaNote *media_note = (MediaNote*)element;
-      int bounds_x, bounds_y, bounds_w, bounds_h;
-      media_note_get_visible_bounds(media_note, &bounds_x, &bounds_y, &bounds_w, &bounds_h);
-      if (rotated_x >= bounds_x && rotated_x <= bounds_x + bounds_w &&
-          rotated_y >= bounds_y && rotated_y <= bounds_y + bounds_h) {
+  double rotated_x = pick->x;
+  double rotated_y = pick->y;
+  if (element->rotation_degrees != 0.0) {
+    double center_x = element->x + element->width / 2.0;
+    double center_y = element->y + element->height / 2.0;
+    double dx = pick->x - center_x;
+    double dy = pick->y - center_y;
+    double angle_rad = -element->rotation_degrees * M_PI / 180.0;
+    rotated_x = center_x + dx * cos(angle_rad) - dy * sin(angle_rad);
+    rotated_y = center_y + dx * sin(angle_rad) + dy * cos(angle_rad);
+  }
+
+  gboolean inside = FALSE;
+
+  if (element->type == ELEMENT_CONNECTION) {
+    // For connections/arrows, use precise line-based hit detection instead of bounding box
+    inside = connection_contains_point(element, pick->x, pick->y, 8.0);  // 8 pixel threshold
+  } else if (element->type == ELEMENT_SHAPE) {
+    // Check if it's a line-based shape
+    if (shape_is_line_based(element)) {
+      // For line-based shapes, ONLY use precise hit detection (no bounding box fallback)
+      inside = shape_contains_point(element, pick->x, pick->y, 8.0);
+    } else {
+      // For other shapes (circle, rectangle, etc.), use normal bounding box check
+      if (rotated_x >= element->x && rotated_x <= element->x + element->width &&
+          rotated_y >= element->y && rotated_y <= element->y + element->height) {
         inside = TRUE;
       }
-    } else if (rotated_x >= element->x && rotated_x <= element->x + element->width &&
-               rotated_y >= element->y && rotated_y <= element->y + element->height) {
+    }
+  } else if (element->type == ELEMENT_MEDIA_FILE) {
+    MediaNote *media_note = (MediaNote*)element;
+    int bounds_x, bounds_y, bounds_w, bounds_h;
+    media_note_get_visible_bounds(media_note, &bounds_x, &bounds_y, &bounds_w, &bounds_h);
+    if (rotated_x >= bounds_x && rotated_x <= bounds_x + bounds_w &&
+        rotated_y >= bounds_y && rotated_y <= bounds_y + bounds_h) {
       inside = TRUE;
     }
+  } else if (rotated_x >= element->x && rotated_x <= element->x + element->width &&
+             rotated_y >= element->y && rotated_y <= element->y + element->height) {
+    inside = TRUE;
+  }
 
-    if (!inside) {
-      continue;
-    }
+  if (!inside) {
+    return TRUE;
+  }
 
-    if (element->z > highest_z_index) {
-      selected_element = element;
-      highest_z_index = element->z;
-    }
+  if (element->z > pick->highest_z_index) {
+    pick->selected = element;
+    pick->highest_z_index = element->z;
   }
+  return TRUE;
+}
 
-  // Free the candidate list from quadtree query
-  if (data->quadtree && candidates) {
+static Element* canvas_pick_element_internal(CanvasData *data, int x, int y, gboolean include_locked) {
+  CanvasPick pick = {
+    .data = data,
+    .x = x,
+    .y = y,
+    .include_locked = include_locked,
+    .selected = NULL,
+    .highest_z_index = -1,
+  };
+
+  // Use the spatial index to visit only nearby elements, without building a list
+  if (data->spatial_index) {
+    spatial_index_visit_point(data->spatial_index, x, y, canvas_pick_visit, &pick);
+  } else {
+    // Fallback to full scan if the index is not available
+    GList *candidates = canvas_get_visual_elements(data);
+    for (GList *l = candidates; l != NULL; l = l->next) {
+      canvas_pick_visit((Element*)l->data, &pick);
+    }
     g_list_free(candidates);
   }
 
-  return selected_element;
+  return pick.selected;
 }
 
 // Helper function to pick any element (including locked ones) - used for right-click
@@ -743,8 +757,7 @@ void canvas_on_paste(GtkWidget *widget, CanvasData *data) {
       if (element->from_element_uuid) {
         char *new_from_uuid = g_hash_table_lookup(uuid_map, element->from_element_uuid);
         if (new_from_uuid) {
-          g_free(element->from_element_uuid);
-          element->from_element_uuid = g_strdup(new_from_uuid);
+          model_element_set_string(element, &element->from_element_uuid, new_from_uuid);
           updated = TRUE;
         }
       }
@@ -753,15 +766,15 @@ void canvas_on_paste(GtkWidget *widget, CanvasData *data) {
       if (element->to_element_uuid) {
         char *new_to_uuid = g_hash_table_lookup(uuid_map, element->to_element_uuid);
         if (new_to_uuid) {
-          g_free(element->to_element_uuid);
-          element->to_element_uuid = g_strdup(new_to_uuid);
+          model_element_set_string(element, &element->to_element_uuid, new_to_uuid);
           updated = TRUE;
         }
       }
 
       // Mark for saving if updated
       if (updated) {
-        element->state = MODEL_STATE_UPDATED;
+        model_mark_updated(data->model, element, MODEL_FIELD_CONNECTION);
+        model_index_connection(data->model, element);
       }
     }
 
@@ -36,7 +36,7 @@ static void on_clone_action(GSimpleAction *action, GVariant *parameter, gpointer
 
   if (data && data->model && element_uuid) {
     model_save_elements(data->model);
-    ModelElement *original = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *original = model_lookup_element(data->model, element_uuid);
     if (original) {
       clone_dialog_open(data, original);
     }
@@ -64,12 +64,9 @@ static void on_description_dialog_response(GtkDialog *dialog, gint response_id,
       gtk_text_buffer_get_bounds(buffer, &start, &end);
       gchar *new_description = gtk_text_buffer_get_text(buffer, &start, &end, FALSE);
 
-      g_free(model_element->description);
-      model_element->description = g_strdup(new_description);
+      model_element_set_string(model_element, &model_element->description, new_description);
 
-      if (model_element->state != MODEL_STATE_NEW) {
-        model_element->state = MODEL_STATE_UPDATED;
-      }
+      model_mark_updated(data->model, model_element, MODEL_FIELD_DESCRIPTION);
 
       g_free(new_description);
     }
@@ -83,7 +80,7 @@ static void on_description_action(GSimpleAction *action, GVariant *parameter, gp
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element) {
       GtkWidget *dialog = gtk_dialog_new_with_buttons("Element Description",
                                                       GTK_WINDOW(gtk_widget_get_root(data->drawing_area)),
@@ -139,7 +136,7 @@ static void on_lock_unlock_element_action(GSimpleAction *action, GVariant *param
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element) {
       gboolean new_locked_state = !model_element->locked;
       model_update_locked(data->model, model_element, new_locked_state);
@@ -154,7 +151,7 @@ static void on_delete_element_action(GSimpleAction *action, GVariant *parameter,
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element) {
       if (model_element->type->type == ELEMENT_SPACE) {
         if (model_element->state != MODEL_STATE_NEW) {
@@ -189,7 +186,7 @@ static void on_color_dialog_response(GtkDialog *dialog, int response_id, gpointe
     gtk_color_chooser_get_rgba(chooser, &color);
 
     if (data && data->model && element_uuid) {
-      ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+      ModelElement *model_element = model_lookup_element(data->model, element_uuid);
       if (model_element && model_element->bg_color) {
         double old_r = model_element->bg_color->r;
         double old_g = model_element->bg_color->g;
@@ -230,7 +227,7 @@ static void on_thumbnail_dialog_response(GtkNativeDialog *native, int response,
           gsize thumbnail_size = 0;
           if (gdk_pixbuf_save_to_buffer(pixbuf, &thumbnail_buffer, &thumbnail_size, "png", NULL, NULL)) {
             // Update the model element's thumbnail
-            ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+            ModelElement *model_element = model_lookup_element(data->model, element_uuid);
             if (model_element) {
               // Update based on media type
               if (model_element->video) {
@@ -259,7 +256,7 @@ static void on_thumbnail_dialog_response(GtkNativeDialog *native, int response,
 
               // Recreate visual element
               if (model_element->visual_element) {
-                model_element->visual_element->vtable->free(model_element->visual_element);
+                canvas_free_visual_element(data, model_element->visual_element);
               }
               model_element->visual_element = create_visual_element(model_element, data);
 
@@ -315,7 +312,7 @@ static void on_change_color_action(GSimpleAction *action, GVariant *parameter, g
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element) {
       GtkWidget *dialog = gtk_color_chooser_dialog_new("Choose Element Color",
                                                        GTK_WINDOW(gtk_widget_get_root(data->drawing_area)));
@@ -355,7 +352,7 @@ static void on_change_text_action(GSimpleAction *action, GVariant *parameter, gp
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (!model_element || !model_element->visual_element) {
       return;
     }
@@ -453,13 +450,12 @@ static void on_shape_style_dialog_response(GtkDialog *dialog, gint response_id,
       shape->stroke_style = new_stroke_style;
       shape->fill_style = new_fill_style;
       shape->filled = new_filled;
+      element_invalidate((Element*)shape);
 
       model_element->stroke_style = new_stroke_style;
       model_element->fill_style = new_fill_style;
       model_element->filled = new_filled;
-      if (model_element->state != MODEL_STATE_NEW) {
-        model_element->state = MODEL_STATE_UPDATED;
-      }
+      model_mark_updated(data->model, model_element, MODEL_FIELD_SHAPE);
 
       gtk_widget_queue_draw(data->drawing_area);
     }
@@ -474,7 +470,7 @@ static void on_change_shape_style_action(GSimpleAction *action, GVariant *parame
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element && model_element->visual_element && model_element->type->type == ELEMENT_SHAPE) {
       Shape *shape = (Shape*)model_element->visual_element;
 
@@ -531,7 +527,7 @@ static void on_stroke_color_dialog_response(GtkDialog *dialog, gint response_id,
     CanvasData *data = g_object_get_data(G_OBJECT(dialog), "canvas_data");
     const gchar *element_uuid = g_object_get_data(G_OBJECT(dialog), "element_uuid");
     if (data && data->model && element_uuid) {
-      ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+      ModelElement *model_element = model_lookup_element(data->model, element_uuid);
       if (model_element && model_element->visual_element && model_element->type->type == ELEMENT_SHAPE) {
         Shape *shape = (Shape*)model_element->visual_element;
         GtkColorChooser *chooser = GTK_COLOR_CHOOSER(dialog);
@@ -542,19 +538,17 @@ static void on_stroke_color_dialog_response(GtkDialog *dialog, gint response_id,
         shape->stroke_g = color.green;
         shape->stroke_b = color.blue;
         shape->stroke_a = color.alpha;
+        element_invalidate((Element*)shape);
 
-        if (model_element->stroke_color) {
-          g_free(model_element->stroke_color);
-        }
-        model_element->stroke_color = g_strdup_printf("#%02X%02X%02X%02X",
+        gchar *stroke_color = g_strdup_printf("#%02X%02X%02X%02X",
           (int)CLAMP(color.red * 255.0, 0, 255),
           (int)CLAMP(color.green * 255.0, 0, 255),
           (int)CLAMP(color.blue * 255.0, 0, 255),
           (int)CLAMP(color.alpha * 255.0, 0, 255));
+        model_element_set_string(model_element, &model_element->stroke_color, stroke_color);
+        g_free(stroke_color);
 
-        if (model_element->state != MODEL_STATE_NEW) {
-          model_element->state = MODEL_STATE_UPDATED;
-        }
+        model_mark_updated(data->model, model_element, MODEL_FIELD_SHAPE);
 
         gtk_widget_queue_draw(data->drawing_area);
       }
@@ -569,7 +563,7 @@ static void on_change_shape_stroke_color_action(GSimpleAction *action, GVariant
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element && model_element->visual_element && model_element->type->type == ELEMENT_SHAPE) {
       Shape *shape = (Shape*)model_element->visual_element;
 
@@ -599,16 +593,14 @@ static void on_change_arrow_type_action(GSimpleAction *action, GVariant *paramet
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element && model_element->visual_element && model_element->type->type == ELEMENT_CONNECTION) {
       Connection *conn = (Connection*)model_element->visual_element;
       conn->connection_type = (conn->connection_type + 1) % 2;
       model_element->connection_type = conn->connection_type;
       gtk_widget_queue_draw(data->drawing_area);
 
-      if (model_element->state != MODEL_STATE_NEW) {
-        model_element->state = MODEL_STATE_UPDATED;
-      }
+      model_mark_updated(data->model, model_element, MODEL_FIELD_CONNECTION);
     }
   }
 }
@@ -618,7 +610,7 @@ static void on_change_arrowhead_type_action(GSimpleAction *action, GVariant *par
   const gchar *element_uuid = g_object_get_data(G_OBJECT(action), "element_uuid");
 
   if (data && data->model && element_uuid) {
-    ModelElement *model_element = g_hash_table_lookup(data->model->elements, element_uuid);
+    ModelElement *model_element = model_lookup_element(data->model, element_uuid);
     if (model_element && model_element->visual_element && model_element->type->type == ELEMENT_CONNECTION) {
       Connection *conn = (Connection*)model_element->visual_element;
       conn->arrowhead_type = (conn->arrowhead_type + 1) % 3;
@@ -627,32 +619,34 @@ static void on_change_arrowhead_type_action(GSimpleAction *action, GVariant *par
 
       gtk_widget_queue_draw(data->drawing_area);
 
-      if (model_element->state != MODEL_STATE_NEW) {
-        model_element->state = MODEL_STATE_UPDATED;
-      }
+      model_mark_updated(data->model, model_element, MODEL_FIELD_CONNECTION);
     }
   }
 }
 
+// Called while the selection is dragged, resized or rotated. Connections are
+// found through the adjacency index rather than a scan of every element, and
+// the moved elements are re-indexed with them so culling and picking follow
+// the pointer instead of waiting for the release.
 static void canvas_update_connections_for_selection(CanvasData *data) {
   if (!data || !data->model || !data->selected_elements) {
     return;
   }
 
-  GHashTable *elements = data->model->elements;
-  if (!elements) return;
-
-  GHashTableIter iter;
-  gpointer key, value;
-
-  g_hash_table_iter_init(&iter, elements);
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *model_element = (ModelElement*)value;
-    if (!model_element || model_element->state == MODEL_STATE_DELETED) {
-      continue;
-    }
+  GList *moved = NULL;
+  GPtrArray *connections = g_ptr_array_new();
+  for (GList *l = data->selected_elements; l != NULL; l = l->next) {
+    ModelElement *endpoint = model_get_by_visual(data->model, (Element*)l->data);
+    if (!endpoint) continue;
+    moved = g_list_prepend(moved, endpoint);
+    model_collect_element_connections(data->model, endpoint, connections);
+  }
 
-    if (!model_element->type || model_element->type->type != ELEMENT_CONNECTION) {
+  // A connection between two selected elements is reached from both ends
+  GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+  for (guint i = 0; i < connections->len; i++) {
+    ModelElement *model_element = g_ptr_array_index(connections, i);
+    if (!g_hash_table_add(seen, model_element) || model_element->state == MODEL_STATE_DELETED) {
       continue;
     }
 
@@ -661,13 +655,6 @@ static void canvas_update_connections_for_selection(CanvasData *data) {
       continue;
     }
 
-    gboolean affects_from = g_list_find(data->selected_elements, connection->from) != NULL;
-    gboolean affects_to = g_list_find(data->selected_elements, connection->to) != NULL;
-
-    if (!affects_from && !affects_to) {
-      continue;
-    }
-
     int new_from_point = connection->from_point;
     int new_to_point = connection->to_point;
 
@@ -692,11 +679,14 @@ static void canvas_update_connections_for_selection(CanvasData *data) {
 
       model_element->from_point = new_from_point;
       model_element->to_point = new_to_point;
-      if (model_element->state != MODEL_STATE_NEW) {
-        model_element->state = MODEL_STATE_UPDATED;
-      }
+      model_mark_updated(data->model, model_element, MODEL_FIELD_CONNECTION);
     }
   }
+  g_hash_table_destroy(seen);
+  g_ptr_array_free(connections, TRUE);
+
+  canvas_update_spatial_index(data, moved);
+  g_list_free(moved);
 }
 
 static void canvas_process_left_click(CanvasData *data, int n_press, double x, double y) {
@@ -1230,6 +1220,7 @@ static void canvas_process_motion(CanvasData *data, double x, double y) {
   }
 
   if (data->selected_elements) {
+    gboolean rotated = FALSE;
     for (GList *l = data->selected_elements; l != NULL; l = l->next) {
       Element *element = (Element*)l->data;
 
@@ -1242,6 +1233,7 @@ static void canvas_process_motion(CanvasData *data, double x, double y) {
         while (angle >= 360.0) angle -= 360.0;
 
         element->rotation_degrees = angle;
+        rotated = TRUE;
 
         gtk_widget_queue_draw(data->drawing_area);
         continue;
@@ -1305,6 +1297,7 @@ static void canvas_process_motion(CanvasData *data, double x, double y) {
         element->width = new_width;
         element->height = new_height;
 
+        canvas_update_connections_for_selection(data);
         gtk_widget_queue_draw(data->drawing_area);
         return;
       }
@@ -1365,6 +1358,11 @@ static void canvas_process_motion(CanvasData *data, double x, double y) {
         return;
       }
     }
+
+    // Rotated bounds grow past the unrotated box; keep the index in step
+    if (rotated) {
+      canvas_update_connections_for_selection(data);
+    }
   }
 
   if (data->selecting) {
@@ -1454,7 +1452,7 @@ static void canvas_process_left_release(CanvasData *data, int n_press, double x,
       g_array_free(line_points, TRUE);
     }
 
-    shape_free((Element*)data->current_shape);
+    element_free((Element*)data->current_shape);
     data->current_shape = NULL;
     data->shape_mode = FALSE;
     gtk_widget_queue_draw(data->drawing_area);
@@ -1630,17 +1628,13 @@ static void canvas_process_left_release(CanvasData *data, int n_press, double x,
       if (shape->dragging_control_point && (shape->shape_type == SHAPE_BEZIER || shape->shape_type == SHAPE_CURVED_ARROW)) {
         ModelElement *model_element = model_get_by_visual(data->model, element);
         if (model_element && shape->has_bezier_points) {
-          GArray *bezier_points = g_array_sized_new(FALSE, FALSE, sizeof(DrawingPoint), 4);
+          DrawingPoint bezier_points[4];
+          graphene_point_init(&bezier_points[0], (float)shape->bezier_p0_u, (float)shape->bezier_p0_v);
+          graphene_point_init(&bezier_points[1], (float)shape->bezier_p1_u, (float)shape->bezier_p1_v);
+          graphene_point_init(&bezier_points[2], (float)shape->bezier_p2_u, (float)shape->bezier_p2_v);
+          graphene_point_init(&bezier_points[3], (float)shape->bezier_p3_u, (float)shape->bezier_p3_v);
 
-          DrawingPoint p0; graphene_point_init(&p0, (float)shape->bezier_p0_u, (float)shape->bezier_p0_v); g_array_append_val(bezier_points, p0);
-          DrawingPoint p1; graphene_point_init(&p1, (float)shape->bezier_p1_u, (float)shape->bezier_p1_v); g_array_append_val(bezier_points, p1);
-          DrawingPoint p2; graphene_point_init(&p2, (float)shape->bezier_p2_u, (float)shape->bezier_p2_v); g_array_append_val(bezier_points, p2);
-          DrawingPoint p3; graphene_point_init(&p3, (float)shape->bezier_p3_u, (float)shape->bezier_p3_v); g_array_append_val(bezier_points, p3);
-
-          if (model_element->drawing_points) {
-            g_array_free(model_element->drawing_points, TRUE);
-          }
-          model_element->drawing_points = bezier_points;
+          model_update_drawing_points(data->model, model_element, bezier_points, G_N_ELEMENTS(bezier_points));
         }
 
         shape->dragging_control_point = FALSE;
@@ -2121,7 +2115,7 @@ static void canvas_process_key_press(CanvasData *data, guint keyval,
     for (GList *l = elements; l != NULL; l = l->next) {
       Element *element = (Element*)l->data;
       ModelElement *model_element = model_get_by_visual(data->model, element);
-      if (model_element && !canvas_is_element_hidden(data, model_element->uuid)) {
+      if (model_element && !canvas_is_element_hidden(data, model_element_handle(model_element))) {
         data->selected_elements = g_list_append(data->selected_elements, element);
       }
     }
@@ -6,34 +6,13 @@
 #define PLACEMENT_STEP 20
 #define MAX_SEARCH_RADIUS 1000
 
-// Check if a rectangle overlaps with any existing elements
-static gboolean check_overlap(CanvasData *data, int x, int y, int width, int height) {
-  if (!data->model || !data->model->elements) {
-    return FALSE;
-  }
-
+// Check if a rectangle overlaps with any of the given model elements
+static gboolean check_overlap(GPtrArray *elements, int x, int y, int width, int height) {
   // Add some padding around elements
   const int padding = 20;
 
-  // Iterate through hash table of elements
-  GHashTableIter iter;
-  gpointer key, value;
-  g_hash_table_iter_init(&iter, data->model->elements);
-
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *elem = (ModelElement *)value;
-
-    // Skip connections as they don't really occupy space
-    if (elem->type && elem->type->type == ELEMENT_CONNECTION) {
-      continue;
-    }
-
-    // Check if this element is in the current space
-    if (data->model->current_space_uuid) {
-      if (!elem->space_uuid || strcmp(elem->space_uuid, data->model->current_space_uuid) != 0) {
-        continue;
-      }
-    }
+  for (guint i = 0; i < elements->len; i++) {
+    ModelElement *elem = g_ptr_array_index(elements, i);
 
     // Skip elements without position or size
     if (!elem->position || !elem->size) {
@@ -70,13 +49,22 @@ void canvas_find_empty_position(CanvasData *data, int width, int height, int *ou
   int center_x, center_y;
   canvas_screen_to_canvas(data, viewport_center_screen_x, viewport_center_screen_y, &center_x, &center_y);
 
+  // Elements of the current space, skipping connections as they don't really
+  // occupy space; gathered once for the whole search
+  GPtrArray *elements = g_ptr_array_new();
+  if (data->model) {
+    model_collect_space_elements(data->model, data->model->current_space_uuid,
+                                 MODEL_TYPE_MASK_ALL & ~MODEL_TYPE_BIT(ELEMENT_CONNECTION), elements);
+  }
+
   // Try placing at center first
   int candidate_x = center_x - width / 2;
   int candidate_y = center_y - height / 2;
 
-  if (!check_overlap(data, candidate_x, candidate_y, width, height)) {
+  if (!check_overlap(elements, candidate_x, candidate_y, width, height)) {
     *out_x = candidate_x;
     *out_y = candidate_y;
+    g_ptr_array_free(elements, TRUE);
     return;
   }
 
@@ -94,9 +82,10 @@ void canvas_find_empty_position(CanvasData *data, int width, int height, int *ou
       candidate_x = center_x + offset_x - width / 2;
       candidate_y = center_y + offset_y - height / 2;
 
-      if (!check_overlap(data, candidate_x, candidate_y, width, height)) {
+      if (!check_overlap(elements, candidate_x, candidate_y, width, height)) {
         *out_x = candidate_x;
         *out_y = candidate_y;
+        g_ptr_array_free(elements, TRUE);
         return;
       }
     }
@@ -107,4 +96,5 @@ void canvas_find_empty_position(CanvasData *data, int width, int height, int *ou
   // If we couldn't find an empty spot (unlikely), just place at center
   *out_x = center_x - width / 2;
   *out_y = center_y - height / 2;
+  g_ptr_array_free(elements, TRUE);
 }
\ No newline at end of file
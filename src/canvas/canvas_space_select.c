@@ -64,7 +64,7 @@ static void on_space_selected(GtkListBox *list, GtkListBoxRow *row, gpointer use
 
   // Move the element to the selected space
   if (element_uuid) {
-    ModelElement *element = g_hash_table_lookup(select_data->canvas_data->model->elements, element_uuid);
+    ModelElement *element = model_lookup_element(select_data->canvas_data->model, element_uuid);
     if (element) {
       undo_manager_remove_actions_for_element(select_data->canvas_data->undo_manager, element);
       model_save_elements(select_data->canvas_data->model);
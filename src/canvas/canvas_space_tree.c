@@ -49,6 +49,10 @@ static gboolean is_space_on_active_path(SpaceTreeView *tree_view, const char *sp
   return result;
 }
 
+static gint compare_space_elements(gconstpointer a, gconstpointer b) {
+  return model_compare_for_saving_loading(*(ModelElement* const*)a, *(ModelElement* const*)b);
+}
+
 static void load_space_elements(SpaceTreeView *tree_view, GtkTreeIter *parent_iter,
                                const char *space_uuid) {
   if (!tree_view->canvas_data->model) {
@@ -60,31 +64,17 @@ static void load_space_elements(SpaceTreeView *tree_view, GtkTreeIter *parent_it
     return;
   }
 
-  // Get all elements in the current space
-  GHashTableIter iter;
-  gpointer key, value;
-  GList *elements_in_space = NULL;
-
-  g_hash_table_iter_init(&iter, tree_view->canvas_data->model->elements);
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *element = (ModelElement*)value;
-
-    if (element->space_uuid && g_strcmp0(element->space_uuid, space_uuid) == 0) {
-      elements_in_space = g_list_append(elements_in_space, element);
-    }
-  }
+  // Get the elements of this space, except space elements (they're shown in the hierarchy)
+  GPtrArray *elements = g_ptr_array_new();
+  model_collect_space_elements(tree_view->canvas_data->model, space_uuid,
+                               MODEL_TYPE_MASK_ALL & ~MODEL_TYPE_BIT(ELEMENT_SPACE), elements);
 
   // Sort elements by type then by name/UUID for consistent ordering
-  elements_in_space = g_list_sort(elements_in_space, (GCompareFunc)model_compare_for_saving_loading);
+  g_ptr_array_sort(elements, compare_space_elements);
 
   // Add all elements (no pagination)
-  for (GList *l = elements_in_space; l != NULL; l = l->next) {
-    ModelElement *element = (ModelElement*)l->data;
-
-    // Skip space elements (they're shown in the hierarchy)
-    if (element->type && element->type->type == ELEMENT_SPACE) {
-      continue;
-    }
+  for (guint i = 0; i < elements->len; i++) {
+    ModelElement *element = g_ptr_array_index(elements, i);
 
     GtkTreeIter child_iter;
     gtk_tree_store_append(tree_view->tree_store, &child_iter, parent_iter);
@@ -124,7 +114,7 @@ static void load_space_elements(SpaceTreeView *tree_view, GtkTreeIter *parent_it
                       -1);
   }
 
-  g_list_free(elements_in_space);
+  g_ptr_array_free(elements, TRUE);
 }
 
 static gboolean find_current_iter_recursive(SpaceTreeView *tree_view, GtkTreeIter *parent_iter, GtkTreeIter *found_iter) {
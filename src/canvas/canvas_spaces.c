@@ -12,32 +12,32 @@ static void capture_audio_playback_states(CanvasData *data) {
     return;
   }
 
-  GHashTableIter iter;
-  gpointer key, value;
-  g_hash_table_iter_init(&iter, data->model->elements);
-
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *element = (ModelElement*)value;
-    if (!element || !element->uuid || !element->visual_element) {
+  // Only media notes of the shown space have visuals that can be playing
+  GPtrArray *media = g_ptr_array_new();
+  model_collect_space_elements(data->model, data->model->current_space_uuid,
+                               MODEL_TYPE_BIT(ELEMENT_MEDIA_FILE), media);
+
+  for (guint i = 0; i < media->len; i++) {
+    ModelElement *element = g_ptr_array_index(media, i);
+    if (!element->uuid || !element->visual_element) {
       continue;
     }
 
-    if (element->type && element->type->type == ELEMENT_MEDIA_FILE) {
-      MediaNote *media_note = (MediaNote*)element->visual_element;
-      if (media_note && media_note->media_type == MEDIA_TYPE_AUDIO) {
-        if (media_note->media_playing) {
-          AudioPlaybackState *state = g_new0(AudioPlaybackState, 1);
-          state->element = (Element*)media_note;
-          state->playing = TRUE;
-          g_hash_table_replace(data->audio_playback_states,
-                               g_strdup(element->uuid),
-                               state);
-        } else {
-          g_hash_table_remove(data->audio_playback_states, element->uuid);
-        }
+    MediaNote *media_note = (MediaNote*)element->visual_element;
+    if (media_note->media_type == MEDIA_TYPE_AUDIO) {
+      if (media_note->media_playing) {
+        AudioPlaybackState *state = g_new0(AudioPlaybackState, 1);
+        state->element = (Element*)media_note;
+        state->playing = TRUE;
+        g_hash_table_replace(data->audio_playback_states,
+                             g_strdup(element->uuid),
+                             state);
+      } else {
+        g_hash_table_remove(data->audio_playback_states, element->uuid);
       }
     }
   }
+  g_ptr_array_free(media, TRUE);
 }
 
 void switch_to_space(CanvasData *data, const gchar* space_uuid) {
@@ -66,14 +66,16 @@ void switch_to_space(CanvasData *data, const gchar* space_uuid) {
   }
   data->model->current_space_uuid = g_strdup(space_uuid);
 
+  // Drop the render list and spatial index before the model releases the
+  // old space's elements wholesale; nothing may reach them afterwards
+  if (data->display_list) {
+    display_list_clear(data->display_list);
+  }
+  spatial_index_clear(data->spatial_index);
+
   model_load_space_settings(data->model, space_uuid);
   model_load_space(data->model);
 
-  // Clear quadtree when switching spaces since elements are freed
-  if (data->quadtree) {
-    quadtree_clear(data->quadtree);
-  }
-
   // Set flag to enable animations for space loading
   data->is_loading_space = TRUE;
   canvas_sync_with_model(data);
@@ -0,0 +1,297 @@
+#include "canvas_tile_cache.h"
+#include "canvas.h"
+#include "canvas_core.h"
+#include "../animation.h"
+#include "../elements/connection.h"
+#include "../elements/media_note.h"
+#include "../model.h"
+#include "../spatial_index.h"
+#include <math.h>
+#include <string.h>
+
+typedef struct {
+  gint64 key;
+  cairo_surface_t *surface;
+  guint64 signature;
+  guint64 last_used;
+} CanvasTile;
+
+static gint64 tile_key(int tx, int ty) {
+  return ((gint64)tx << 32) | (guint32)ty;
+}
+
+static void canvas_tile_free(gpointer data) {
+  CanvasTile *tile = (CanvasTile*)data;
+  if (tile->surface) cairo_surface_destroy(tile->surface);
+  g_free(tile);
+}
+
+// FNV-1a style mixing, one 64-bit word at a time
+static guint64 signature_mix(guint64 hash, guint64 value) {
+  hash ^= value;
+  hash *= 1099511628211ULL;
+  return hash ^ (hash >> 29);
+}
+
+static guint64 signature_mix_double(guint64 hash, double value) {
+  guint64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return signature_mix(hash, bits);
+}
+
+static guint64 signature_mix_geometry(guint64 hash, Element *element) {
+  hash = signature_mix(hash, (guint32)element->x);
+  hash = signature_mix(hash, (guint32)element->y);
+  hash = signature_mix(hash, (guint32)element->width);
+  return signature_mix(hash, (guint32)element->height);
+}
+
+static guint64 signature_mix_element(guint64 hash, Element *element) {
+  hash = signature_mix(hash, (guint64)(guintptr)element);
+  hash = signature_mix(hash, element->render_generation);
+  hash = signature_mix_geometry(hash, element);
+  hash = signature_mix(hash, (guint32)element->z);
+  hash = signature_mix_double(hash, element->rotation_degrees);
+  hash = signature_mix_double(hash, element->bg_r);
+  hash = signature_mix_double(hash, element->bg_g);
+  hash = signature_mix_double(hash, element->bg_b);
+  hash = signature_mix_double(hash, element->bg_a);
+
+  // A connection's path depends on where its endpoints sit, not just its box
+  if (element->type == ELEMENT_CONNECTION) {
+    Connection *conn = (Connection*)element;
+    // Generations cover anchor changes inside the box, e.g. an image finishing decode
+    if (conn->from) {
+      hash = signature_mix_geometry(hash, conn->from);
+      hash = signature_mix(hash, conn->from->render_generation);
+    }
+    if (conn->to) {
+      hash = signature_mix_geometry(hash, conn->to);
+      hash = signature_mix(hash, conn->to->render_generation);
+    }
+    hash = signature_mix(hash, (guint32)conn->from_point);
+    hash = signature_mix(hash, (guint32)conn->to_point);
+  }
+  return hash;
+}
+
+static gboolean element_is_dynamic_self(CanvasData *data, Element *element) {
+  if (element->dragging || element->resizing || element->rotating || element->animating) {
+    return TRUE;
+  }
+  if (element->type == ELEMENT_MEDIA_FILE && ((MediaNote*)element)->media_playing) {
+    return TRUE;
+  }
+  return canvas_is_element_selected(data, element);
+}
+
+gboolean canvas_element_is_dynamic(CanvasData *data, Element *element) {
+  if (!data || !element) return FALSE;
+
+  if (element_is_dynamic_self(data, element)) {
+    return TRUE;
+  }
+
+  // Connections follow their endpoints while those are dragged or resized
+  if (element->type == ELEMENT_CONNECTION) {
+    Connection *conn = (Connection*)element;
+    return (conn->from && element_is_dynamic_self(data, conn->from)) ||
+           (conn->to && element_is_dynamic_self(data, conn->to));
+  }
+  return FALSE;
+}
+
+static gboolean tile_should_draw(CanvasData *data, Element *element) {
+  ModelElement *model_element = element->model_element;
+  if (!model_element || model_element->state == MODEL_STATE_DELETED) {
+    return FALSE;
+  }
+  if (canvas_is_element_hidden(data, model_element_handle(model_element))) {
+    return FALSE;
+  }
+  return !canvas_element_is_dynamic(data, element);
+}
+
+static gint compare_tile_elements(gconstpointer a, gconstpointer b) {
+  const Element *element_a = *(Element* const*)a;
+  const Element *element_b = *(Element* const*)b;
+  if (element_a->z != element_b->z) {
+    return element_a->z < element_b->z ? -1 : 1;
+  }
+  // Deterministic order for equal z keeps the tile signature stable
+  return (element_a > element_b) - (element_a < element_b);
+}
+
+CanvasTileCache* canvas_tile_cache_new(void) {
+  CanvasTileCache *cache = g_new0(CanvasTileCache, 1);
+  cache->tiles = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, canvas_tile_free);
+  cache->scratch = g_ptr_array_new();
+  cache->scale_factor = 1;
+  cache->enabled = TRUE;
+  return cache;
+}
+
+void canvas_tile_cache_free(CanvasTileCache *cache) {
+  if (!cache) return;
+  g_hash_table_destroy(cache->tiles);
+  g_ptr_array_free(cache->scratch, TRUE);
+  g_free(cache);
+}
+
+void canvas_tile_cache_clear(CanvasTileCache *cache) {
+  if (!cache) return;
+  g_hash_table_remove_all(cache->tiles);
+}
+
+static void canvas_tile_cache_evict(CanvasTileCache *cache) {
+  while (g_hash_table_size(cache->tiles) > CANVAS_TILE_CACHE_MAX_TILES) {
+    CanvasTile *oldest = NULL;
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, cache->tiles);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+      CanvasTile *tile = (CanvasTile*)value;
+      if (!oldest || tile->last_used < oldest->last_used) {
+        oldest = tile;
+      }
+    }
+
+    // Never drop tiles painted this frame, even if the viewport needs more than the cap
+    if (!oldest || oldest->last_used == cache->frame) {
+      break;
+    }
+    g_hash_table_remove(cache->tiles, &oldest->key);
+  }
+}
+
+static void canvas_tile_render(CanvasTile *tile, GPtrArray *elements,
+                               double x, double y, double zoom) {
+  cairo_t *cr = cairo_create(tile->surface);
+
+  cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+  cairo_paint(cr);
+  cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+  cairo_scale(cr, zoom, zoom);
+  cairo_translate(cr, -x, -y);
+  for (guint i = 0; i < elements->len; i++) {
+    element_draw(g_ptr_array_index(elements, i), cr, FALSE);
+  }
+
+  cairo_destroy(cr);
+}
+
+// Returns the up-to-date tile, or NULL if no static element touches it
+static CanvasTile* canvas_tile_cache_get_tile(CanvasTileCache *cache, CanvasData *data,
+                                              int tx, int ty, double extent) {
+  double x = tx * extent;
+  double y = ty * extent;
+  gint64 key = tile_key(tx, ty);
+
+  GPtrArray *elements = cache->scratch;
+  g_ptr_array_set_size(elements, 0);
+  spatial_index_query_rect(data->spatial_index, x, y, extent, extent, elements);
+
+  guint kept = 0;
+  for (guint i = 0; i < elements->len; i++) {
+    Element *element = g_ptr_array_index(elements, i);
+    if (tile_should_draw(data, element)) {
+      g_ptr_array_index(elements, kept++) = element;
+    }
+  }
+  g_ptr_array_set_size(elements, kept);
+
+  if (kept == 0) {
+    g_hash_table_remove(cache->tiles, &key);
+    return NULL;
+  }
+
+  g_ptr_array_sort(elements, compare_tile_elements);
+
+  guint64 signature = 1469598103934665603ULL;
+  for (guint i = 0; i < elements->len; i++) {
+    signature = signature_mix_element(signature, g_ptr_array_index(elements, i));
+  }
+
+  CanvasTile *tile = g_hash_table_lookup(cache->tiles, &key);
+  if (!tile) {
+    int pixels = CANVAS_TILE_SIZE * cache->scale_factor;
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixels, pixels);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+      cairo_surface_destroy(surface);
+      return NULL;
+    }
+    cairo_surface_set_device_scale(surface, cache->scale_factor, cache->scale_factor);
+
+    tile = g_new0(CanvasTile, 1);
+    tile->key = key;
+    tile->surface = surface;
+    g_hash_table_insert(cache->tiles, &tile->key, tile);
+  } else if (tile->signature == signature) {
+    tile->last_used = cache->frame;
+    return tile;
+  }
+
+  canvas_tile_render(tile, elements, x, y, cache->zoom);
+  tile->signature = signature;
+  tile->last_used = cache->frame;
+  return tile;
+}
+
+gboolean canvas_tile_cache_draw(CanvasTileCache *cache, CanvasData *data, cairo_t *cr,
+                                double visible_x, double visible_y,
+                                double visible_width, double visible_height) {
+  if (!cache || !cache->enabled || !data || !data->spatial_index) {
+    return FALSE;
+  }
+
+  // Re-rasterizing every tile on each step of a zoom gesture costs more than
+  // drawing directly, so only cache once the zoom has settled for a frame
+  double zoom = data->zoom_scale;
+  gboolean zoom_settled = zoom == cache->last_frame_zoom;
+  cache->last_frame_zoom = zoom;
+  if (!zoom_settled || zoom <= 0.0) {
+    return FALSE;
+  }
+
+  // DSL animations override element geometry by uuid at draw time
+  if (data->anim_engine && data->anim_engine->count > 0) {
+    return FALSE;
+  }
+
+  int scale_factor = data->drawing_area ? gtk_widget_get_scale_factor(data->drawing_area) : 1;
+  if (zoom != cache->zoom || scale_factor != cache->scale_factor) {
+    canvas_tile_cache_clear(cache);
+    cache->zoom = zoom;
+    cache->scale_factor = scale_factor;
+  }
+  cache->frame++;
+
+  double extent = CANVAS_TILE_SIZE / zoom;  // Tile edge in canvas units
+  int tx0 = (int)floor(visible_x / extent);
+  int ty0 = (int)floor(visible_y / extent);
+  int tx1 = (int)floor((visible_x + visible_width) / extent);
+  int ty1 = (int)floor((visible_y + visible_height) / extent);
+
+  // Snap tile origins to whole pixels so tiles blit without resampling
+  double snap_x = (round(data->offset_x * zoom) - data->offset_x * zoom) / zoom;
+  double snap_y = (round(data->offset_y * zoom) - data->offset_y * zoom) / zoom;
+
+  for (int ty = ty0; ty <= ty1; ty++) {
+    for (int tx = tx0; tx <= tx1; tx++) {
+      CanvasTile *tile = canvas_tile_cache_get_tile(cache, data, tx, ty, extent);
+      if (!tile) continue;
+
+      cairo_save(cr);
+      cairo_translate(cr, tx * extent + snap_x, ty * extent + snap_y);
+      cairo_scale(cr, 1.0 / zoom, 1.0 / zoom);
+      cairo_set_source_surface(cr, tile->surface, 0, 0);
+      cairo_rectangle(cr, 0, 0, CANVAS_TILE_SIZE, CANVAS_TILE_SIZE);
+      cairo_fill(cr);
+      cairo_restore(cr);
+    }
+  }
+
+  canvas_tile_cache_evict(cache);
+  return TRUE;
+}
@@ -0,0 +1,45 @@
+#ifndef CANVAS_TILE_CACHE_H
+#define CANVAS_TILE_CACHE_H
+
+#include <gtk/gtk.h>
+#include "../elements/element.h"
+
+typedef struct _CanvasData CanvasData;
+
+// Tile edge in logical (widget) pixels
+#define CANVAS_TILE_SIZE 256
+// Upper bound on rasterized tiles kept alive (least recently used are dropped)
+#define CANVAS_TILE_CACHE_MAX_TILES 128
+
+// Raster cache for static canvas content. The canvas is split into fixed
+// screen-sized tiles at the current zoom; each tile remembers a signature of
+// the static elements it was rendered from and is redrawn only when that
+// signature changes (element moved, resized, restyled, hidden, deleted...).
+typedef struct {
+  GHashTable *tiles;        // packed (tx, ty) -> CanvasTile*
+  double zoom;              // Zoom the cached tiles were rendered at
+  int scale_factor;         // Device scale the cached tiles were rendered at
+  double last_frame_zoom;   // Zoom seen by the previous frame
+  guint64 frame;            // Frame counter for LRU bookkeeping
+  GPtrArray *scratch;       // Reused per-tile query buffer
+  gboolean enabled;
+} CanvasTileCache;
+
+CanvasTileCache* canvas_tile_cache_new(void);
+void canvas_tile_cache_free(CanvasTileCache *cache);
+
+// Drop every tile (e.g. when memory should be released)
+void canvas_tile_cache_clear(CanvasTileCache *cache);
+
+// Paint cached static content for the visible canvas rectangle. cr must be in
+// canvas coordinates. Returns FALSE when the cache cannot be used this frame,
+// in which case the caller draws every element itself.
+gboolean canvas_tile_cache_draw(CanvasTileCache *cache, CanvasData *data, cairo_t *cr,
+                                double visible_x, double visible_y,
+                                double visible_width, double visible_height);
+
+// Elements that change from frame to frame (selected, dragged, animating,
+// playing media) are never baked into tiles and are drawn on top instead
+gboolean canvas_element_is_dynamic(CanvasData *data, Element *element);
+
+#endif
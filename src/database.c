@@ -4,6 +4,9 @@
 #include <string.h>
 #include <uuid/uuid.h>
 
+// Longest a writer waits for another connection's write transaction
+#define DATABASE_BUSY_TIMEOUT_MS 2000
+
 int database_init(sqlite3 **db, const char *filename) {
   int rc = sqlite3_open(filename, db);
   if (rc != SQLITE_OK) {
@@ -14,25 +17,601 @@ int database_init(sqlite3 **db, const char *filename) {
 
   // Performance optimizations for faster loading
   sqlite3_exec(*db, "PRAGMA foreign_keys = ON;", NULL, NULL, NULL);
-  // sqlite3_exec(*db, "PRAGMA journal_mode = WAL;", NULL, NULL, NULL);
+  // Wait out a background ref collection batch instead of failing the save
+  sqlite3_busy_timeout(*db, DATABASE_BUSY_TIMEOUT_MS);
+  // Readers see the last commit without waiting for the writer
+  sqlite3_exec(*db, "PRAGMA journal_mode = WAL;", NULL, NULL, NULL);
   sqlite3_exec(*db, "PRAGMA synchronous = NORMAL;", NULL, NULL, NULL);
   sqlite3_exec(*db, "PRAGMA cache_size = -64000;", NULL, NULL, NULL);  // 64MB cache
   sqlite3_exec(*db, "PRAGMA temp_store = MEMORY;", NULL, NULL, NULL);
 
   if (!database_create_tables(*db)) {
-    sqlite3_close(*db);
+    database_close(*db);
     return 0;
   }
 
   if (!database_init_default_namespace(*db)) {
-    sqlite3_close(*db);
+    database_close(*db);
+    return 0;
+  }
+
+  return 1;
+}
+
+// Entries in database_ref_tables and database_element_columns below
+#define DATABASE_REF_TABLE_COUNT 7
+#define DATABASE_ELEMENT_COLUMN_GROUP_COUNT 7
+
+// Statements run once or more per saved or loaded element. Each connection
+// keeps them prepared until database_close(); callers reset them through
+// database_statement_release() instead of finalizing.
+typedef enum {
+  DATABASE_STMT_CREATE_TEXT_REF,
+  DATABASE_STMT_READ_TEXT_REF,
+  DATABASE_STMT_READ_SIZE_REF,
+  DATABASE_STMT_READ_POSITION_REF,
+  DATABASE_STMT_READ_COLOR_REF,
+  DATABASE_STMT_CREATE_POSITION_REF,
+  DATABASE_STMT_CREATE_SIZE_REF,
+  DATABASE_STMT_CREATE_COLOR_REF,
+  DATABASE_STMT_CREATE_ELEMENT,
+  DATABASE_STMT_READ_ELEMENT,
+  DATABASE_STMT_GET_SPACE_NAME,
+  DATABASE_STMT_GET_SPACE_PARENT_ID,
+  DATABASE_STMT_DELETE_ELEMENT,
+  DATABASE_STMT_UPDATE_POSITION_REF,
+  DATABASE_STMT_UPDATE_SIZE_REF,
+  DATABASE_STMT_UPDATE_TEXT_REF,
+  DATABASE_STMT_UPDATE_COLOR_REF,
+  DATABASE_STMT_GET_AMOUNT_OF_ELEMENTS,
+  DATABASE_STMT_CREATE_IMAGE_REF,
+  DATABASE_STMT_READ_IMAGE_REF,
+  DATABASE_STMT_UPDATE_IMAGE_REF,
+  DATABASE_STMT_CREATE_VIDEO_REF,
+  DATABASE_STMT_READ_VIDEO_REF,
+  DATABASE_STMT_UPDATE_VIDEO_REF,
+  DATABASE_STMT_CREATE_AUDIO_REF,
+  DATABASE_STMT_READ_AUDIO_REF,
+  DATABASE_STMT_UPDATE_AUDIO_REF,
+  // One per database_ref_tables entry
+  DATABASE_STMT_COLLECT_ORPHANED_REFS,
+  // One per combination of database_element_columns groups
+  DATABASE_STMT_UPDATE_ELEMENT = DATABASE_STMT_COLLECT_ORPHANED_REFS + DATABASE_REF_TABLE_COUNT,
+  DATABASE_STMT_COUNT = DATABASE_STMT_UPDATE_ELEMENT + (1 << DATABASE_ELEMENT_COLUMN_GROUP_COUNT),
+} DatabaseStatementId;
+
+// sqlite3* -> sqlite3_stmt*[DATABASE_STMT_COUNT]. A connection's statements
+// are only used by the thread currently working on that connection.
+static GMutex database_statements_lock;
+static GHashTable *database_statements = NULL;
+
+static sqlite3_stmt** database_statement_slots(sqlite3 *db) {
+  g_mutex_lock(&database_statements_lock);
+  if (!database_statements) {
+    database_statements = g_hash_table_new(g_direct_hash, g_direct_equal);
+  }
+  sqlite3_stmt **slots = g_hash_table_lookup(database_statements, db);
+  if (!slots) {
+    slots = g_new0(sqlite3_stmt*, DATABASE_STMT_COUNT);
+    g_hash_table_insert(database_statements, db, slots);
+  }
+  g_mutex_unlock(&database_statements_lock);
+  return slots;
+}
+
+// Cached statement for id, prepared from sql on first use. With sql NULL
+// only an already prepared statement is returned. NULL on failure, with the
+// error left on db.
+static sqlite3_stmt* database_statement(sqlite3 *db, DatabaseStatementId id, const char *sql) {
+  sqlite3_stmt **slots = database_statement_slots(db);
+  if (!slots[id] && sql) {
+    if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &slots[id], NULL) != SQLITE_OK) {
+      slots[id] = NULL;
+    }
+  }
+  return slots[id];
+}
+
+// Ready a cached statement for its next use. Resetting also ends the read
+// transaction a SELECT holds, so readers don't pin old WAL snapshots.
+static void database_statement_release(sqlite3_stmt *stmt) {
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+}
+
+void database_close(sqlite3 *db) {
+  if (!db) return;
+
+  g_mutex_lock(&database_statements_lock);
+  sqlite3_stmt **slots = NULL;
+  if (database_statements) {
+    slots = g_hash_table_lookup(database_statements, db);
+    g_hash_table_remove(database_statements, db);
+  }
+  g_mutex_unlock(&database_statements_lock);
+
+  if (slots) {
+    for (int i = 0; i < DATABASE_STMT_COUNT; i++) {
+      sqlite3_finalize(slots[i]);
+    }
+    g_free(slots);
+  }
+  sqlite3_close(db);
+}
+
+int database_open_reader(sqlite3 *db, sqlite3 **reader) {
+  *reader = NULL;
+
+  // In-memory and temporary databases cannot be opened twice
+  const char *filename = sqlite3_db_filename(db, "main");
+  if (!filename || filename[0] == '\0') {
+    return 0;
+  }
+
+  if (sqlite3_open_v2(filename, reader, SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX, NULL) != SQLITE_OK) {
+    fprintf(stderr, "Cannot open read connection: %s\n", sqlite3_errmsg(*reader));
+    sqlite3_close(*reader);
+    *reader = NULL;
     return 0;
   }
 
+  sqlite3_exec(*reader, "PRAGMA cache_size = -64000;", NULL, NULL, NULL);
+  sqlite3_exec(*reader, "PRAGMA temp_store = MEMORY;", NULL, NULL, NULL);
   return 1;
 }
 
-void database_close(sqlite3 *db) { sqlite3_close(db); }
+// WAL pages after which a commit asks for a checkpoint, SQLite's default
+#define DATABASE_CHECKPOINT_PAGES 1000
+
+struct _DatabaseCheckpointer {
+  sqlite3 *writer;
+  sqlite3 *db;            // Own connection, only used on the pool thread
+  GThreadPool *pool;      // One thread, so checkpoints never overlap
+  gint queued;            // A checkpoint is waiting to run
+};
+
+static void database_checkpoint_run(gpointer data, gpointer user_data) {
+  DatabaseCheckpointer *checkpointer = user_data;
+  (void)data;
+
+  g_atomic_int_set(&checkpointer->queued, 0);
+  // Passive: copy what no reader still needs and never block the writer
+  if (sqlite3_wal_checkpoint_v2(checkpointer->db, NULL, SQLITE_CHECKPOINT_PASSIVE, NULL, NULL) != SQLITE_OK) {
+    fprintf(stderr, "WAL checkpoint failed: %s\n", sqlite3_errmsg(checkpointer->db));
+  }
+}
+
+// Called by SQLite after each commit on the writer, in place of the
+// built-in auto-checkpoint
+static int database_checkpoint_hook(void *user_data, sqlite3 *db, const char *schema, int pages) {
+  DatabaseCheckpointer *checkpointer = user_data;
+  (void)db;
+  (void)schema;
+
+  if (pages >= DATABASE_CHECKPOINT_PAGES &&
+      g_atomic_int_compare_and_exchange(&checkpointer->queued, 0, 1)) {
+    g_thread_pool_push(checkpointer->pool, checkpointer, NULL);
+  }
+  return SQLITE_OK;
+}
+
+DatabaseCheckpointer* database_checkpointer_new(sqlite3 *writer) {
+  const char *filename = sqlite3_db_filename(writer, "main");
+  if (!filename || filename[0] == '\0') {
+    return NULL;
+  }
+
+  DatabaseCheckpointer *checkpointer = g_new0(DatabaseCheckpointer, 1);
+  if (sqlite3_open_v2(filename, &checkpointer->db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_FULLMUTEX, NULL) != SQLITE_OK) {
+    fprintf(stderr, "Cannot open checkpoint connection: %s\n", sqlite3_errmsg(checkpointer->db));
+    sqlite3_close(checkpointer->db);
+    g_free(checkpointer);
+    return NULL;
+  }
+
+  checkpointer->writer = writer;
+  checkpointer->pool = g_thread_pool_new(database_checkpoint_run, checkpointer, 1, FALSE, NULL);
+  sqlite3_wal_hook(writer, database_checkpoint_hook, checkpointer);
+  return checkpointer;
+}
+
+void database_checkpointer_free(DatabaseCheckpointer *checkpointer) {
+  if (!checkpointer) return;
+
+  // Hand checkpointing back to SQLite, then let a queued run finish
+  sqlite3_wal_autocheckpoint(checkpointer->writer, DATABASE_CHECKPOINT_PAGES);
+  g_thread_pool_free(checkpointer->pool, FALSE, TRUE);
+  sqlite3_close(checkpointer->db);
+  g_free(checkpointer);
+}
+
+// Seconds a collection request waits so a burst of saves is collected once
+#define DATABASE_REF_COLLECTION_DELAY_SECONDS 2
+// Rows per ref table in one collector transaction. Image and video rows
+// carry blobs, so batches stay small and the writer waits at most one.
+#define DATABASE_REF_COLLECTION_BATCH 32
+
+struct _DatabaseRefCollector {
+  sqlite3 *db;            // Own connection, only used on the pool thread
+  GThreadPool *pool;      // One thread, so collections never overlap
+  gint queued;            // A collection is waiting to run
+  GMutex lock;
+  GCond cond;
+  gboolean stopping;      // Under lock; set by database_ref_collector_free()
+};
+
+static void database_ref_collector_run(gpointer data, gpointer user_data) {
+  DatabaseRefCollector *collector = user_data;
+  (void)data;
+
+  gint64 deadline = g_get_monotonic_time() + DATABASE_REF_COLLECTION_DELAY_SECONDS * G_TIME_SPAN_SECOND;
+  g_mutex_lock(&collector->lock);
+  while (!collector->stopping && g_cond_wait_until(&collector->cond, &collector->lock, deadline));
+  g_mutex_unlock(&collector->lock);
+  g_atomic_int_set(&collector->queued, 0);
+
+  for (;;) {
+    g_mutex_lock(&collector->lock);
+    gboolean stopping = collector->stopping;
+    g_mutex_unlock(&collector->lock);
+    if (stopping || !database_begin_transaction(collector->db)) return;
+
+    int deleted = database_collect_orphaned_refs(collector->db, DATABASE_REF_COLLECTION_BATCH);
+    if (!database_commit_transaction(collector->db)) {
+      database_rollback_transaction(collector->db);
+      return;
+    }
+    // Keep going while batches come back non-empty
+    if (deleted == 0) return;
+  }
+}
+
+DatabaseRefCollector* database_ref_collector_new(sqlite3 *writer) {
+  const char *filename = sqlite3_db_filename(writer, "main");
+  if (!filename || filename[0] == '\0') {
+    return NULL;
+  }
+
+  DatabaseRefCollector *collector = g_new0(DatabaseRefCollector, 1);
+  if (sqlite3_open_v2(filename, &collector->db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_FULLMUTEX, NULL) != SQLITE_OK) {
+    fprintf(stderr, "Cannot open ref collection connection: %s\n", sqlite3_errmsg(collector->db));
+    sqlite3_close(collector->db);
+    g_free(collector);
+    return NULL;
+  }
+  sqlite3_exec(collector->db, "PRAGMA foreign_keys = ON;", NULL, NULL, NULL);
+  sqlite3_busy_timeout(collector->db, DATABASE_BUSY_TIMEOUT_MS);
+
+  g_mutex_init(&collector->lock);
+  g_cond_init(&collector->cond);
+  collector->pool = g_thread_pool_new(database_ref_collector_run, collector, 1, FALSE, NULL);
+  return collector;
+}
+
+void database_ref_collector_request(DatabaseRefCollector *collector) {
+  if (collector && g_atomic_int_compare_and_exchange(&collector->queued, 0, 1)) {
+    g_thread_pool_push(collector->pool, collector, NULL);
+  }
+}
+
+void database_ref_collector_free(DatabaseRefCollector *collector) {
+  if (!collector) return;
+
+  // Cut a pending delay short and stop after the batch in flight; what is
+  // left is collected next session
+  g_mutex_lock(&collector->lock);
+  collector->stopping = TRUE;
+  g_cond_signal(&collector->cond);
+  g_mutex_unlock(&collector->lock);
+  g_thread_pool_free(collector->pool, TRUE, TRUE);
+
+  database_close(collector->db);
+  g_mutex_clear(&collector->lock);
+  g_cond_clear(&collector->cond);
+  g_free(collector);
+}
+
+// Column definitions of the elements table, shared by CREATE TABLE and the
+// migrations that rebuild it
+#define DATABASE_ELEMENTS_COLUMNS \
+    "    uuid TEXT PRIMARY KEY,"          /* UUID */ \
+    "    space_uuid TEXT NOT NULL,"       /* UUID of the space this element belongs to */ \
+    "    type INTEGER NOT NULL,"          /* ElementType value */ \
+    "    position_id INTEGER NOT NULL," \
+    "    size_id INTEGER NOT NULL," \
+    "    text_id INTEGER," \
+    "    bg_color_id INTEGER," \
+    "    from_element_uuid TEXT,"            /* UUID of the source element for connections */ \
+    "    to_element_uuid TEXT,"              /* UUID of the target element for connections */ \
+    "    from_point INTEGER,"                /* For connections 0,1,2,3 (connection point location) */ \
+    "    to_point INTEGER,"                  /* For connections 0,1,2,3 (connection point location) */ \
+    "    target_space_uuid TEXT,"            /* For space elements, UUID of the target space */ \
+    "    image_id INTEGER,"                  /* Image note related */ \
+    "    video_id INTEGER,"                  /* Video note related */ \
+    "    audio_id INTEGER,"                  /* Audio note related */ \
+    "    drawing_points BLOB,"               /* For freehand drawings: array of points */ \
+    "    stroke_width INTEGER,"              /* For freehand drawings and shapes: stroke width */ \
+    "    shape_type INTEGER,"                /* For shapes: type (circle, rectangle, triangle) */ \
+    "    filled INTEGER,"                    /* For shapes: whether shape is filled (boolean) */ \
+    "    stroke_style INTEGER DEFAULT 0,"    /* For shapes: stroke style (solid=0, dashed=1, dotted=2) */ \
+    "    fill_style INTEGER DEFAULT 0,"      /* For shapes: fill style (solid=0, hachure=1, cross-hatch=2) */ \
+    "    stroke_color TEXT,"                 /* For shapes: stroke color in hex format (separate from bg_color) */ \
+    "    connection_type INTEGER,"           /* For connections: parallel, straight, curved */ \
+    "    arrowhead_type INTEGER,"            /* For connections: none, single, double */ \
+    "    rotation_degrees REAL DEFAULT 0.0," /* Rotation angle in degrees (0-360) */ \
+    "    description TEXT,"                  /* Element description/comment */ \
+    "    locked INTEGER NOT NULL DEFAULT 0," /* Whether element is locked (non-interactable except context menu) */ \
+    "    created_at DATETIME DEFAULT CURRENT_TIMESTAMP," \
+    "    FOREIGN KEY (space_uuid) REFERENCES spaces(uuid)," \
+    "    FOREIGN KEY (position_id) REFERENCES position_refs(id)," \
+    "    FOREIGN KEY (size_id) REFERENCES size_refs(id)," \
+    "    FOREIGN KEY (text_id) REFERENCES text_refs(id)," \
+    "    FOREIGN KEY (bg_color_id) REFERENCES color_refs(id)," \
+    "    FOREIGN KEY (image_id) REFERENCES image_refs(id)," \
+    "    FOREIGN KEY (video_id) REFERENCES video_refs(id)," \
+    "    FOREIGN KEY (audio_id) REFERENCES audio_refs(id)," \
+    "    FOREIGN KEY (from_element_uuid) REFERENCES elements(uuid)," \
+    "    FOREIGN KEY (to_element_uuid) REFERENCES elements(uuid)," \
+    "    FOREIGN KEY (target_space_uuid) REFERENCES spaces(uuid)"
+
+// Shared property tables and the elements column pointing into each
+static const struct {
+  const char *table;
+  const char *column;
+} database_ref_tables[] = {
+  { "position_refs", "position_id" },
+  { "size_refs", "size_id" },
+  { "text_refs", "text_id" },
+  { "color_refs", "bg_color_id" },
+  { "image_refs", "image_id" },
+  { "video_refs", "video_id" },
+  { "audio_refs", "audio_id" },
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(database_ref_tables) == DATABASE_REF_TABLE_COUNT);
+G_STATIC_ASSERT(G_N_ELEMENTS(database_ref_tables) ==
+                DATABASE_STMT_UPDATE_ELEMENT - DATABASE_STMT_COLLECT_ORPHANED_REFS);
+
+static int database_column_exists(sqlite3 *db, const char *table, const char *column) {
+  char *sql = g_strdup_printf("PRAGMA table_info(%s)", table);
+  sqlite3_stmt *stmt;
+  int exists = 0;
+
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK) {
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      const char *name = (const char*)sqlite3_column_text(stmt, 1);
+      if (g_strcmp0(name, column) == 0) {
+        exists = 1;
+        break;
+      }
+    }
+    sqlite3_finalize(stmt);
+  }
+  g_free(sql);
+  return exists;
+}
+
+// Databases from before element types became a plain column keep one
+// element_type_refs row per element. Rebuild elements with the type value
+// inlined, following SQLite's copy-drop-rename procedure, and drop the ref
+// table. The triggers that reference elements are recreated afterwards by
+// database_create_tables. Databases created with the inline column skip it.
+static int database_migrate_element_types(sqlite3 *db) {
+  if (!database_column_exists(db, "elements", "type_id")) {
+    return 1;
+  }
+
+  const char *sql =
+    "DROP TRIGGER IF EXISTS text_refs_after_update;"
+    "CREATE TABLE elements_migrated ("
+    DATABASE_ELEMENTS_COLUMNS
+    ");"
+    "INSERT INTO elements_migrated (uuid, type, space_uuid, position_id, size_id, text_id, bg_color_id, from_element_uuid, to_element_uuid, from_point, to_point, target_space_uuid, image_id, video_id, audio_id, drawing_points, stroke_width, shape_type, filled, stroke_style, fill_style, stroke_color, connection_type, arrowhead_type, rotation_degrees, description, locked, created_at) "
+    "SELECT e.uuid, COALESCE(t.type, 0), e.space_uuid, e.position_id, e.size_id, e.text_id, e.bg_color_id, e.from_element_uuid, e.to_element_uuid, e.from_point, e.to_point, e.target_space_uuid, e.image_id, e.video_id, e.audio_id, e.drawing_points, e.stroke_width, e.shape_type, e.filled, e.stroke_style, e.fill_style, e.stroke_color, e.connection_type, e.arrowhead_type, e.rotation_degrees, e.description, e.locked, e.created_at "
+    "FROM elements e LEFT JOIN element_type_refs t ON t.id = e.type_id;"
+    "DROP TABLE elements;"
+    "ALTER TABLE elements_migrated RENAME TO elements;"
+    "DROP TABLE IF EXISTS element_type_refs;";
+
+  return sqlite3_exec(db, sql, NULL, NULL, NULL) == SQLITE_OK;
+}
+
+// Schema history. Each step brings the database from version - 1 to
+// version and is recorded in PRAGMA user_version, so existing databases
+// only run the steps they are missing. A new database gets the current
+// tables from database_create_tables and then runs every step, so steps
+// must also hold on the current schema. Append only: never edit or reorder
+// a step that has shipped. A step that rebuilds elements must recreate its
+// indexes.
+typedef struct {
+  int version;
+  const char *description;
+  const char *sql;                  // Run when set
+  int (*apply)(sqlite3 *db);        // Otherwise called
+} DatabaseMigration;
+
+static const DatabaseMigration database_migrations[] = {
+  { 1, "inline element types", NULL, database_migrate_element_types },
+  { 2, "index elements by space and connection endpoint",
+    "CREATE INDEX IF NOT EXISTS elements_space_uuid ON elements(space_uuid);"
+    "CREATE INDEX IF NOT EXISTS elements_from_element_uuid ON elements(from_element_uuid);"
+    "CREATE INDEX IF NOT EXISTS elements_to_element_uuid ON elements(to_element_uuid);", NULL },
+  { 3, "index elements by ref id",
+    "CREATE INDEX IF NOT EXISTS elements_position_id ON elements(position_id);"
+    "CREATE INDEX IF NOT EXISTS elements_size_id ON elements(size_id);"
+    "CREATE INDEX IF NOT EXISTS elements_text_id ON elements(text_id);"
+    "CREATE INDEX IF NOT EXISTS elements_bg_color_id ON elements(bg_color_id);"
+    "CREATE INDEX IF NOT EXISTS elements_image_id ON elements(image_id);"
+    "CREATE INDEX IF NOT EXISTS elements_video_id ON elements(video_id);"
+    "CREATE INDEX IF NOT EXISTS elements_audio_id ON elements(audio_id);", NULL },
+  { 4, "index spaces by parent",
+    "CREATE INDEX IF NOT EXISTS spaces_parent_uuid ON spaces(parent_uuid);", NULL },
+};
+
+static int database_get_user_version(sqlite3 *db) {
+  sqlite3_stmt *stmt;
+  int version = 0;
+
+  if (sqlite3_prepare_v2(db, "PRAGMA user_version", -1, &stmt, NULL) == SQLITE_OK) {
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+      version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+  }
+  return version;
+}
+
+// Foreign keys are off while migrating, so a table rebuild could leave rows
+// pointing nowhere without an error. Reports each violation.
+static int database_foreign_keys_intact(sqlite3 *db) {
+  sqlite3_stmt *stmt;
+  if (sqlite3_prepare_v2(db, "PRAGMA foreign_key_check", -1, &stmt, NULL) != SQLITE_OK) {
+    return 0;
+  }
+
+  int intact = 1;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    fprintf(stderr, "Foreign key violation: %s row %lld references %s\n",
+            (const char*)sqlite3_column_text(stmt, 0),
+            (long long)sqlite3_column_int64(stmt, 1),
+            (const char*)sqlite3_column_text(stmt, 2));
+    intact = 0;
+  }
+  sqlite3_finalize(stmt);
+  return intact;
+}
+
+// Bring the schema up to the last migration. Every step runs in its own
+// transaction together with its user_version bump, so an interrupted
+// upgrade resumes at the step that failed. A step is only recorded when
+// PRAGMA foreign_key_check finds nothing afterwards.
+static int database_run_migrations(sqlite3 *db) {
+  int version = database_get_user_version(db);
+  int latest = database_migrations[G_N_ELEMENTS(database_migrations) - 1].version;
+
+  if (version > latest) {
+    fprintf(stderr, "Database schema version %d is newer than this build knows (%d)\n", version, latest);
+    return 1;
+  }
+  if (version == latest) {
+    return 1;
+  }
+
+  // Table rebuilds need foreign keys off, and that cannot be toggled
+  // inside a transaction
+  sqlite3_exec(db, "PRAGMA foreign_keys = OFF;", NULL, NULL, NULL);
+
+  int ok = 1;
+  for (guint i = 0; i < G_N_ELEMENTS(database_migrations) && ok; i++) {
+    const DatabaseMigration *migration = &database_migrations[i];
+    if (migration->version <= version) continue;
+
+    if (!database_begin_transaction(db)) {
+      ok = 0;
+      break;
+    }
+
+    char *err_msg = NULL;
+    if (migration->sql) {
+      ok = sqlite3_exec(db, migration->sql, NULL, NULL, &err_msg) == SQLITE_OK;
+    } else {
+      ok = migration->apply(db);
+    }
+
+    if (ok) {
+      ok = database_foreign_keys_intact(db);
+    }
+
+    if (ok) {
+      char *pragma = g_strdup_printf("PRAGMA user_version = %d;", migration->version);
+      ok = sqlite3_exec(db, pragma, NULL, NULL, &err_msg) == SQLITE_OK;
+      g_free(pragma);
+    }
+
+    if (ok) {
+      ok = database_commit_transaction(db);
+    } else {
+      fprintf(stderr, "Failed to migrate database to version %d (%s): %s\n",
+              migration->version, migration->description, err_msg ? err_msg : sqlite3_errmsg(db));
+      database_rollback_transaction(db);
+    }
+    sqlite3_free(err_msg);
+  }
+
+  sqlite3_exec(db, "PRAGMA foreign_keys = ON;", NULL, NULL, NULL);
+  return ok;
+}
+
+static int database_trigger_exists(sqlite3 *db, const char *name) {
+  const char *sql = "SELECT 1 FROM sqlite_master WHERE type = 'trigger' AND name = ?";
+  sqlite3_stmt *stmt;
+  int exists = 0;
+
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK) {
+    sqlite3_bind_text(stmt, 1, name, -1, SQLITE_STATIC);
+    exists = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+  }
+  return exists;
+}
+
+// Keep ref_count in step with the elements pointing at each ref row, so
+// saves never recount. Refs are inserted with a count of 0 and picked up
+// by the element insert. Orphans (count below 1) are found through a
+// partial index and removed later by database_collect_orphaned_refs().
+// Databases that predate the triggers are recounted once when they are
+// installed; a migration that rebuilds elements drops them, so that covers
+// migrated databases too.
+static int database_create_ref_count_triggers(sqlite3 *db) {
+  int installed = database_trigger_exists(db, "elements_refs_after_insert");
+
+  GString *sql = g_string_new(NULL);
+  GString *on_insert = g_string_new(NULL);
+  GString *on_delete = g_string_new(NULL);
+  GString *on_update = g_string_new(NULL);
+  GString *update_columns = g_string_new(NULL);
+
+  for (guint i = 0; i < G_N_ELEMENTS(database_ref_tables); i++) {
+    const char *table = database_ref_tables[i].table;
+    const char *column = database_ref_tables[i].column;
+
+    g_string_append_printf(sql,
+      "CREATE INDEX IF NOT EXISTS %s_orphaned ON %s(id) WHERE ref_count < 1;", table, table);
+    g_string_append_printf(on_insert,
+      "    UPDATE %s SET ref_count = ref_count + 1 WHERE id = NEW.%s;", table, column);
+    g_string_append_printf(on_delete,
+      "    UPDATE %s SET ref_count = ref_count - 1 WHERE id = OLD.%s;", table, column);
+    g_string_append_printf(on_update,
+      "    UPDATE %s SET ref_count = ref_count - 1 WHERE id = OLD.%s AND OLD.%s IS NOT NEW.%s;"
+      "    UPDATE %s SET ref_count = ref_count + 1 WHERE id = NEW.%s AND OLD.%s IS NOT NEW.%s;",
+      table, column, column, column, table, column, column, column);
+    g_string_append_printf(update_columns, "%s%s", i > 0 ? ", " : "", column);
+  }
+
+  g_string_append_printf(sql,
+    "CREATE TRIGGER IF NOT EXISTS elements_refs_after_insert AFTER INSERT ON elements "
+    "BEGIN %s END;"
+    "CREATE TRIGGER IF NOT EXISTS elements_refs_after_delete AFTER DELETE ON elements "
+    "BEGIN %s END;"
+    "CREATE TRIGGER IF NOT EXISTS elements_refs_after_update AFTER UPDATE OF %s ON elements "
+    "BEGIN %s END;",
+    on_insert->str, on_delete->str, update_columns->str, on_update->str);
+
+  char *err_msg = NULL;
+  int ok = sqlite3_exec(db, sql->str, NULL, NULL, &err_msg) == SQLITE_OK;
+  if (!ok) {
+    fprintf(stderr, "Failed to create ref count triggers: %s\n", err_msg);
+    sqlite3_free(err_msg);
+  } else if (!installed) {
+    ok = database_recalculate_ref_counts(db);
+  }
+
+  g_string_free(sql, TRUE);
+  g_string_free(on_insert, TRUE);
+  g_string_free(on_delete, TRUE);
+  g_string_free(on_update, TRUE);
+  g_string_free(update_columns, TRUE);
+  return ok;
+}
 
 int database_create_tables(sqlite3 *db) {
   char *err_msg = NULL;
@@ -51,13 +630,6 @@ int database_create_tables(sqlite3 *db) {
     ");"
 
     // Property reference tables
-    "CREATE TABLE IF NOT EXISTS element_type_refs ("
-    "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
-    "    type INTEGER NOT NULL,"
-    "    ref_count INTEGER DEFAULT 1,"
-    "    created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
-    ");"
-
     "CREATE TABLE IF NOT EXISTS video_refs ("
     "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
     "    thumbnail_data BLOB NOT NULL,"      // Thumbnail image data
@@ -129,46 +701,7 @@ int database_create_tables(sqlite3 *db) {
 
     // Elements table
     "CREATE TABLE IF NOT EXISTS elements ("
-    "    uuid TEXT PRIMARY KEY,"          // UUID
-    "    space_uuid TEXT NOT NULL,"       // UUID of the space this element belongs to
-    "    type_id INTEGER NOT NULL,"       // Reference to element_type_refs
-    "    position_id INTEGER NOT NULL,"
-    "    size_id INTEGER NOT NULL,"
-    "    text_id INTEGER,"
-    "    bg_color_id INTEGER,"
-    "    from_element_uuid TEXT,"            // UUID of the source element for connections
-    "    to_element_uuid TEXT,"              // UUID of the target element for connections
-    "    from_point INTEGER,"                // For connections 0,1,2,3 (connection point location)
-    "    to_point INTEGER,"                  // For connections 0,1,2,3 (connection point location)
-    "    target_space_uuid TEXT,"            // For space elements, UUID of the target space
-    "    image_id INTEGER,"                  // Image note related
-    "    video_id INTEGER,"                  // Video note related
-    "    audio_id INTEGER,"                  // Audio note related
-    "    drawing_points BLOB,"               // For freehand drawings: array of points
-    "    stroke_width INTEGER,"              // For freehand drawings and shapes: stroke width
-    "    shape_type INTEGER,"                // For shapes: type (circle, rectangle, triangle)
-    "    filled INTEGER,"                    // For shapes: whether shape is filled (boolean)
-    "    stroke_style INTEGER DEFAULT 0,"    // For shapes: stroke style (solid=0, dashed=1, dotted=2)
-    "    fill_style INTEGER DEFAULT 0,"      // For shapes: fill style (solid=0, hachure=1, cross-hatch=2)
-    "    stroke_color TEXT,"                 // For shapes: stroke color in hex format (separate from bg_color)
-    "    connection_type INTEGER,"           // For connections: parallel, straight, curved
-    "    arrowhead_type INTEGER,"            // For connections: none, single, double
-    "    rotation_degrees REAL DEFAULT 0.0," // Rotation angle in degrees (0-360)
-    "    description TEXT,"                  // Element description/comment
-    "    locked INTEGER NOT NULL DEFAULT 0," // Whether element is locked (non-interactable except context menu)
-    "    created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
-    "    FOREIGN KEY (space_uuid) REFERENCES spaces(uuid),"
-    "    FOREIGN KEY (type_id) REFERENCES element_type_refs(id),"
-    "    FOREIGN KEY (position_id) REFERENCES position_refs(id),"
-    "    FOREIGN KEY (size_id) REFERENCES size_refs(id),"
-    "    FOREIGN KEY (text_id) REFERENCES text_refs(id),"
-    "    FOREIGN KEY (bg_color_id) REFERENCES color_refs(id),"
-    "    FOREIGN KEY (image_id) REFERENCES image_refs(id),"
-    "    FOREIGN KEY (video_id) REFERENCES video_refs(id),"
-    "    FOREIGN KEY (audio_id) REFERENCES audio_refs(id),"
-    "    FOREIGN KEY (from_element_uuid) REFERENCES elements(uuid),"
-    "    FOREIGN KEY (to_element_uuid) REFERENCES elements(uuid),"
-    "    FOREIGN KEY (target_space_uuid) REFERENCES spaces(uuid)"
+    DATABASE_ELEMENTS_COLUMNS
     ");"
 
     "CREATE TABLE IF NOT EXISTS app_settings ("
@@ -192,6 +725,14 @@ int database_create_tables(sqlite3 *db) {
     return 0;
   }
 
+  if (!database_run_migrations(db)) {
+    return 0;
+  }
+
+  if (!database_create_ref_count_triggers(db)) {
+    return 0;
+  }
+
   const char *fts_sql =
     "CREATE VIRTUAL TABLE IF NOT EXISTS element_text_fts USING fts5("
     "    element_uuid,"
@@ -353,10 +894,11 @@ int database_create_text_ref(sqlite3 *db,
                              gboolean strikethrough,
                              const char *alignment,
                              int *text_id) {
-  const char *sql = "INSERT INTO text_refs (text, text_r, text_g, text_b, text_a, font_description, strikethrough, alignment) VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
+  const char *sql = "INSERT INTO text_refs (text, text_r, text_g, text_b, text_a, font_description, strikethrough, alignment, ref_count) VALUES (?, ?, ?, ?, ?, ?, ?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_TEXT_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -372,12 +914,12 @@ int database_create_text_ref(sqlite3 *db,
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create text: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *text_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -393,7 +935,8 @@ int database_read_text_ref(sqlite3 *db, int text_id, ModelText **text) {
   const char *sql = "SELECT text, text_r, text_g, text_b, text_a, font_description, strikethrough, alignment, ref_count FROM text_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_TEXT_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0; // Error
   }
@@ -428,92 +971,15 @@ int database_read_text_ref(sqlite3 *db, int text_id, ModelText **text) {
     model_text->ref_count = sqlite3_column_int(stmt, 8);
 
     *text = model_text;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1; // Success
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   // Text not found, but this is not an error - *text remains NULL
   return 1; // Success (no error occurred)
 }
 
-// Type reference operations
-int database_create_type_ref(sqlite3 *db, ElementType element_type, int *type_id) {
-  const char *sql = "INSERT INTO element_type_refs (type) VALUES (?)";
-  sqlite3_stmt *stmt;
-
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-    fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
-    return 0;
-  }
-
-  sqlite3_bind_int(stmt, 1, element_type);
-
-  if (sqlite3_step(stmt) != SQLITE_DONE) {
-    fprintf(stderr, "Failed to create type: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
-    return 0;
-  }
-
-  // If the type already existed, we need to get its ID
-  if (sqlite3_changes(db) == 0) {
-    sqlite3_finalize(stmt);
-    const char *select_sql = "SELECT id FROM element_type_refs WHERE type = ?";
-    if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, NULL) != SQLITE_OK) {
-      fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
-      return 0;
-    }
-    sqlite3_bind_int(stmt, 1, element_type);
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-      *type_id = sqlite3_column_int(stmt, 0);
-    } else {
-      fprintf(stderr, "Failed to find type: %d\n", element_type);
-      sqlite3_finalize(stmt);
-      return 0;
-    }
-  } else {
-    *type_id = sqlite3_last_insert_rowid(db);
-  }
-
-  sqlite3_finalize(stmt);
-  return 1;
-}
-
-int database_read_type_ref(sqlite3 *db, int type_id, ModelType **type) {
-  // Initialize output to NULL
-  *type = NULL;
-
-  if (type_id <= 0) {
-    fprintf(stderr, "Error: Invalid type_id (%d) in database_read_type_ref\n", type_id);
-    return 0; // Error - invalid input
-  }
-
-  const char *sql = "SELECT type, ref_count FROM element_type_refs WHERE id = ?";
-  sqlite3_stmt *stmt;
-
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-    fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
-    return 0; // Error
-  }
-
-  sqlite3_bind_int(stmt, 1, type_id);
-
-  if (sqlite3_step(stmt) == SQLITE_ROW) {
-    ModelType *model_type = g_new0(ModelType, 1);
-    model_type->id = type_id;
-    model_type->type = sqlite3_column_int(stmt, 0);
-    model_type->ref_count = sqlite3_column_int(stmt, 1);
-
-    *type = model_type;
-    sqlite3_finalize(stmt);
-    return 1; // Success
-  }
-
-  sqlite3_finalize(stmt);
-  // Type not found, but this is not an error - *type remains NULL
-  return 1; // Success (no error occurred)
-}
-
 int database_read_size_ref(sqlite3 *db, int size_id, ModelSize **size) {
   // Initialize output to NULL
   *size = NULL;
@@ -526,7 +992,8 @@ int database_read_size_ref(sqlite3 *db, int size_id, ModelSize **size) {
   const char *sql = "SELECT width, height, ref_count FROM size_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_SIZE_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0; // Error
   }
@@ -541,11 +1008,11 @@ int database_read_size_ref(sqlite3 *db, int size_id, ModelSize **size) {
     model_size->ref_count = sqlite3_column_int(stmt, 2);
 
     *size = model_size;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1; // Success
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   // Size not found, but this is not an error - *size remains NULL
   return 1; // Success (no error occurred)
 }
@@ -562,7 +1029,8 @@ int database_read_position_ref(sqlite3 *db, int position_id, ModelPosition **pos
   const char *sql = "SELECT x, y, z, ref_count FROM position_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_POSITION_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0; // Error
   }
@@ -578,11 +1046,11 @@ int database_read_position_ref(sqlite3 *db, int position_id, ModelPosition **pos
     model_position->ref_count = sqlite3_column_int(stmt, 3);
 
     *position = model_position;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1; // Success
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   // Position not found, but this is not an error - *position remains NULL
   return 1; // Success (no error occurred)
 }
@@ -599,7 +1067,8 @@ int database_read_color_ref(sqlite3 *db, int bg_color_id, ModelColor **color) {
   const char *sql = "SELECT r, g, b, a, ref_count FROM color_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_COLOR_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0; // Error
   }
@@ -616,21 +1085,22 @@ int database_read_color_ref(sqlite3 *db, int bg_color_id, ModelColor **color) {
     model_color->ref_count = sqlite3_column_int(stmt, 4);
 
     *color = model_color;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1; // Success
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   // Color not found, but this is not an error - *color remains NULL
   return 1; // Success (no error occurred)
 }
 
 // Position reference operations
 int database_create_position_ref(sqlite3 *db, int x, int y, int z, int *position_id) {
-  const char *sql = "INSERT INTO position_refs (x, y, z) VALUES (?, ?, ?)";
+  const char *sql = "INSERT INTO position_refs (x, y, z, ref_count) VALUES (?, ?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_POSITION_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -641,21 +1111,22 @@ int database_create_position_ref(sqlite3 *db, int x, int y, int z, int *position
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create position: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *position_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
 // Size reference operations
 int database_create_size_ref(sqlite3 *db, int width, int height, int *size_id) {
-  const char *sql = "INSERT INTO size_refs (width, height) VALUES (?, ?)";
+  const char *sql = "INSERT INTO size_refs (width, height, ref_count) VALUES (?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_SIZE_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -665,21 +1136,22 @@ int database_create_size_ref(sqlite3 *db, int width, int height, int *size_id) {
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create size: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *size_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
 // Color reference operations
 int database_create_color_ref(sqlite3 *db, double r, double g, double b, double a, int *bg_color_id) {
-  const char *sql = "INSERT INTO color_refs (r, g, b, a) VALUES (?, ?, ?, ?)";
+  const char *sql = "INSERT INTO color_refs (r, g, b, a, ref_count) VALUES (?, ?, ?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_COLOR_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -691,28 +1163,17 @@ int database_create_color_ref(sqlite3 *db, double r, double g, double b, double
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create color: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *bg_color_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
 int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *element) {
-  int type_id, position_id, size_id, text_id = 0, bg_color_id = 0, image_id = 0, video_id = 0;
-
-  // Handle type reference
-  if (element->type->id == -1) {
-    // Create new type reference
-    if (!database_create_type_ref(db, element->type->type, &type_id)) return 0;
-    element->type->id = type_id;
-  } else {
-    // Update existing type reference
-    if (!database_update_type_ref(db, element->type)) return 0;
-    type_id = element->type->id;
-  }
+  int position_id, size_id, text_id = 0, bg_color_id = 0, image_id = 0, video_id = 0;
 
   // Handle position reference
   if (element->position->id == -1) {
@@ -760,8 +1221,7 @@ int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *e
       if (!database_create_image_ref(db, element->image->image_data, element->image->image_size, &image_id)) return 0;
       element->image->id = image_id;
     } else {
-      // Update existing image reference
-      if (!database_update_image_ref(db, element->image)) return 0;
+      // Shared with the element it was forked from; the insert trigger counts it
       image_id = element->image->id;
     }
   }
@@ -778,10 +1238,6 @@ int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *e
       }
       element->video->id = video_id;
     } else {
-      if (!database_update_video_ref(db, element->video)) {
-        fprintf(stderr, "Failed to update video ref for element %s\n", element->uuid);
-        return 0;
-      }
       video_id = element->video->id;
     }
   }
@@ -798,10 +1254,6 @@ int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *e
       }
       element->audio->id = audio_id;
     } else {
-      if (!database_update_audio_ref(db, element->audio)) {
-        fprintf(stderr, "Failed to update audio ref for element %s\n", element->uuid);
-        return 0;
-      }
       audio_id = element->audio->id;
     }
   }
@@ -824,11 +1276,12 @@ int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *e
     return 0;
   }
 
-  const char *sql = "INSERT INTO elements (uuid, space_uuid, type_id, position_id, size_id, text_id, bg_color_id, from_element_uuid, to_element_uuid, from_point, to_point, target_space_uuid, image_id, video_id, audio_id, drawing_points, stroke_width, shape_type, filled, stroke_style, fill_style, stroke_color, connection_type, arrowhead_type, rotation_degrees, description, locked) "
+  const char *sql = "INSERT INTO elements (uuid, space_uuid, type, position_id, size_id, text_id, bg_color_id, from_element_uuid, to_element_uuid, from_point, to_point, target_space_uuid, image_id, video_id, audio_id, drawing_points, stroke_width, shape_type, filled, stroke_style, fill_style, stroke_color, connection_type, arrowhead_type, rotation_degrees, description, locked) "
     "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_ELEMENT, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -836,7 +1289,7 @@ int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *e
   int param_index = 1;
   sqlite3_bind_text(stmt, param_index++, element->uuid, -1, SQLITE_STATIC);
   sqlite3_bind_text(stmt, param_index++, space_uuid, -1, SQLITE_STATIC);
-  sqlite3_bind_int(stmt, param_index++, type_id);
+  sqlite3_bind_int(stmt, param_index++, element->type->type);
   sqlite3_bind_int(stmt, param_index++, position_id);
   sqlite3_bind_int(stmt, param_index++, size_id);
 
@@ -936,17 +1389,17 @@ int database_create_element(sqlite3 *db, const char *space_uuid, ModelElement *e
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create element: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
 
   return 1;
 }
 
 int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **element) {
-  const char *sql = "SELECT type_id, position_id, size_id, text_id, bg_color_id, "
+  const char *sql = "SELECT type, position_id, size_id, text_id, bg_color_id, "
     "from_element_uuid, to_element_uuid, from_point, to_point, target_space_uuid, space_uuid, image_id, video_id, audio_id, "
     "drawing_points, stroke_width, shape_type, filled, stroke_style, fill_style, stroke_color, connection_type, arrowhead_type, rotation_degrees, description, created_at, locked "
     "FROM elements WHERE uuid = ?";
@@ -955,7 +1408,8 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
   // Initialize output to NULL in case of error or not found
   *element = NULL;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_ELEMENT, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0; // Error
   }
@@ -969,9 +1423,11 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     int col = 0;
 
     // Read type
-    int type_id = sqlite3_column_int(stmt, col++);
-    if (!database_read_type_ref(db, type_id, &elem->type)) {
-      sqlite3_finalize(stmt);
+    int element_type = sqlite3_column_int(stmt, col++);
+    elem->type = model_type_get(element_type);
+    if (!elem->type) {
+      fprintf(stderr, "Error: Invalid element type (%d) for element %s\n", element_type, element_uuid);
+      database_statement_release(stmt);
       model_element_free(elem);
       return 0; // Error
     }
@@ -979,7 +1435,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     // Read position
     int position_id = sqlite3_column_int(stmt, col++);
     if (!database_read_position_ref(db, position_id, &elem->position)) {
-      sqlite3_finalize(stmt);
+      database_statement_release(stmt);
       model_element_free(elem);
       return 0; // Error
     }
@@ -987,7 +1443,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     // Read size
     int size_id = sqlite3_column_int(stmt, col++);
     if (!database_read_size_ref(db, size_id, &elem->size)) {
-      sqlite3_finalize(stmt);
+      database_statement_release(stmt);
       model_element_free(elem);
       return 0; // Error
     }
@@ -996,7 +1452,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     int text_id = sqlite3_column_int(stmt, col++);
     if (text_id > 0) {
       if (!database_read_text_ref(db, text_id, &elem->text)) {
-        sqlite3_finalize(stmt);
+        database_statement_release(stmt);
         model_element_free(elem);
         return 0; // Error
       }
@@ -1006,7 +1462,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     int bg_color_id = sqlite3_column_int(stmt, col++);
     if (bg_color_id > 0) {
       if (!database_read_color_ref(db, bg_color_id, &elem->bg_color)) {
-        sqlite3_finalize(stmt);
+        database_statement_release(stmt);
         model_element_free(elem);
         return 0; // Error
       }
@@ -1039,7 +1495,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     int image_id = sqlite3_column_int(stmt, col++);
     if (image_id > 0) {
       if (!database_read_image_ref(db, image_id, &elem->image)) {
-        sqlite3_finalize(stmt);
+        database_statement_release(stmt);
         model_element_free(elem);
         return 0; // Error
       }
@@ -1048,7 +1504,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     int video_id = sqlite3_column_int(stmt, col++);
     if (video_id > 0) {
       if (!database_read_video_ref(db, video_id, &elem->video)) {
-        sqlite3_finalize(stmt);
+        database_statement_release(stmt);
         model_element_free(elem);
         return 0; // Error
       }
@@ -1057,7 +1513,7 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     int audio_id = sqlite3_column_int(stmt, col++);
     if (audio_id > 0) {
       if (!database_read_audio_ref(db, audio_id, &elem->audio)) {
-        sqlite3_finalize(stmt);
+        database_statement_release(stmt);
         model_element_free(elem);
         return 0; // Error
       }
@@ -1103,191 +1559,202 @@ int database_read_element(sqlite3 *db, const char *element_uuid, ModelElement **
     elem->locked = sqlite3_column_int(stmt, col++) ? TRUE : FALSE;
 
     *element = elem;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1; // Success
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   // Element not found, but this is not an error - *element remains NULL
   return 1; // Success (no error occurred)
 }
 
-int database_update_element(sqlite3 *db, const char *element_uuid, const ModelElement *element) {
-  if (element->type && element->type->id > 0) {
-    if (!database_update_type_ref(db, element->type)) {
-      fprintf(stderr, "Failed to update type ref for element %s\n", element->uuid);
-      return 0;
-    }
+// elements columns written for each ModelField. Values are bound by name,
+// so a statement only has to name the columns it sets.
+static const struct {
+  guint field;
+  const char *assignments;
+} database_element_columns[] = {
+  { MODEL_FIELD_REFS, "position_id = :position_id, size_id = :size_id, text_id = :text_id, "
+                      "bg_color_id = :bg_color_id, image_id = :image_id, video_id = :video_id" },
+  { MODEL_FIELD_CONNECTION, "from_element_uuid = :from_element_uuid, to_element_uuid = :to_element_uuid, "
+                            "from_point = :from_point, to_point = :to_point, "
+                            "connection_type = :connection_type, arrowhead_type = :arrowhead_type" },
+  { MODEL_FIELD_SPACE, "space_uuid = :space_uuid, target_space_uuid = :target_space_uuid" },
+  { MODEL_FIELD_SHAPE, "drawing_points = :drawing_points, stroke_width = :stroke_width, "
+                       "shape_type = :shape_type, filled = :filled, stroke_style = :stroke_style, "
+                       "fill_style = :fill_style, stroke_color = :stroke_color" },
+  { MODEL_FIELD_ROTATION, "rotation_degrees = :rotation_degrees" },
+  { MODEL_FIELD_DESCRIPTION, "description = :description" },
+  { MODEL_FIELD_LOCKED, "locked = :locked" },
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(database_element_columns) == DATABASE_ELEMENT_COLUMN_GROUP_COUNT);
+G_STATIC_ASSERT((1 << G_N_ELEMENTS(database_element_columns)) ==
+                DATABASE_STMT_COUNT - DATABASE_STMT_UPDATE_ELEMENT);
+
+// Binding a name the statement doesn't use hits index 0 and is ignored
+static int database_param(sqlite3_stmt *stmt, const char *name) {
+  return sqlite3_bind_parameter_index(stmt, name);
+}
+
+static void database_bind_ref_id(sqlite3_stmt *stmt, const char *name, gint id) {
+  if (id > 0) {
+    sqlite3_bind_int(stmt, database_param(stmt, name), id);
+  } else {
+    sqlite3_bind_null(stmt, database_param(stmt, name));
   }
-  if (element->position && element->position->id > 0) {
+}
+
+static void database_bind_uuid(sqlite3_stmt *stmt, const char *name, const char *uuid) {
+  if (uuid && database_is_valid_uuid(uuid)) {
+    sqlite3_bind_text(stmt, database_param(stmt, name), uuid, -1, SQLITE_STATIC);
+  } else {
+    sqlite3_bind_null(stmt, database_param(stmt, name));
+  }
+}
+
+static void database_bind_optional_text(sqlite3_stmt *stmt, const char *name, const char *text) {
+  if (text) {
+    sqlite3_bind_text(stmt, database_param(stmt, name), text, -1, SQLITE_STATIC);
+  } else {
+    sqlite3_bind_null(stmt, database_param(stmt, name));
+  }
+}
+
+int database_update_element(sqlite3 *db, const char *element_uuid, const ModelElement *element) {
+  // Elements marked updated without saying what changed get everything but media
+  guint fields = element->changed_fields ? element->changed_fields : MODEL_FIELD_ALL;
+
+  if ((fields & MODEL_FIELD_POSITION) && element->position && element->position->id > 0) {
     if (!database_update_position_ref(db, element->position)) {
       fprintf(stderr, "Failed to update position ref for element %s\n", element->uuid);
       return 0;
     }
   }
-  if (element->size && element->size->id > 0) {
+  if ((fields & MODEL_FIELD_SIZE) && element->size && element->size->id > 0) {
     if (!database_update_size_ref(db, element->size)) {
       fprintf(stderr, "Failed to update size ref for element %s\n", element->uuid);
       return 0;
     }
   }
-  if (element->text && element->text->text && element->text->id > 0) {
+  if ((fields & MODEL_FIELD_TEXT) && element->text && element->text->text && element->text->id > 0) {
     if (!database_update_text_ref(db, element->text)) {
       fprintf(stderr, "Failed to update text ref for element %s\n", element->uuid);
       return 0;
     }
   }
-  if (element->bg_color && element->bg_color->id > 0) {
+  if ((fields & MODEL_FIELD_COLOR) && element->bg_color && element->bg_color->id > 0) {
     if (!database_update_color_ref(db, element->bg_color)) {
       fprintf(stderr, "Failed to update color ref for element %s\n", element->uuid);
       return 0;
     }
   }
-  if (element->image && element->image->id > 0) {
+  if ((fields & MODEL_FIELD_IMAGE) && element->image && element->image->id > 0) {
     if (!database_update_image_ref(db, element->image)) {
       fprintf(stderr, "Failed to update image ref for element %s\n", element->uuid);
       return 0;
     }
   }
-  if (element->video && element->video->id > 0) {
+  if ((fields & MODEL_FIELD_VIDEO) && element->video && element->video->id > 0) {
     if (!database_update_video_ref(db, element->video)) {
       fprintf(stderr, "Failed to update video ref for element %s\n", element->uuid);
       return 0;
     }
   }
 
-  // Update the element record with all reference IDs
-  const char *sql = "UPDATE elements SET "
-    "type_id = ?, position_id = ?, size_id = ?, "
-    "text_id = ?, bg_color_id = ?, image_id = ?, video_id = ?, "
-    "from_element_uuid = ?, to_element_uuid = ?, "
-    "from_point = ?, to_point = ?, target_space_uuid = ?, "
-    "space_uuid = ?, drawing_points = ?, stroke_width = ?, "
-    "shape_type = ?, filled = ?, stroke_style = ?, fill_style = ?, stroke_color = ?, connection_type = ?, arrowhead_type = ?, rotation_degrees = ?, description = ?, locked = ? "
-    "WHERE uuid = ?";
-
-  sqlite3_stmt *stmt;
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-    fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
+  if ((fields & MODEL_FIELD_SPACE) && !(element->space_uuid && database_is_valid_uuid(element->space_uuid))) {
+    fprintf(stderr, "Error: space_uuid is required for element %s\n", element_uuid);
     return 0;
   }
 
-  int param_index = 1;
-
-  // Bind reference IDs (required references should always be present)
-  sqlite3_bind_int(stmt, param_index++, element->type->id);
-  sqlite3_bind_int(stmt, param_index++, element->position->id);
-  sqlite3_bind_int(stmt, param_index++, element->size->id);
-
-  // Optional references
-  if (element->text && element->text->id > 0) {
-    sqlite3_bind_int(stmt, param_index++, element->text->id);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
-  }
-
-  if (element->bg_color && element->bg_color->id > 0) {
-    sqlite3_bind_int(stmt, param_index++, element->bg_color->id);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
-  }
-
-  if (element->image && element->image->id > 0) {
-    sqlite3_bind_int(stmt, param_index++, element->image->id);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
+  // Update only the elements columns that changed; a move or resize only
+  // touches its ref row
+  guint groups = 0;
+  for (guint i = 0; i < G_N_ELEMENTS(database_element_columns); i++) {
+    if (fields & database_element_columns[i].field) {
+      groups |= 1 << i;
+    }
   }
-
-  if (element->video && element->video->id > 0) {
-    sqlite3_bind_int(stmt, param_index++, element->video->id);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
+  if (groups == 0) {
+    return 1;
   }
 
-  // Handle connection properties
-  if (element->from_element_uuid && database_is_valid_uuid(element->from_element_uuid)) {
-    sqlite3_bind_text(stmt, param_index++, element->from_element_uuid, -1, SQLITE_STATIC);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
+  // Each combination of column groups is prepared once per connection
+  DatabaseStatementId id = DATABASE_STMT_UPDATE_ELEMENT + groups;
+  sqlite3_stmt *stmt = database_statement(db, id, NULL);
+  if (!stmt) {
+    GString *sql = g_string_new("UPDATE elements SET ");
+    gboolean first = TRUE;
+    for (guint i = 0; i < G_N_ELEMENTS(database_element_columns); i++) {
+      if (!(groups & (1 << i))) continue;
+      if (!first) g_string_append(sql, ", ");
+      g_string_append(sql, database_element_columns[i].assignments);
+      first = FALSE;
+    }
+    g_string_append(sql, " WHERE uuid = :uuid");
+    stmt = database_statement(db, id, sql->str);
+    g_string_free(sql, TRUE);
   }
-
-  if (element->to_element_uuid && database_is_valid_uuid(element->to_element_uuid)) {
-    sqlite3_bind_text(stmt, param_index++, element->to_element_uuid, -1, SQLITE_STATIC);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
+  if (!stmt) {
+    fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
+    return 0;
   }
 
-  sqlite3_bind_int(stmt, param_index++, element->from_point);
-  sqlite3_bind_int(stmt, param_index++, element->to_point);
-
-  if (element->target_space_uuid && database_is_valid_uuid(element->target_space_uuid)) {
-    sqlite3_bind_text(stmt, param_index++, element->target_space_uuid, -1, SQLITE_STATIC);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
+  // Reference IDs (position and size are required and always present)
+  if (fields & MODEL_FIELD_REFS) {
+    sqlite3_bind_int(stmt, database_param(stmt, ":position_id"), element->position->id);
+    sqlite3_bind_int(stmt, database_param(stmt, ":size_id"), element->size->id);
+    database_bind_ref_id(stmt, ":text_id", element->text ? element->text->id : 0);
+    database_bind_ref_id(stmt, ":bg_color_id", element->bg_color ? element->bg_color->id : 0);
+    database_bind_ref_id(stmt, ":image_id", element->image ? element->image->id : 0);
+    database_bind_ref_id(stmt, ":video_id", element->video ? element->video->id : 0);
   }
 
-  if (element->space_uuid && database_is_valid_uuid(element->space_uuid)) {
-    sqlite3_bind_text(stmt, param_index++, element->space_uuid, -1, SQLITE_STATIC);
-  } else {
-    fprintf(stderr, "Error: space_uuid is required for element %s\n", element_uuid);
-    sqlite3_finalize(stmt);
-    return 0;
-  }
+  // Connection properties
+  database_bind_uuid(stmt, ":from_element_uuid", element->from_element_uuid);
+  database_bind_uuid(stmt, ":to_element_uuid", element->to_element_uuid);
+  sqlite3_bind_int(stmt, database_param(stmt, ":from_point"), element->from_point);
+  sqlite3_bind_int(stmt, database_param(stmt, ":to_point"), element->to_point);
+  sqlite3_bind_int(stmt, database_param(stmt, ":connection_type"), element->connection_type);
+  sqlite3_bind_int(stmt, database_param(stmt, ":arrowhead_type"), element->arrowhead_type);
 
+  // Space membership
+  database_bind_uuid(stmt, ":space_uuid", element->space_uuid);
+  database_bind_uuid(stmt, ":target_space_uuid", element->target_space_uuid);
 
+  // Shape and drawing properties
   if (element->drawing_points && element->drawing_points->len > 0) {
-    sqlite3_bind_blob(stmt, param_index++,
+    sqlite3_bind_blob(stmt, database_param(stmt, ":drawing_points"),
                       element->drawing_points->data,
                       element->drawing_points->len * sizeof(DrawingPoint),
                       SQLITE_STATIC);
   } else {
-    sqlite3_bind_null(stmt, param_index++);
+    sqlite3_bind_null(stmt, database_param(stmt, ":drawing_points"));
   }
-
   if (element->stroke_width > 0) {
-    sqlite3_bind_int(stmt, param_index++, element->stroke_width);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
-  }
-  // Bind shape_type (for shapes)
-  sqlite3_bind_int(stmt, param_index++, element->shape_type);
-  // Bind filled (for shapes)
-  sqlite3_bind_int(stmt, param_index++, element->filled ? 1 : 0);
-  // Bind stroke_style (for shapes)
-  sqlite3_bind_int(stmt, param_index++, element->stroke_style);
-  // Bind fill_style (for shapes)
-  sqlite3_bind_int(stmt, param_index++, element->fill_style);
-  // Bind stroke_color (for shapes)
-  if (element->stroke_color) {
-    sqlite3_bind_text(stmt, param_index++, element->stroke_color, -1, SQLITE_STATIC);
-  } else {
-    sqlite3_bind_null(stmt, param_index++);
-  }
-  // Bind connection_type (for connections)
-  sqlite3_bind_int(stmt, param_index++, element->connection_type);
-  // Bind arrowhead_type (for connections)
-  sqlite3_bind_int(stmt, param_index++, element->arrowhead_type);
-  // Bind rotation_degrees
-  sqlite3_bind_double(stmt, param_index++, element->rotation_degrees);
-  // Bind description
-  if (element->description) {
-    sqlite3_bind_text(stmt, param_index++, element->description, -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, database_param(stmt, ":stroke_width"), element->stroke_width);
   } else {
-    sqlite3_bind_null(stmt, param_index++);
+    sqlite3_bind_null(stmt, database_param(stmt, ":stroke_width"));
   }
-  // Bind locked
-  sqlite3_bind_int(stmt, param_index++, element->locked ? 1 : 0);
+  sqlite3_bind_int(stmt, database_param(stmt, ":shape_type"), element->shape_type);
+  sqlite3_bind_int(stmt, database_param(stmt, ":filled"), element->filled ? 1 : 0);
+  sqlite3_bind_int(stmt, database_param(stmt, ":stroke_style"), element->stroke_style);
+  sqlite3_bind_int(stmt, database_param(stmt, ":fill_style"), element->fill_style);
+  database_bind_optional_text(stmt, ":stroke_color", element->stroke_color);
+
+  sqlite3_bind_double(stmt, database_param(stmt, ":rotation_degrees"), element->rotation_degrees);
+  database_bind_optional_text(stmt, ":description", element->description);
+  sqlite3_bind_int(stmt, database_param(stmt, ":locked"), element->locked ? 1 : 0);
 
   // Where clause
-  sqlite3_bind_text(stmt, param_index++, element_uuid, -1, SQLITE_STATIC);
+  sqlite3_bind_text(stmt, database_param(stmt, ":uuid"), element_uuid, -1, SQLITE_STATIC);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update element: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -1445,18 +1912,16 @@ int database_load_space(sqlite3 *db, Model *model) {
 
   // Use JOINs to load all data in one query - much faster for bulk loading
   const char *sql =
-    "SELECT e.uuid, e.type_id, e.position_id, e.size_id, e.text_id, e.bg_color_id, "
+    "SELECT e.uuid, e.type, e.position_id, e.size_id, e.text_id, e.bg_color_id, "
     "e.from_element_uuid, e.to_element_uuid, e.from_point, e.to_point, e.target_space_uuid, e.space_uuid, "
     "e.image_id, e.video_id, e.audio_id, "
     "e.drawing_points, e.stroke_width, e.shape_type, e.filled, e.stroke_style, e.fill_style, e.stroke_color, "
     "e.connection_type, e.arrowhead_type, e.rotation_degrees, e.description, e.created_at, e.locked, "
-    "t.type, t.ref_count, "
     "p.x, p.y, p.z, p.ref_count, "
     "s.width, s.height, s.ref_count, "
     "txt.text, txt.text_r, txt.text_g, txt.text_b, txt.text_a, txt.font_description, txt.strikethrough, txt.alignment, txt.ref_count, "
     "c.r, c.g, c.b, c.a, c.ref_count "
     "FROM elements e "
-    "LEFT JOIN element_type_refs t ON e.type_id = t.id "
     "LEFT JOIN position_refs p ON e.position_id = p.id "
     "LEFT JOIN size_refs s ON e.size_id = s.id "
     "LEFT JOIN text_refs txt ON e.text_id = txt.id "
@@ -1475,7 +1940,7 @@ int database_load_space(sqlite3 *db, Model *model) {
   // Define column indices for JOINed query
   enum {
     COL_UUID = 0,
-    COL_TYPE_ID,
+    COL_TYPE,
     COL_POSITION_ID,
     COL_SIZE_ID,
     COL_TEXT_ID,
@@ -1503,8 +1968,6 @@ int database_load_space(sqlite3 *db, Model *model) {
     COL_CREATED_AT,
     COL_LOCKED,
     // JOINed data starts here
-    COL_TYPE_TYPE,
-    COL_TYPE_REF_COUNT,
     COL_POS_X,
     COL_POS_Y,
     COL_POS_Z,
@@ -1529,27 +1992,23 @@ int database_load_space(sqlite3 *db, Model *model) {
   };
 
   while (sqlite3_step(stmt) == SQLITE_ROW) {
-    ModelElement *element = g_new0(ModelElement, 1);
+    ModelElement *element = model_slab_new0(&model->arena.elements, ModelElement);
+    element->arena = &model->arena;
 
     // Extract UUID
     const char *uuid = (const char*)sqlite3_column_text(stmt, COL_UUID);
-    element->uuid = g_strdup(uuid);
+    element->uuid = model_arena_strdup(&model->arena, uuid);
 
     // Set state to SAVED since we're loading from database
     element->state = MODEL_STATE_SAVED;
 
-    // Extract type directly from JOIN
-    int type_id = sqlite3_column_int(stmt, COL_TYPE_ID);
-    if (type_id > 0) {
-      ModelType *type = g_hash_table_lookup(model->types, GINT_TO_POINTER(type_id));
-      if (!type) {
-        type = g_new0(ModelType, 1);
-        type->id = type_id;
-        type->type = sqlite3_column_int(stmt, COL_TYPE_TYPE);
-        type->ref_count = sqlite3_column_int(stmt, COL_TYPE_REF_COUNT);
-        g_hash_table_insert(model->types, GINT_TO_POINTER(type_id), type);
-      }
-      element->type = type;
+    // Type is stored inline
+    int element_type = sqlite3_column_int(stmt, COL_TYPE);
+    element->type = model_type_get(element_type);
+    if (!element->type) {
+      fprintf(stderr, "Skipping element %s with invalid type %d\n", uuid, element_type);
+      model_element_free(element);
+      continue;
     }
 
     // Extract position directly from JOIN
@@ -1557,7 +2016,7 @@ int database_load_space(sqlite3 *db, Model *model) {
     if (position_id > 0) {
       ModelPosition *position = g_hash_table_lookup(model->positions, GINT_TO_POINTER(position_id));
       if (!position) {
-        position = g_new0(ModelPosition, 1);
+        position = model_slab_new0(&model->arena.positions, ModelPosition);
         position->id = position_id;
         position->x = sqlite3_column_int(stmt, COL_POS_X);
         position->y = sqlite3_column_int(stmt, COL_POS_Y);
@@ -1573,7 +2032,7 @@ int database_load_space(sqlite3 *db, Model *model) {
     if (size_id > 0) {
       ModelSize *size = g_hash_table_lookup(model->sizes, GINT_TO_POINTER(size_id));
       if (!size) {
-        size = g_new0(ModelSize, 1);
+        size = model_slab_new0(&model->arena.sizes, ModelSize);
         size->id = size_id;
         size->width = sqlite3_column_int(stmt, COL_SIZE_WIDTH);
         size->height = sqlite3_column_int(stmt, COL_SIZE_HEIGHT);
@@ -1588,19 +2047,19 @@ int database_load_space(sqlite3 *db, Model *model) {
     if (text_id > 0) {
       ModelText *text = g_hash_table_lookup(model->texts, GINT_TO_POINTER(text_id));
       if (!text) {
-        text = g_new0(ModelText, 1);
+        text = model_slab_new0(&model->arena.texts, ModelText);
         text->id = text_id;
         const char *text_str = (const char*)sqlite3_column_text(stmt, COL_TEXT_TEXT);
-        text->text = g_strdup(text_str ? text_str : "");
+        text->text = model_arena_strdup(&model->arena, text_str ? text_str : "");
         text->r = sqlite3_column_double(stmt, COL_TEXT_R);
         text->g = sqlite3_column_double(stmt, COL_TEXT_G);
         text->b = sqlite3_column_double(stmt, COL_TEXT_B);
         text->a = sqlite3_column_double(stmt, COL_TEXT_A);
         const char *font = (const char*)sqlite3_column_text(stmt, COL_TEXT_FONT);
-        text->font_description = g_strdup(font ? font : "Ubuntu Mono Bold 16");
+        text->font_description = model_arena_strdup(&model->arena, font ? font : "Ubuntu Mono Bold 16");
         text->strikethrough = sqlite3_column_int(stmt, COL_TEXT_STRIKE) ? TRUE : FALSE;
         const char *align = (const char*)sqlite3_column_text(stmt, COL_TEXT_ALIGN);
-        text->alignment = g_strdup(align ? align : "center");
+        text->alignment = model_arena_strdup(&model->arena, align ? align : "center");
         text->ref_count = sqlite3_column_int(stmt, COL_TEXT_REF_COUNT);
         g_hash_table_insert(model->texts, GINT_TO_POINTER(text_id), text);
       }
@@ -1612,7 +2071,7 @@ int database_load_space(sqlite3 *db, Model *model) {
     if (bg_color_id > 0) {
       ModelColor *color = g_hash_table_lookup(model->colors, GINT_TO_POINTER(bg_color_id));
       if (!color) {
-        color = g_new0(ModelColor, 1);
+        color = model_slab_new0(&model->arena.colors, ModelColor);
         color->id = bg_color_id;
         color->r = sqlite3_column_double(stmt, COL_COLOR_R);
         color->g = sqlite3_column_double(stmt, COL_COLOR_G);
@@ -1626,29 +2085,21 @@ int database_load_space(sqlite3 *db, Model *model) {
 
     // Extract connection data
     const char *from_uuid = (const char*)sqlite3_column_text(stmt, COL_FROM_ELEMENT_UUID);
-    if (from_uuid) {
-      element->from_element_uuid = g_strdup(from_uuid);
-    }
+    element->from_element_uuid = model_arena_strdup(&model->arena, from_uuid);
 
     const char *to_uuid = (const char*)sqlite3_column_text(stmt, COL_TO_ELEMENT_UUID);
-    if (to_uuid) {
-      element->to_element_uuid = g_strdup(to_uuid);
-    }
+    element->to_element_uuid = model_arena_strdup(&model->arena, to_uuid);
 
     element->from_point = sqlite3_column_int(stmt, COL_FROM_POINT);
     element->to_point = sqlite3_column_int(stmt, COL_TO_POINT);
 
     // Extract target space UUID
     const char *target_uuid = (const char*)sqlite3_column_text(stmt, COL_TARGET_SPACE_UUID);
-    if (target_uuid) {
-      element->target_space_uuid = g_strdup(target_uuid);
-    }
+    element->target_space_uuid = model_arena_strdup(&model->arena, target_uuid);
 
     // Extract space UUID
     const char *space_uuid = (const char*)sqlite3_column_text(stmt, COL_SPACE_UUID);
-    if (space_uuid) {
-      element->space_uuid = g_strdup(space_uuid);
-    }
+    element->space_uuid = model_arena_strdup(&model->arena, space_uuid);
 
     // Extract image (check if already loaded in model)
     int image_id = sqlite3_column_int(stmt, COL_IMAGE_ID);
@@ -1705,7 +2156,8 @@ int database_load_space(sqlite3 *db, Model *model) {
     int drawing_blob_size = sqlite3_column_bytes(stmt, COL_DRAWING_POINTS);
     if (drawing_blob && drawing_blob_size > 0) {
       int point_count = drawing_blob_size / sizeof(DrawingPoint);
-      element->drawing_points = g_array_sized_new(FALSE, FALSE, sizeof(DrawingPoint), point_count);
+      element->drawing_points = model_arena_adopt_array(&model->arena,
+                                                        g_array_sized_new(FALSE, FALSE, sizeof(DrawingPoint), point_count));
       g_array_append_vals(element->drawing_points, drawing_blob, point_count);
     }
     element->stroke_width = sqlite3_column_int(stmt, COL_STROKE_WIDTH);
@@ -1714,33 +2166,26 @@ int database_load_space(sqlite3 *db, Model *model) {
     element->stroke_style = sqlite3_column_int(stmt, COL_STROKE_STYLE);
     element->fill_style = sqlite3_column_int(stmt, COL_FILL_STYLE);
     const char *stroke_color = (const char*)sqlite3_column_text(stmt, COL_STROKE_COLOR);
-    if (stroke_color) {
-      element->stroke_color = g_strdup(stroke_color);
-    } else {
-      element->stroke_color = NULL;
-    }
+    element->stroke_color = model_arena_strdup(&model->arena, stroke_color);
     element->connection_type = sqlite3_column_int(stmt, COL_CONNECTION_TYPE);
     element->arrowhead_type = sqlite3_column_int(stmt, COL_ARROWHEAD_TYPE);
     element->rotation_degrees = sqlite3_column_double(stmt, COL_ROTATION_DEGREES);
 
     // Read description
     const char *description = (const char*)sqlite3_column_text(stmt, COL_DESCRIPTION);
-    if (description) {
-      element->description = g_strdup(description);
-    }
+    element->description = model_arena_strdup(&model->arena, description);
 
     // Read created_at
     const char *created_at = (const char*)sqlite3_column_text(stmt, COL_CREATED_AT);
-    if (created_at) {
-      element->created_at = g_strdup(created_at);
-    }
+    element->created_at = model_arena_strdup(&model->arena, created_at);
 
     // Read locked
     element->locked = sqlite3_column_int(stmt, COL_LOCKED) ? TRUE : FALSE;
 
     element->visual_element = NULL;
 
-    g_hash_table_insert(model->elements, g_strdup(uuid), element);
+    model_insert_element(model, element);
+    model_index_element(model, element);
   }
 
   sqlite3_finalize(stmt);
@@ -1759,7 +2204,8 @@ int database_get_space_name(sqlite3 *db, const char *space_uuid, char **space_na
   const char *sql = "SELECT name FROM spaces WHERE uuid = ? LIMIT 1";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_GET_SPACE_NAME, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -1769,11 +2215,11 @@ int database_get_space_name(sqlite3 *db, const char *space_uuid, char **space_na
   if (sqlite3_step(stmt) == SQLITE_ROW) {
     const char *name = (const char*)sqlite3_column_text(stmt, 0);
     *space_name = g_strdup(name);
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 0;
 }
 
@@ -1781,7 +2227,8 @@ int database_get_space_parent_id(sqlite3 *db, const char *space_uuid, char **spa
   const char *sql = "SELECT parent_uuid FROM spaces WHERE uuid = ? LIMIT 1";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_GET_SPACE_PARENT_ID, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -1795,11 +2242,11 @@ int database_get_space_parent_id(sqlite3 *db, const char *space_uuid, char **spa
     } else {
       *space_parent_id = NULL;
     }
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 0;
 }
 
@@ -1839,17 +2286,13 @@ int database_set_space_parent_id(sqlite3 *db, const char *space_uuid, const char
     }
 }
 
-// Recalculate all ref_counts from scratch based on actual element usage
-// This fixes any stale ref_counts from crashes or incomplete transactions
+// Recalculate all ref_counts from scratch based on actual element usage.
+// The elements triggers keep counts current; this is only needed to seed
+// them on databases that predate the triggers.
 int database_recalculate_ref_counts(sqlite3 *db) {
   char *err_msg = NULL;
 
   const char *sql =
-    // Recalculate element_type_refs
-    "UPDATE element_type_refs SET ref_count = ("
-    "  SELECT COUNT(*) FROM elements WHERE type_id = element_type_refs.id"
-    ");"
-
     // Recalculate position_refs
     "UPDATE position_refs SET ref_count = ("
     "  SELECT COUNT(*) FROM elements WHERE position_id = position_refs.id"
@@ -1894,44 +2337,43 @@ int database_recalculate_ref_counts(sqlite3 *db) {
   return 1;
 }
 
-// Remove references with ref_count < 1 from database and return total rows deleted
-int cleanup_database_references(sqlite3 *db) {
+int database_collect_orphaned_refs(sqlite3 *db, int limit) {
   int total_deleted = 0;
-  char *err_msg = NULL;
 
-  // Note: This function is called from within an existing transaction
-  // (from model_save_elements), so we don't start our own transaction
-
-  const char *tables[] = {
-    "element_type_refs",
-    "position_refs",
-    "size_refs",
-    "image_refs",
-    "video_refs",
-    "audio_refs",
-    "text_refs",
-    "color_refs",
-    NULL
-  };
-
-  for (int i = 0; tables[i] != NULL; i++) {
-    // Build the SQL statement dynamically
-    char sql[256];
-    snprintf(sql, sizeof(sql), "DELETE FROM %s WHERE ref_count < 1", tables[i]);
-
-    if (sqlite3_exec(db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
-      fprintf(stderr, "Failed to cleanup %s: %s\n", tables[i], err_msg);
-      sqlite3_free(err_msg);
-      err_msg = NULL;
+  for (guint i = 0; i < G_N_ELEMENTS(database_ref_tables); i++) {
+    DatabaseStatementId id = DATABASE_STMT_COLLECT_ORPHANED_REFS + i;
+    sqlite3_stmt *stmt = database_statement(db, id, NULL);
+    if (!stmt) {
+      // The subquery is answered from the partial orphan index
+      char *sql = g_strdup_printf(
+        "DELETE FROM %s WHERE id IN (SELECT id FROM %s WHERE ref_count < 1 LIMIT ?)",
+        database_ref_tables[i].table, database_ref_tables[i].table);
+      stmt = database_statement(db, id, sql);
+      g_free(sql);
+    }
+    if (!stmt) {
+      fprintf(stderr, "Failed to prepare cleanup of %s: %s\n", database_ref_tables[i].table, sqlite3_errmsg(db));
       continue; // Continue with other tables
     }
 
-    total_deleted += sqlite3_changes(db);
+    sqlite3_bind_int(stmt, 1, limit);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      fprintf(stderr, "Failed to cleanup %s: %s\n", database_ref_tables[i].table, sqlite3_errmsg(db));
+    } else {
+      total_deleted += sqlite3_changes(db);
+    }
+    database_statement_release(stmt);
   }
 
   return total_deleted;
 }
 
+// Remove references with ref_count < 1 from database and return total rows deleted
+int cleanup_database_references(sqlite3 *db) {
+  // A negative LIMIT is no limit
+  return database_collect_orphaned_refs(db, -1);
+}
+
 int database_delete_element(sqlite3 *db, const char *element_uuid) {
   if (!element_uuid || !database_is_valid_uuid(element_uuid)) {
     fprintf(stderr, "Error: Invalid element UUID in database_delete_element\n");
@@ -1941,7 +2383,8 @@ int database_delete_element(sqlite3 *db, const char *element_uuid) {
   const char *sql = "DELETE FROM elements WHERE uuid = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_DELETE_ELEMENT, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare delete statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -1950,39 +2393,11 @@ int database_delete_element(sqlite3 *db, const char *element_uuid) {
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to delete element: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
-  return 1;
-}
-
-int database_update_type_ref(sqlite3 *db, ModelType *type) {
-  if (type->id <= 0) {
-    fprintf(stderr, "Error: Invalid type_id (%d) in database_update_type_ref\n", type->id);
-    return 0;
-  }
-
-  const char *sql = "UPDATE element_type_refs SET type = ?, ref_count = ? WHERE id = ?";
-  sqlite3_stmt *stmt;
-
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-    fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
-    return 0;
-  }
-
-  sqlite3_bind_int(stmt, 1, type->type);
-  sqlite3_bind_int(stmt, 2, type->ref_count);
-  sqlite3_bind_int(stmt, 3, type->id);
-
-  if (sqlite3_step(stmt) != SQLITE_DONE) {
-    fprintf(stderr, "Failed to update type: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
-    return 0;
-  }
-
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -1992,10 +2407,11 @@ int database_update_position_ref(sqlite3 *db, ModelPosition *position) {
     return 0;
   }
 
-  const char *sql = "UPDATE position_refs SET x = ?, y = ?, z = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE position_refs SET x = ?, y = ?, z = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_POSITION_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2003,16 +2419,15 @@ int database_update_position_ref(sqlite3 *db, ModelPosition *position) {
   sqlite3_bind_int(stmt, 1, position->x);
   sqlite3_bind_int(stmt, 2, position->y);
   sqlite3_bind_int(stmt, 3, position->z);
-  sqlite3_bind_int(stmt, 4, position->ref_count);
-  sqlite3_bind_int(stmt, 5, position->id);
+  sqlite3_bind_int(stmt, 4, position->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update position: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2022,26 +2437,26 @@ int database_update_size_ref(sqlite3 *db, ModelSize *size) {
     return 0;
   }
 
-  const char *sql = "UPDATE size_refs SET width = ?, height = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE size_refs SET width = ?, height = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_SIZE_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
 
   sqlite3_bind_int(stmt, 1, size->width);
   sqlite3_bind_int(stmt, 2, size->height);
-  sqlite3_bind_int(stmt, 3, size->ref_count);
-  sqlite3_bind_int(stmt, 4, size->id);
+  sqlite3_bind_int(stmt, 3, size->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update size: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2051,10 +2466,11 @@ int database_update_text_ref(sqlite3 *db, ModelText *text) {
     return 0;
   }
 
-  const char *sql = "UPDATE text_refs SET text = ?, text_r = ?, text_g = ?, text_b = ?, text_a = ?, font_description = ?, strikethrough = ?, alignment = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE text_refs SET text = ?, text_r = ?, text_g = ?, text_b = ?, text_a = ?, font_description = ?, strikethrough = ?, alignment = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_TEXT_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2067,16 +2483,15 @@ int database_update_text_ref(sqlite3 *db, ModelText *text) {
   sqlite3_bind_text(stmt, 6, text->font_description, -1, SQLITE_STATIC);
   sqlite3_bind_int(stmt, 7, text->strikethrough ? 1 : 0);
   sqlite3_bind_text(stmt, 8, text->alignment, -1, SQLITE_STATIC);
-  sqlite3_bind_int(stmt, 9, text->ref_count);
-  sqlite3_bind_int(stmt, 10, text->id);
+  sqlite3_bind_int(stmt, 9, text->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update text: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2086,10 +2501,11 @@ int database_update_color_ref(sqlite3 *db, ModelColor *color) {
     return 0;
   }
 
-  const char *sql = "UPDATE color_refs SET r = ?, g = ?, b = ?, a = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE color_refs SET r = ?, g = ?, b = ?, a = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_COLOR_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2098,16 +2514,15 @@ int database_update_color_ref(sqlite3 *db, ModelColor *color) {
   sqlite3_bind_double(stmt, 2, color->g);
   sqlite3_bind_double(stmt, 3, color->b);
   sqlite3_bind_double(stmt, 4, color->a);
-  sqlite3_bind_int(stmt, 5, color->ref_count);
-  sqlite3_bind_int(stmt, 6, color->id);
+  sqlite3_bind_int(stmt, 5, color->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update color: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2120,7 +2535,8 @@ int database_get_amount_of_elements(sqlite3 *db, const char *space_uuid) {
   const char *sql = "SELECT COUNT(*) FROM elements WHERE space_uuid = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_GET_AMOUNT_OF_ELEMENTS, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2132,7 +2548,7 @@ int database_get_amount_of_elements(sqlite3 *db, const char *space_uuid) {
     count = sqlite3_column_int(stmt, 0);
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return count;
 }
 
@@ -2164,10 +2580,11 @@ int database_delete_space(sqlite3 *db, const char *space_uuid) {
 
 // Image reference operations
 int database_create_image_ref(sqlite3 *db, const unsigned char *image_data, int image_size, int *image_id) {
-  const char *sql = "INSERT INTO image_refs (image_data, image_size) VALUES (?, ?)";
+  const char *sql = "INSERT INTO image_refs (image_data, image_size, ref_count) VALUES (?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_IMAGE_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2177,12 +2594,12 @@ int database_create_image_ref(sqlite3 *db, const unsigned char *image_data, int
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create image: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *image_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2198,7 +2615,8 @@ int database_read_image_ref(sqlite3 *db, int image_id, ModelImage **image) {
   const char *sql = "SELECT image_data, image_size, ref_count FROM image_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_IMAGE_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0; // Error
   }
@@ -2222,11 +2640,11 @@ int database_read_image_ref(sqlite3 *db, int image_id, ModelImage **image) {
     model_image->ref_count = sqlite3_column_int(stmt, 2);
 
     *image = model_image;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1; // Success
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   // Image not found, but this is not an error - *image remains NULL
   return 1; // Success (no error occurred)
 }
@@ -2237,26 +2655,26 @@ int database_update_image_ref(sqlite3 *db, ModelImage *image) {
     return 0;
   }
 
-  const char *sql = "UPDATE image_refs SET image_data = ?, image_size = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE image_refs SET image_data = ?, image_size = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_IMAGE_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
 
   sqlite3_bind_blob(stmt, 1, image->image_data, image->image_size, SQLITE_STATIC);
   sqlite3_bind_int(stmt, 2, image->image_size);
-  sqlite3_bind_int(stmt, 3, image->ref_count);
-  sqlite3_bind_int(stmt, 4, image->id);
+  sqlite3_bind_int(stmt, 3, image->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update image: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2380,10 +2798,11 @@ int database_create_video_ref(sqlite3 *db,
                              const unsigned char *thumbnail_data, int thumbnail_size,
                              const unsigned char *video_data, int video_size,
                              int duration, int *video_id) {
-  const char *sql = "INSERT INTO video_refs (thumbnail_data, thumbnail_size, video_data, video_size, duration) VALUES (?, ?, ?, ?, ?)";
+  const char *sql = "INSERT INTO video_refs (thumbnail_data, thumbnail_size, video_data, video_size, duration, ref_count) VALUES (?, ?, ?, ?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_VIDEO_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2397,12 +2816,12 @@ int database_create_video_ref(sqlite3 *db,
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create video: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *video_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2418,7 +2837,8 @@ int database_read_video_ref(sqlite3 *db, int video_id, ModelVideo **video) {
   const char *sql = "SELECT thumbnail_data, thumbnail_size, video_size, duration, ref_count FROM video_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_VIDEO_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2448,11 +2868,11 @@ int database_read_video_ref(sqlite3 *db, int video_id, ModelVideo **video) {
     model_video->video_data = NULL;  // Video data will be loaded on demand
 
     *video = model_video;
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2462,10 +2882,11 @@ int database_update_video_ref(sqlite3 *db, ModelVideo *video) {
     return 0;
   }
 
-  const char *sql = "UPDATE video_refs SET thumbnail_data = ?, thumbnail_size = ?, video_size = ?, duration = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE video_refs SET thumbnail_data = ?, thumbnail_size = ?, video_size = ?, duration = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_VIDEO_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2475,26 +2896,26 @@ int database_update_video_ref(sqlite3 *db, ModelVideo *video) {
   sqlite3_bind_int(stmt, param_index++, video->thumbnail_size);
   sqlite3_bind_int(stmt, param_index++, video->video_size);
   sqlite3_bind_int(stmt, param_index++, video->duration);
-  sqlite3_bind_int(stmt, param_index++, video->ref_count);
   sqlite3_bind_int(stmt, param_index++, video->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update video: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
 int database_create_audio_ref(sqlite3 *db,
                              const unsigned char *audio_data, int audio_size,
                              int duration, int *audio_id) {
-  const char *sql = "INSERT INTO audio_refs (audio_data, audio_size, duration) VALUES (?, ?, ?)";
+  const char *sql = "INSERT INTO audio_refs (audio_data, audio_size, duration, ref_count) VALUES (?, ?, ?, 0)";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_CREATE_AUDIO_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2506,12 +2927,12 @@ int database_create_audio_ref(sqlite3 *db,
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to create audio: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
   *audio_id = sqlite3_last_insert_rowid(db);
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
@@ -2524,7 +2945,8 @@ int database_read_audio_ref(sqlite3 *db, int audio_id, ModelAudio **audio) {
   const char *sql = "SELECT id, audio_size, duration, ref_count FROM audio_refs WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_READ_AUDIO_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2540,11 +2962,11 @@ int database_read_audio_ref(sqlite3 *db, int audio_id, ModelAudio **audio) {
     (*audio)->audio_data = NULL;  // Audio data not loaded yet
     (*audio)->is_loaded = FALSE;
 
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 1;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 0;
 }
 
@@ -2554,10 +2976,11 @@ int database_update_audio_ref(sqlite3 *db, ModelAudio *audio) {
     return 0;
   }
 
-  const char *sql = "UPDATE audio_refs SET audio_size = ?, duration = ?, ref_count = ? WHERE id = ?";
+  const char *sql = "UPDATE audio_refs SET audio_size = ?, duration = ? WHERE id = ?";
   sqlite3_stmt *stmt;
 
-  if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+  stmt = database_statement(db, DATABASE_STMT_UPDATE_AUDIO_REF, sql);
+  if (!stmt) {
     fprintf(stderr, "Failed to prepare statement: %s\n", sqlite3_errmsg(db));
     return 0;
   }
@@ -2565,16 +2988,15 @@ int database_update_audio_ref(sqlite3 *db, ModelAudio *audio) {
   int param_index = 1;
   sqlite3_bind_int(stmt, param_index++, audio->audio_size);
   sqlite3_bind_int(stmt, param_index++, audio->duration);
-  sqlite3_bind_int(stmt, param_index++, audio->ref_count);
   sqlite3_bind_int(stmt, param_index++, audio->id);
 
   if (sqlite3_step(stmt) != SQLITE_DONE) {
     fprintf(stderr, "Failed to update audio: %s\n", sqlite3_errmsg(db));
-    sqlite3_finalize(stmt);
+    database_statement_release(stmt);
     return 0;
   }
 
-  sqlite3_finalize(stmt);
+  database_statement_release(stmt);
   return 1;
 }
 
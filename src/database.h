@@ -9,6 +9,25 @@
 // Initialize database
 int database_init(sqlite3 **db, const char *filename);
 void database_close(sqlite3 *db);
+
+// Open a read-only connection to the same file for space loads, search and
+// space tree queries. Under WAL it reads the last commit without waiting
+// for the writer and may be used from another thread. Returns 0 when the
+// database cannot be shared, e.g. in-memory ones.
+int database_open_reader(sqlite3 *db, sqlite3 **reader);
+
+// Run WAL checkpoints on a background thread with its own connection
+// instead of inside the commit that crosses the threshold. NULL when the
+// database cannot be shared; SQLite then keeps checkpointing itself.
+DatabaseCheckpointer* database_checkpointer_new(sqlite3 *writer);
+void database_checkpointer_free(DatabaseCheckpointer *checkpointer);
+
+// Delete orphaned ref rows on a background thread with its own connection,
+// in small transactions, a moment after the last request. NULL when the
+// database cannot be shared.
+DatabaseRefCollector* database_ref_collector_new(sqlite3 *writer);
+void database_ref_collector_request(DatabaseRefCollector *collector);
+void database_ref_collector_free(DatabaseRefCollector *collector);
 int database_create_tables(sqlite3 *db);
 int database_init_default_namespace(sqlite3 *db);
 
@@ -21,11 +40,6 @@ int database_rollback_transaction(sqlite3 *db);
 void database_generate_uuid(char **uuid_str);
 int database_is_valid_uuid(const char *uuid_str);
 
-// Type reference operations
-int database_create_type_ref(sqlite3 *db, ElementType element_type, int *type_id);
-int database_read_type_ref(sqlite3 *db, int type_id, ModelType **type);
-int database_update_type_ref(sqlite3 *db, ModelType *type);
-
 // Position reference operations
 int database_create_position_ref(sqlite3 *db, int x, int y, int z, int *position_id);
 int database_read_position_ref(sqlite3 *db, int position_id, ModelPosition **position);
@@ -57,7 +71,11 @@ int database_create_image_ref(sqlite3 *db, const unsigned char *image_data, int
 int database_read_image_ref(sqlite3 *db, int image_id, ModelImage **image);
 int database_update_image_ref(sqlite3 *db, ModelImage *image);
 
+// Ref counts are kept by triggers on elements. Orphaned refs (count below
+// 1) stay until collected: cleanup removes all of them, collect removes at
+// most limit rows per ref table so it can run in small background steps.
 int cleanup_database_references(sqlite3 *db);
+int database_collect_orphaned_refs(sqlite3 *db, int limit);
 int database_recalculate_ref_counts(sqlite3 *db);
 
 // Video reference operations
@@ -0,0 +1,116 @@
+#include "display_list.h"
+
+// First index whose z is greater than or equal to z
+static guint display_list_lower_bound(DisplayList *list, int z) {
+    guint lo = 0;
+    guint hi = list->entries->len;
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+        if (g_array_index(list->entries, DisplayListEntry, mid).z < z) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// First index whose z is strictly greater than z
+static guint display_list_upper_bound(DisplayList *list, int z) {
+    guint lo = 0;
+    guint hi = list->entries->len;
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+        if (g_array_index(list->entries, DisplayListEntry, mid).z <= z) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static gboolean display_list_find_in_run(DisplayList *list, Element *element, int z, guint *index) {
+    guint len = list->entries->len;
+    for (guint i = display_list_lower_bound(list, z); i < len; i++) {
+        DisplayListEntry *entry = &g_array_index(list->entries, DisplayListEntry, i);
+        if (entry->z != z) break;
+        if (entry->element == element) {
+            *index = i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Locate an element using its sort key as a hint; falls back to a linear scan
+// if the element was re-ordered without the list being told.
+static gboolean display_list_find(DisplayList *list, Element *element, int z_hint, guint *index) {
+    if (display_list_find_in_run(list, element, z_hint, index)) {
+        return TRUE;
+    }
+
+    for (guint i = 0; i < list->entries->len; i++) {
+        if (g_array_index(list->entries, DisplayListEntry, i).element == element) {
+            *index = i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+DisplayList* display_list_new(void) {
+    DisplayList *list = g_new0(DisplayList, 1);
+    list->entries = g_array_new(FALSE, FALSE, sizeof(DisplayListEntry));
+    return list;
+}
+
+void display_list_free(DisplayList *list) {
+    if (!list) return;
+    g_array_free(list->entries, TRUE);
+    g_free(list);
+}
+
+void display_list_insert(DisplayList *list, Element *element) {
+    if (!list || !element) return;
+
+    // Insert after existing entries with the same z so creation order is kept
+    DisplayListEntry entry = { .element = element, .z = element->z };
+    guint index = display_list_upper_bound(list, element->z);
+    g_array_insert_val(list->entries, index, entry);
+}
+
+gboolean display_list_remove(DisplayList *list, Element *element) {
+    if (!list || !element) return FALSE;
+
+    guint index;
+    if (!display_list_find(list, element, element->z, &index)) {
+        return FALSE;
+    }
+    g_array_remove_index(list->entries, index);
+    return TRUE;
+}
+
+void display_list_update_z(DisplayList *list, Element *element, int old_z) {
+    if (!list || !element) return;
+
+    guint index;
+    if (!display_list_find(list, element, old_z, &index)) {
+        return;
+    }
+
+    // Bring-to-front lands on the tail, so this is usually a cheap append
+    g_array_remove_index(list->entries, index);
+    display_list_insert(list, element);
+}
+
+gboolean display_list_contains(DisplayList *list, Element *element) {
+    if (!list || !element) return FALSE;
+    guint index;
+    return display_list_find_in_run(list, element, element->z, &index);
+}
+
+void display_list_clear(DisplayList *list) {
+    if (!list) return;
+    g_array_set_size(list->entries, 0);
+}
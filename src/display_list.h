@@ -0,0 +1,38 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <glib.h>
+#include "elements/element.h"
+
+// Retained render list for the current space, kept sorted by z-index so the
+// draw loop can walk a contiguous array instead of re-sorting every frame.
+typedef struct {
+    Element *element;
+    int z;  // z the entry was sorted with (element->z may change before the update call)
+} DisplayListEntry;
+
+typedef struct {
+    GArray *entries;  // Array of DisplayListEntry, ascending z
+} DisplayList;
+
+// Create/destroy
+DisplayList* display_list_new(void);
+void display_list_free(DisplayList *list);
+
+// Operations
+void display_list_insert(DisplayList *list, Element *element);
+gboolean display_list_remove(DisplayList *list, Element *element);
+// Re-position an element after its z-index changed (element->z holds the new value)
+void display_list_update_z(DisplayList *list, Element *element, int old_z);
+gboolean display_list_contains(DisplayList *list, Element *element);
+void display_list_clear(DisplayList *list);
+
+static inline guint display_list_length(DisplayList *list) {
+    return list ? list->entries->len : 0;
+}
+
+static inline Element* display_list_get(DisplayList *list, guint index) {
+    return g_array_index(list->entries, DisplayListEntry, index).element;
+}
+
+#endif
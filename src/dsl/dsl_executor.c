@@ -36,7 +36,8 @@ static void element_map_register(CanvasData *data, GHashTable *element_map, cons
 
   if (data && data->dsl_aliases && element->uuid && *element->uuid &&
       alias && *alias && g_strcmp0(alias, element->uuid) != 0) {
-    g_hash_table_insert(data->dsl_aliases, g_strdup(alias), g_strdup(element->uuid));
+    g_hash_table_insert(data->dsl_aliases, g_strdup(alias),
+                        UUID_HANDLE_TO_POINTER(model_element_handle(element)));
   }
 }
 
@@ -203,15 +204,12 @@ void canvas_execute_script_internal(CanvasData *data, const gchar *script, const
   GHashTable *element_map = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
   if (data && data->model && data->model->elements) {
     GHashTableIter existing_iter;
-    gpointer existing_key;
     gpointer existing_value;
     g_hash_table_iter_init(&existing_iter, data->model->elements);
-    while (g_hash_table_iter_next(&existing_iter, &existing_key, &existing_value)) {
-      if (existing_key && existing_value) {
-        element_map_register(data,
-                             element_map,
-                             (const gchar *)existing_key,
-                             (ModelElement *)existing_value);
+    while (g_hash_table_iter_next(&existing_iter, NULL, &existing_value)) {
+      ModelElement *existing = existing_value;
+      if (existing && existing->uuid) {
+        element_map_register(data, element_map, existing->uuid, existing);
       }
     }
   }
@@ -223,11 +221,10 @@ void canvas_execute_script_internal(CanvasData *data, const gchar *script, const
     g_hash_table_iter_init(&alias_iter, data->dsl_aliases);
     while (g_hash_table_iter_next(&alias_iter, &alias_key, &alias_value)) {
       const gchar *alias = alias_key;
-      const gchar *uuid = alias_value;
-      if (!alias || !uuid) {
+      if (!alias) {
         continue;
       }
-      ModelElement *alias_element = g_hash_table_lookup(data->model->elements, uuid);
+      ModelElement *alias_element = model_get_element(data->model, UUID_POINTER_TO_HANDLE(alias_value));
       if (alias_element) {
         dsl_runtime_register_element(data, alias, alias_element);
         g_hash_table_insert(element_map, g_strdup(alias), alias_element);
@@ -3525,29 +3522,28 @@ static void canvas_clear_space_for_presentation(CanvasData *data) {
   const gchar *current_space_uuid = data->model->current_space_uuid;
   if (!current_space_uuid) return;
 
-  // Collect UUIDs of all elements in current space
+  // Collect handles of all elements in current space
   GList *all_elements = g_hash_table_get_values(data->model->elements);
-  GList *uuids_to_remove = NULL;
+  GList *handles_to_remove = NULL;
   for (GList *l = all_elements; l != NULL; l = l->next) {
     ModelElement *element = (ModelElement *)l->data;
     if (element && element->space_uuid &&
         g_strcmp0(element->space_uuid, current_space_uuid) == 0 &&
         element->uuid) {
-      uuids_to_remove = g_list_prepend(uuids_to_remove, g_strdup(element->uuid));
+      handles_to_remove = g_list_prepend(handles_to_remove,
+                                         UUID_HANDLE_TO_POINTER(model_element_handle(element)));
     }
   }
   g_list_free(all_elements);
 
-  for (GList *l = uuids_to_remove; l != NULL; l = l->next) {
-    gchar *uuid = (gchar *)l->data;
-    ModelElement *element = g_hash_table_lookup(data->model->elements, uuid);
+  for (GList *l = handles_to_remove; l != NULL; l = l->next) {
+    ModelElement *element = model_get_element(data->model, UUID_POINTER_TO_HANDLE(l->data));
     if (element) {
       model_delete_element(data->model, element);
-      g_hash_table_remove(data->model->elements, uuid);
+      g_hash_table_remove(data->model->elements, l->data);
     }
-    g_free(uuid);
   }
-  g_list_free(uuids_to_remove);
+  g_list_free(handles_to_remove);
 
   // Clear visual selection
   canvas_clear_selection(data);
@@ -3683,7 +3679,7 @@ gchar* canvas_generate_dsl_from_model(CanvasData *data) {
   }
 
   GString *dsl = g_string_new(NULL);
-  GHashTable *element_id_map = g_hash_table_new(g_str_hash, g_str_equal);
+  GHashTable *element_id_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
   GHashTable *used_ids = g_hash_table_new(g_str_hash, g_str_equal);
   int element_counter = 1;
 
@@ -3711,7 +3707,7 @@ gchar* canvas_generate_dsl_from_model(CanvasData *data) {
       gpointer alias_key, alias_value;
       g_hash_table_iter_init(&alias_iter, data->dsl_aliases);
       while (g_hash_table_iter_next(&alias_iter, &alias_key, &alias_value)) {
-        if (g_strcmp0((const gchar*)alias_value, element->uuid) == 0) {
+        if (UUID_POINTER_TO_HANDLE(alias_value) == model_element_handle(element)) {
           element_id = g_strdup((const gchar*)alias_key);
           break;
         }
@@ -3777,7 +3773,8 @@ gchar* canvas_generate_dsl_from_model(CanvasData *data) {
     g_hash_table_insert(used_ids, g_strdup(element_id), GINT_TO_POINTER(1));
 
     // Store the mapping from UUID to generated ID
-    g_hash_table_insert(element_id_map, g_strdup(element->uuid), g_strdup(element_id));
+    g_hash_table_insert(element_id_map, UUID_HANDLE_TO_POINTER(model_element_handle(element)),
+                        g_strdup(element_id));
 
     // Generate DSL line based on element type
     if (element->type->type == ELEMENT_NOTE || element->type->type == ELEMENT_PAPER_NOTE) {
@@ -4085,8 +4082,8 @@ gchar* canvas_generate_dsl_from_model(CanvasData *data) {
     }
 
     if (element->from_element_uuid && element->to_element_uuid) {
-      gchar *from_id = g_hash_table_lookup(element_id_map, element->from_element_uuid);
-      gchar *to_id = g_hash_table_lookup(element_id_map, element->to_element_uuid);
+      gchar *from_id = g_hash_table_lookup(element_id_map, UUID_HANDLE_TO_POINTER(model_connection_from(element)));
+      gchar *to_id = g_hash_table_lookup(element_id_map, UUID_HANDLE_TO_POINTER(model_connection_to(element)));
 
       if (from_id && to_id) {
         // Convert connection type enum to string
@@ -4139,24 +4136,20 @@ gchar* canvas_generate_dsl_from_model(CanvasData *data) {
     // Clear existing aliases
     g_hash_table_remove_all(data->dsl_aliases);
 
-    // Copy element_id_map to dsl_aliases (alias -> uuid)
+    // Copy element_id_map to dsl_aliases (alias -> handle)
     g_hash_table_iter_init(&id_iter, element_id_map);
     while (g_hash_table_iter_next(&id_iter, &id_key, &id_value)) {
-      const gchar *uuid = id_key;
+      char uuid_buffer[UUID_STRING_LENGTH];
+      const gchar *uuid = uuid_intern_string(UUID_POINTER_TO_HANDLE(id_key), uuid_buffer);
       const gchar *alias = id_value;
       // Only add if alias is different from UUID
       if (g_strcmp0(alias, uuid) != 0) {
-        g_hash_table_insert(data->dsl_aliases, g_strdup(alias), g_strdup(uuid));
+        g_hash_table_insert(data->dsl_aliases, g_strdup(alias), id_key);
       }
     }
   }
 
-  // Clean up element_id_map
-  g_hash_table_iter_init(&id_iter, element_id_map);
-  while (g_hash_table_iter_next(&id_iter, &id_key, &id_value)) {
-    g_free(id_key);    // Free the UUID key
-    g_free(id_value);  // Free the generated ID value
-  }
+  // Frees the generated IDs
   g_hash_table_destroy(element_id_map);
 
   // Clean up used_ids hash table
@@ -1054,7 +1054,8 @@ void dsl_runtime_register_element(CanvasData *data, const gchar *id, ModelElemen
 
   if (data && data->dsl_aliases && element->uuid && *element->uuid &&
       g_strcmp0(id, element->uuid) != 0) {
-    g_hash_table_insert(data->dsl_aliases, g_strdup(id), g_strdup(element->uuid));
+    g_hash_table_insert(data->dsl_aliases, g_strdup(id),
+                        UUID_HANDLE_TO_POINTER(model_element_handle(element)));
   }
 }
 
@@ -1256,6 +1257,7 @@ void dsl_runtime_text_update(CanvasData *data, ModelElement *model_element, cons
         if (g_strcmp0(shape->text, new_text) != 0) {
           g_free(shape->text);
           shape->text = g_strdup(new_text);
+          element_invalidate(element);
           element_changed = TRUE;
           if (data && data->drawing_area) {
             gtk_widget_queue_draw(data->drawing_area);
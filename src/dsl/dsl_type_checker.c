@@ -874,11 +874,12 @@ gboolean dsl_type_check_script(CanvasData *data,
 
   if (data && data->model && data->model->elements) {
     GHashTableIter iter;
-    gpointer key, value;
+    gpointer value;
     g_hash_table_iter_init(&iter, data->model->elements);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-      if (key) {
-        g_hash_table_insert(ctx.elements, g_strdup((const gchar *)key), GINT_TO_POINTER(1));
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+      ModelElement *element = value;
+      if (element && element->uuid) {
+        g_hash_table_insert(ctx.elements, g_strdup(element->uuid), GINT_TO_POINTER(1));
       }
     }
   }
@@ -1,16 +1,93 @@
 #include "element.h"
 #include "paper_note.h"
 #include "note.h"
+#include "shape.h"
+#include "freehand_drawing.h"
 #include "../model.h"
 #include "../canvas/canvas.h"
 #include "../canvas/canvas_core.h"
 
 void element_draw(Element *element, cairo_t *cr, gboolean is_selected) {
+  if (element && element->vtable && element->vtable->draw_lod) {
+    ElementLod lod = element_get_lod(element);
+    if (lod != ELEMENT_LOD_FULL) {
+      element->vtable->draw_lod(element, cr, is_selected, lod);
+      return;
+    }
+  }
   if (element && element->vtable && element->vtable->draw) {
     element->vtable->draw(element, cr, is_selected);
   }
 }
 
+ElementLod element_get_lod(Element *element) {
+  CanvasData *data = element ? element->canvas_data : NULL;
+  if (!data || data->zoom_scale >= data->lod_settings.detail_zoom) {
+    return ELEMENT_LOD_FULL;
+  }
+
+  double screen_size = MAX(element->width, element->height) * data->zoom_scale;
+  if (screen_size < data->lod_settings.block_pixels) {
+    return ELEMENT_LOD_BLOCK;
+  }
+  return ELEMENT_LOD_SIMPLE;
+}
+
+gboolean element_text_is_legible(Element *element, const char *text, const char *font_description) {
+  if (!text || !*text) return FALSE;
+
+  CanvasData *data = element->canvas_data;
+  if (!data || !font_description) return TRUE;
+
+  // Parsed once per font change rather than every zoomed-out frame
+  if (g_strcmp0(element->legible_font, font_description) != 0) {
+    PangoFontDescription *font_desc = pango_font_description_from_string(font_description);
+    double size = pango_font_description_get_size(font_desc) / (double)PANGO_SCALE;
+    if (!pango_font_description_get_size_is_absolute(font_desc)) {
+      size *= 96.0 / 72.0;  // Points to pixels at the default PangoCairo resolution
+    }
+    pango_font_description_free(font_desc);
+
+    g_free(element->legible_font);
+    element->legible_font = g_strdup(font_description);
+    element->legible_font_pixels = size;
+  }
+
+  return element->legible_font_pixels * data->zoom_scale >= data->lod_settings.min_text_pixels;
+}
+
+// Flat stand-in used by the LOD renderers: a single rectangle in the element's frame
+void element_draw_lod_rect(Element *element, cairo_t *cr, gboolean is_selected,
+                           double r, double g, double b, double a, gboolean filled) {
+  double zoom = element->canvas_data ? element->canvas_data->zoom_scale : 1.0;
+
+  cairo_save(cr);
+  if (element->rotation_degrees != 0.0) {
+    double center_x = element->x + element->width / 2.0;
+    double center_y = element->y + element->height / 2.0;
+    cairo_translate(cr, center_x, center_y);
+    cairo_rotate(cr, element->rotation_degrees * M_PI / 180.0);
+    cairo_translate(cr, -center_x, -center_y);
+  }
+
+  cairo_rectangle(cr, element->x, element->y, element->width, element->height);
+  cairo_set_source_rgba(cr, r, g, b, a);
+  if (filled) {
+    cairo_fill_preserve(cr);
+  } else {
+    cairo_set_line_width(cr, 1.0 / zoom);
+    cairo_stroke_preserve(cr);
+  }
+
+  if (is_selected) {
+    cairo_set_source_rgba(cr, 0.3, 0.3, 0.8, 0.8);
+    cairo_set_line_width(cr, 2.0 / zoom);
+    cairo_stroke_preserve(cr);
+  }
+  cairo_new_path(cr);
+  cairo_restore(cr);
+}
+
 void element_get_connection_point(Element *element, int point, int *cx, int *cy) {
   if (element && element->vtable && element->vtable->get_connection_point) {
     element->vtable->get_connection_point(element, point, cx, cy);
@@ -42,9 +119,13 @@ void element_update_position(Element *element, int x, int y, int z) {
   ModelElement* model_element = model_get_by_visual(model, element);
   model_update_position(model, model_element, x, y, z);
 
+  int old_z = element->z;
   element->x = x;
   element->y = y;
   element->z = z;
+  if (old_z != z) {
+    display_list_update_z(element->canvas_data->display_list, element, old_z);
+  }
   if (element && element->vtable && element->vtable->update_position) {
     element->vtable->update_position(element, x, y, z);
   }
@@ -63,14 +144,162 @@ void element_update_size(Element *element, int width, int height) {
   }
 }
 
+static void element_clear_legible_font(Element *element) {
+  g_clear_pointer(&element->legible_font, g_free);
+}
+
 void element_free(Element *element) {
+  element_clear_text_layout(element);
+  if (element) element_clear_legible_font(element);
   if (element && element->vtable && element->vtable->free) {
     element->vtable->free(element);
   }
 }
 
+// Global so a new element allocated at a recycled address never matches a stale tile
+static guint element_render_generation = 0;
+
+void element_invalidate(Element *element) {
+  if (!element) return;
+  element->render_generation = ++element_render_generation;
+  element_clear_text_layout(element);
+  element_clear_legible_font(element);
+}
+
+// Antialiased edges bleed about a pixel past the geometry
+#define ELEMENT_ANTIALIAS_MARGIN 1.0
+// Rough shape outlines wander this far off the ideal path
+#define ELEMENT_ROUGH_STROKE_MARGIN 3.0
+
+double element_get_draw_margin(Element *element) {
+  if (!element) return 0.0;
+
+  switch (element->type) {
+    case ELEMENT_SHAPE: {
+      Shape *shape = (Shape*)element;
+      double margin = shape->stroke_width / 2.0 + ELEMENT_ROUGH_STROKE_MARGIN;
+      if (shape->shape_type == SHAPE_TEXT_OUTLINE) {
+        margin += shape_text_outline_margin(shape);
+      }
+      return margin + ELEMENT_ANTIALIAS_MARGIN;
+    }
+    case ELEMENT_FREEHAND_DRAWING:
+      return ((FreehandDrawing*)element)->stroke_width / 2.0 + ELEMENT_ANTIALIAS_MARGIN;
+    case ELEMENT_PAPER_NOTE:
+      return paper_note_get_shadow_margin(element) + ELEMENT_ANTIALIAS_MARGIN;
+    default:
+      return ELEMENT_ANTIALIAS_MARGIN;
+  }
+}
+
+struct ElementTextLayout {
+  PangoLayout *layout;
+  guint context_serial;  // PangoContext serial the layout was shaped against
+  char *text;
+  char *font_description;
+  int wrap_width;
+  PangoAlignment alignment;
+  PangoEllipsizeMode ellipsize;
+  gboolean strikethrough;
+  int max_height;
+  int natural_width;
+  int natural_height;
+};
+
+void element_clear_text_layout(Element *element) {
+  if (!element || !element->text_layout) return;
+
+  ElementTextLayout *cache = element->text_layout;
+  if (cache->layout) g_object_unref(cache->layout);
+  g_free(cache->text);
+  g_free(cache->font_description);
+  g_free(cache);
+  element->text_layout = NULL;
+}
+
+static gboolean element_text_layout_matches(ElementTextLayout *cache, const ElementTextLayoutKey *key) {
+  return cache->text &&
+         cache->wrap_width == key->wrap_width &&
+         cache->alignment == key->alignment &&
+         cache->ellipsize == key->ellipsize &&
+         cache->strikethrough == key->strikethrough &&
+         cache->max_height == key->max_height &&
+         g_strcmp0(cache->text, key->text) == 0 &&
+         g_strcmp0(cache->font_description, key->font_description) == 0;
+}
+
+PangoLayout* element_get_text_layout(Element *element, cairo_t *cr,
+                                     const ElementTextLayoutKey *key,
+                                     int *natural_width, int *natural_height) {
+  if (!element->text_layout) {
+    element->text_layout = g_new0(ElementTextLayout, 1);
+  }
+  ElementTextLayout *cache = element->text_layout;
+
+  if (!cache->layout) {
+    cache->layout = pango_cairo_create_layout(cr);
+  } else {
+    // Follow the target's font options and scale; only reshapes if they changed
+    pango_cairo_update_layout(cr, cache->layout);
+  }
+
+  guint serial = pango_context_get_serial(pango_layout_get_context(cache->layout));
+  if (serial != cache->context_serial || !element_text_layout_matches(cache, key)) {
+    PangoLayout *layout = cache->layout;
+
+    if (g_strcmp0(cache->font_description, key->font_description) != 0) {
+      PangoFontDescription *font_desc = pango_font_description_from_string(key->font_description);
+      pango_layout_set_font_description(layout, font_desc);
+      pango_font_description_free(font_desc);
+      g_free(cache->font_description);
+      cache->font_description = g_strdup(key->font_description);
+    }
+
+    pango_layout_set_text(layout, key->text ? key->text : "", -1);
+    if (key->wrap_width > 0) {
+      pango_layout_set_width(layout, key->wrap_width * PANGO_SCALE);
+      pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+    } else {
+      pango_layout_set_width(layout, -1);
+    }
+    pango_layout_set_alignment(layout, key->alignment);
+    pango_layout_set_ellipsize(layout, key->ellipsize);
+    pango_layout_set_height(layout, -1);
+
+    if (key->strikethrough) {
+      PangoAttrList *attrs = pango_attr_list_new();
+      pango_attr_list_insert(attrs, pango_attr_strikethrough_new(TRUE));
+      pango_layout_set_attributes(layout, attrs);
+      pango_attr_list_unref(attrs);
+    } else {
+      pango_layout_set_attributes(layout, NULL);
+    }
+
+    pango_layout_get_pixel_size(layout, &cache->natural_width, &cache->natural_height);
+    if (key->max_height >= 0 && cache->natural_height > key->max_height) {
+      pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
+      pango_layout_set_height(layout, key->max_height * PANGO_SCALE);
+    }
+
+    g_free(cache->text);
+    cache->text = g_strdup(key->text ? key->text : "");
+    cache->wrap_width = key->wrap_width;
+    cache->alignment = key->alignment;
+    cache->ellipsize = key->ellipsize;
+    cache->strikethrough = key->strikethrough;
+    cache->max_height = key->max_height;
+    cache->context_serial = pango_context_get_serial(pango_layout_get_context(layout));
+  }
+
+  if (natural_width) *natural_width = cache->natural_width;
+  if (natural_height) *natural_height = cache->natural_height;
+  return cache->layout;
+}
+
 void element_bring_to_front(Element *element, int *next_z) {
+  int old_z = element->z;
   element->z = (*next_z)++;
+  display_list_update_z(element->canvas_data->display_list, element, old_z);
   Model* model = element->canvas_data->model;
   ModelElement* model_element = model_get_by_visual(model, element);
   model_update_position(model, model_element, model_element->position->x, model_element->position->y, element->z);
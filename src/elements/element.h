@@ -24,8 +24,23 @@ typedef enum {
   MEDIA_TYPE_NONE
 } MediaType;
 
+// Level of detail picked per element from zoom and on-screen size
+typedef enum {
+  ELEMENT_LOD_FULL,    // Regular renderer
+  ELEMENT_LOD_SIMPLE,  // Zoomed out: flat body, no decoration, text only if legible
+  ELEMENT_LOD_BLOCK    // A few pixels on screen: one flat rectangle
+} ElementLod;
+
+typedef struct {
+  double detail_zoom;      // Below this zoom elements use their draw_lod hook (0 disables)
+  double block_pixels;     // Elements smaller than this on screen become flat blocks
+  double min_text_pixels;  // Text smaller than this on screen is not laid out
+} ElementLodSettings;
+
 typedef struct {
   void (*draw)(Element *element, cairo_t *cr, gboolean is_selected);
+  // Optional cheap renderer for ELEMENT_LOD_SIMPLE/BLOCK; draw is used when NULL
+  void (*draw_lod)(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod);
   void (*get_connection_point)(Element *element, int point, int *cx, int *cy);
   int (*pick_resize_handle)(Element *element, int x, int y);
   int (*pick_connection_point)(Element *element, int x, int y);
@@ -102,6 +117,19 @@ typedef struct {
   ElementShape shape;
 } ElementConfig;
 
+// Inputs a cached text layout depends on; any change rebuilds the layout
+typedef struct {
+  const char *text;
+  const char *font_description;
+  int wrap_width;                // Pixels; <= 0 leaves lines unwrapped
+  PangoAlignment alignment;
+  PangoEllipsizeMode ellipsize;
+  gboolean strikethrough;
+  int max_height;                // Pixels; taller text is ellipsized to fit, < 0 disables
+} ElementTextLayoutKey;
+
+typedef struct ElementTextLayout ElementTextLayout;
+
 // Forward declare ModelElement to avoid circular dependency
 typedef struct _ModelElement ModelElement;
 
@@ -130,6 +158,19 @@ struct Element {
 
   // OPTIMIZATION: Reverse pointer to model element for O(1) lookups
   ModelElement *model_element;
+
+  // Stamp of the last spatial query that reported this element (de-duplication)
+  guint spatial_stamp;
+
+  // Bumped whenever appearance changes beyond geometry/colour (text, style, editing)
+  guint render_generation;
+
+  // Shaped label text, reused across frames until its key changes
+  ElementTextLayout *text_layout;
+
+  // Font string last parsed by element_text_is_legible and its size in pixels
+  char *legible_font;
+  double legible_font_pixels;
 };
 
 // Interface functions
@@ -141,6 +182,17 @@ void element_start_editing(Element *element, GtkWidget *overlay);
 void element_update_position(Element *element, int x, int y, int z);
 void element_update_size(Element *element, int width, int height);
 void element_free(Element *element);
+void element_invalidate(Element *element);
+// Distance strokes and shadows may paint outside the element's box
+double element_get_draw_margin(Element *element);
+PangoLayout* element_get_text_layout(Element *element, cairo_t *cr,
+                                     const ElementTextLayoutKey *key,
+                                     int *natural_width, int *natural_height);
+void element_clear_text_layout(Element *element);
+ElementLod element_get_lod(Element *element);
+gboolean element_text_is_legible(Element *element, const char *text, const char *font_description);
+void element_draw_lod_rect(Element *element, cairo_t *cr, gboolean is_selected,
+                           double r, double g, double b, double a, gboolean filled);
 void element_bring_to_front(Element *element, int *next_z);
 
 // Utility function to get human-readable name for element types
@@ -108,8 +108,8 @@ void inline_text_update_layout(InlineText *text) {
       }
     }
 
-    if (canvas_data && canvas_data->quadtree) {
-      canvas_rebuild_quadtree(canvas_data);
+    if (canvas_data && canvas_data->spatial_index) {
+      spatial_index_update(canvas_data->spatial_index, element);
     }
   }
 
@@ -281,6 +281,7 @@ gboolean inline_text_on_textview_key_press(GtkEventControllerKey *controller, gu
 void inline_text_start_editing(Element *element, GtkWidget *overlay) {
   InlineText *text = (InlineText*)element;
   text->editing = TRUE;
+  element_invalidate(element);
 
   if (!text->text_view) {
     // Create scrolled window with minimal scrollbar policy
@@ -416,6 +417,7 @@ void inline_text_finish_editing(Element *element) {
   }
 
   text->editing = FALSE;
+  element_invalidate(element);
 
   // Hide the text view
   if (text->scrolled_window) {
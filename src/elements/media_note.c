@@ -100,6 +100,7 @@ void media_note_get_visible_bounds(MediaNote *media_note,
 
 static ElementVTable media_note_vtable = {
   .draw = media_note_draw,
+  .draw_lod = media_note_draw_lod,
   .get_connection_point = media_note_get_connection_point,
   .pick_resize_handle = media_note_pick_resize_handle,
   .pick_connection_point = media_note_pick_connection_point,
@@ -191,8 +192,7 @@ static gboolean media_bus_callback(GstBus *bus, GstMessage *msg, gpointer user_d
 
           // Check if this is a connection from the current audio element
           if (elem->type && elem->type->type == ELEMENT_CONNECTION &&
-              elem->from_element_uuid &&
-              g_strcmp0(elem->from_element_uuid, current_model->uuid) == 0) {
+              model_connection_from(elem) == model_element_handle(current_model)) {
 
             // Check arrowhead type - only follow if arrow points forward
             // ARROWHEAD_NONE (0) = no arrowhead, skip
@@ -204,10 +204,8 @@ static gboolean media_bus_callback(GstBus *bus, GstMessage *msg, gpointer user_d
 
             // Found a connection from current audio, get the target element
             if (elem->to_element_uuid) {
-              ModelElement *next_elem = g_hash_table_lookup(
-                media_note->base.canvas_data->model->elements,
-                elem->to_element_uuid
-              );
+              ModelElement *next_elem = model_get_element(media_note->base.canvas_data->model,
+                                                          model_connection_to(elem));
 
               // Check if target is also an audio element
               if (next_elem && next_elem->visual_element &&
@@ -300,6 +298,180 @@ static gboolean media_bus_callback(GstBus *bus, GstMessage *msg, gpointer user_d
   return TRUE; // keep watching bus
 }
 
+static void media_note_free_mip_levels(MediaNote *media_note);
+static int media_note_build_mip_levels(GdkPixbuf *pixbuf, cairo_surface_t **levels);
+
+// Images are decoded off the main thread so opening a space full of photos
+// does not stall the UI. Notes draw their placeholder until the decode lands.
+struct MediaDecodeJob {
+  MediaNote *owner;       // Main thread only; cleared when the note goes away first
+  GBytes *image_bytes;
+  GdkPixbuf *pixbuf;      // Result, written by the worker
+  cairo_surface_t *mip_levels[MEDIA_NOTE_MIP_LEVELS];  // Pyramid of pixbuf, also built by the worker
+  int mip_count;
+  gint cancelled;
+  double priority;        // Lower decodes first
+  guint64 sequence;
+};
+
+static GThreadPool *media_decode_pool = NULL;
+static guint64 media_decode_sequence = 0;
+
+static void media_decode_job_free(MediaDecodeJob *job) {
+  for (int i = 0; i < job->mip_count; i++) {
+    cairo_surface_destroy(job->mip_levels[i]);
+  }
+  if (job->pixbuf) g_object_unref(job->pixbuf);
+  g_bytes_unref(job->image_bytes);
+  g_free(job);
+}
+
+// Takes ownership of pixbuf and of its prebuilt pyramid
+static void media_note_set_pixbuf(MediaNote *media_note, GdkPixbuf *pixbuf,
+                                  cairo_surface_t **mip_levels, int mip_count) {
+  if (media_note->pixbuf) g_object_unref(media_note->pixbuf);
+  media_note->pixbuf = pixbuf;
+  media_note_free_mip_levels(media_note);
+  for (int i = 0; i < mip_count; i++) {
+    media_note->mip_levels[i] = mip_levels[i];
+  }
+  media_note->mip_count = mip_count;
+  media_note->has_average_color = FALSE;
+  element_invalidate((Element*)media_note);
+
+  CanvasData *data = media_note->base.canvas_data;
+  if (!data) return;
+
+  // Tiles holding the note or a connection drawn to it were rendered with the
+  // placeholder; new generations make them redraw, and the note and its
+  // connections are re-indexed in case their drawn extent moved
+  ModelElement *model_element = data->model ? model_get_by_visual(data->model, (Element*)media_note) : NULL;
+  if (model_element) {
+    GPtrArray *connections = g_ptr_array_new();
+    model_collect_element_connections(data->model, model_element, connections);
+    for (guint i = 0; i < connections->len; i++) {
+      ModelElement *connection = g_ptr_array_index(connections, i);
+      if (connection->visual_element) {
+        element_invalidate(connection->visual_element);
+      }
+    }
+    g_ptr_array_free(connections, TRUE);
+
+    GList *changed = g_list_prepend(NULL, model_element);
+    canvas_update_spatial_index(data, changed);
+    g_list_free(changed);
+  }
+
+  if (data->drawing_area) {
+    gtk_widget_queue_draw(data->drawing_area);
+  }
+}
+
+static gboolean media_decode_finish(gpointer user_data) {
+  MediaDecodeJob *job = (MediaDecodeJob*)user_data;
+  MediaNote *media_note = job->owner;
+  if (media_note) {
+    media_note->decode_job = NULL;
+    if (job->pixbuf) {
+      media_note_set_pixbuf(media_note, job->pixbuf, job->mip_levels, job->mip_count);
+      job->pixbuf = NULL;
+      job->mip_count = 0;
+    }
+  }
+  media_decode_job_free(job);
+  return G_SOURCE_REMOVE;
+}
+
+static void media_decode_worker(gpointer data, gpointer user_data) {
+  (void)user_data;
+  MediaDecodeJob *job = (MediaDecodeJob*)data;
+  if (!g_atomic_int_get(&job->cancelled)) {
+    GInputStream *stream = g_memory_input_stream_new_from_bytes(job->image_bytes);
+    job->pixbuf = gdk_pixbuf_new_from_stream(stream, NULL, NULL);
+    g_object_unref(stream);
+  }
+  // The premultiplied pyramid of a large photo costs as much as decoding it
+  if (job->pixbuf && !g_atomic_int_get(&job->cancelled)) {
+    job->mip_count = media_note_build_mip_levels(job->pixbuf, job->mip_levels);
+  }
+  g_idle_add(media_decode_finish, job);
+}
+
+static gint media_decode_compare(gconstpointer a, gconstpointer b, gpointer user_data) {
+  (void)user_data;
+  const MediaDecodeJob *job_a = (const MediaDecodeJob*)a;
+  const MediaDecodeJob *job_b = (const MediaDecodeJob*)b;
+  if (job_a->priority != job_b->priority) {
+    return job_a->priority < job_b->priority ? -1 : 1;
+  }
+  return (job_a->sequence > job_b->sequence) - (job_a->sequence < job_b->sequence);
+}
+
+void media_note_decode_shutdown(void) {
+  if (!media_decode_pool) return;
+
+  // Queued decodes are dropped and running ones finish first; no worker
+  // outlives the notes. Results already handed to the main loop only touch
+  // notes that are still alive.
+  g_thread_pool_free(media_decode_pool, TRUE, TRUE);
+  media_decode_pool = NULL;
+}
+
+static GThreadPool* media_decode_get_pool(void) {
+  if (!media_decode_pool) {
+    int threads = MAX(1, (int)g_get_num_processors() - 1);
+    media_decode_pool = g_thread_pool_new(media_decode_worker, NULL, threads, FALSE, NULL);
+    if (media_decode_pool) {
+      g_thread_pool_set_sort_function(media_decode_pool, media_decode_compare, NULL);
+    }
+  }
+  return media_decode_pool;
+}
+
+// Zero inside the viewport, otherwise squared distance from its centre, so
+// what the user is looking at is decoded first
+static double media_decode_priority(MediaNote *media_note) {
+  CanvasData *data = media_note->base.canvas_data;
+  if (!data || !data->drawing_area || data->zoom_scale <= 0.0) {
+    return 0.0;
+  }
+
+  Element *element = (Element*)media_note;
+  double view_x = -data->offset_x;
+  double view_y = -data->offset_y;
+  double view_width = gtk_widget_get_width(data->drawing_area) / data->zoom_scale;
+  double view_height = gtk_widget_get_height(data->drawing_area) / data->zoom_scale;
+  if (element->x < view_x + view_width && element->x + element->width > view_x &&
+      element->y < view_y + view_height && element->y + element->height > view_y) {
+    return 0.0;
+  }
+
+  double dx = (element->x + element->width / 2.0) - (view_x + view_width / 2.0);
+  double dy = (element->y + element->height / 2.0) - (view_y + view_height / 2.0);
+  return 1.0 + dx * dx + dy * dy;
+}
+
+static void media_note_decode_image(MediaNote *media_note, const unsigned char *image_data, int image_size) {
+  GThreadPool *pool = media_decode_get_pool();
+  if (!pool) {
+    GInputStream *stream = g_memory_input_stream_new_from_data(image_data, image_size, NULL);
+    media_note->pixbuf = gdk_pixbuf_new_from_stream(stream, NULL, NULL);
+    g_object_unref(stream);
+    if (media_note->pixbuf) {
+      media_note->mip_count = media_note_build_mip_levels(media_note->pixbuf, media_note->mip_levels);
+    }
+    return;
+  }
+
+  MediaDecodeJob *job = g_new0(MediaDecodeJob, 1);
+  job->owner = media_note;
+  job->image_bytes = g_bytes_new(image_data, image_size);
+  job->priority = media_decode_priority(media_note);
+  job->sequence = media_decode_sequence++;
+  media_note->decode_job = job;
+  g_thread_pool_push(pool, job, NULL);
+}
+
 MediaNote* media_note_create(ElementPosition position,
                              ElementColor bg_color,
                              ElementSize size,
@@ -343,14 +515,13 @@ MediaNote* media_note_create(ElementPosition position,
 
   // Always try to create pixbuf from image_data (this is the thumbnail)
   if (media.image_data && media.image_size > 0) {
-    GInputStream *stream = g_memory_input_stream_new_from_data(media.image_data, media.image_size, NULL);
-    media_note->pixbuf = gdk_pixbuf_new_from_stream(stream, NULL, NULL);
-    g_object_unref(stream);
+    media_note_decode_image(media_note, media.image_data, media.image_size);
     media_note->has_thumbnail = TRUE;
   } else if (media.type != MEDIA_TYPE_AUDIO) {
     // Fallback: create a placeholder for non-audio media
     media_note->pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, 100, 100);
     gdk_pixbuf_fill(media_note->pixbuf, 0x303030FF);
+    media_note->mip_count = media_note_build_mip_levels(media_note->pixbuf, media_note->mip_levels);
   }
 
   // Store media data for playback
@@ -681,6 +852,7 @@ void media_note_finish_editing(Element *element) {
   model_update_text(model, model_element, new_text);
 
   media_note->editing = FALSE;
+  element_invalidate(element);
   gtk_widget_hide(media_note->text_view);
 
   // Queue redraw using the stored canvas data
@@ -700,6 +872,7 @@ void media_note_start_editing(Element *element, GtkWidget *overlay) {
   }
 
   media_note->editing = TRUE;
+  element_invalidate(element);
 
   if (!media_note->text_view) {
     media_note->text_view = gtk_text_view_new();
@@ -813,6 +986,113 @@ void media_note_update_size(Element *element, int width, int height) {
   model_update_size(model, model_element, width, height);
 }
 
+// Premultiplied ARGB copy of a pixbuf, so drawing skips the per-frame
+// format conversion done by gdk_cairo_set_source_pixbuf
+static cairo_surface_t* media_note_surface_from_pixbuf(GdkPixbuf *pixbuf) {
+  int width = gdk_pixbuf_get_width(pixbuf);
+  int height = gdk_pixbuf_get_height(pixbuf);
+  int channels = gdk_pixbuf_get_n_channels(pixbuf);
+  gboolean has_alpha = gdk_pixbuf_get_has_alpha(pixbuf);
+  cairo_surface_t *surface = cairo_image_surface_create(has_alpha ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24,
+                                                        width, height);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    return NULL;
+  }
+
+  const guint8 *src = gdk_pixbuf_read_pixels(pixbuf);
+  int src_stride = gdk_pixbuf_get_rowstride(pixbuf);
+  cairo_surface_flush(surface);
+  guint8 *dst = cairo_image_surface_get_data(surface);
+  int dst_stride = cairo_image_surface_get_stride(surface);
+
+  for (int y = 0; y < height; y++) {
+    const guint8 *s = src + y * src_stride;
+    guint32 *d = (guint32*)(dst + y * dst_stride);
+    for (int x = 0; x < width; x++, s += channels) {
+      guint32 a = has_alpha ? s[3] : 0xff;
+      guint32 r = (s[0] * a + 127) / 255;
+      guint32 g = (s[1] * a + 127) / 255;
+      guint32 b = (s[2] * a + 127) / 255;
+      d[x] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+  }
+  cairo_surface_mark_dirty(surface);
+  return surface;
+}
+
+static void media_note_free_mip_levels(MediaNote *media_note) {
+  for (int i = 0; i < media_note->mip_count; i++) {
+    cairo_surface_destroy(media_note->mip_levels[i]);
+    media_note->mip_levels[i] = NULL;
+  }
+  media_note->mip_count = 0;
+}
+
+// Build the image at full, 1/2, 1/4 ... resolution into levels and return
+// how many were made. Each level is a box reduction of the previous one,
+// stopping once the image gets small. Touches no shared state, so decode
+// workers call it.
+static int media_note_build_mip_levels(GdkPixbuf *pixbuf, cairo_surface_t **levels) {
+  cairo_surface_t *level = media_note_surface_from_pixbuf(pixbuf);
+  if (!level) return 0;
+  int count = 0;
+  levels[count++] = level;
+
+  cairo_format_t format = cairo_image_surface_get_format(level);
+  int width = cairo_image_surface_get_width(level);
+  int height = cairo_image_surface_get_height(level);
+  while (count < MEDIA_NOTE_MIP_LEVELS &&
+         width >= 2 * MEDIA_NOTE_MIP_MIN_SIZE && height >= 2 * MEDIA_NOTE_MIP_MIN_SIZE) {
+    int half_width = (width + 1) / 2;
+    int half_height = (height + 1) / 2;
+    cairo_surface_t *half = cairo_image_surface_create(format, half_width, half_height);
+    if (cairo_surface_status(half) != CAIRO_STATUS_SUCCESS) {
+      cairo_surface_destroy(half);
+      break;
+    }
+
+    cairo_t *cr = cairo_create(half);
+    cairo_scale(cr, (double)half_width / width, (double)half_height / height);
+    cairo_set_source_surface(cr, level, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    levels[count++] = half;
+    level = half;
+    width = half_width;
+    height = half_height;
+  }
+  return count;
+}
+
+// Smallest level that still covers the on-screen size, so the final
+// scale is always a mild reduction. The pyramid arrives with the pixbuf;
+// drawing never builds it.
+static cairo_surface_t* media_note_pick_mip_level(MediaNote *media_note, cairo_t *cr,
+                                                  double draw_width, double draw_height) {
+  if (media_note->mip_count == 0) return NULL;
+
+  double device_width = draw_width;
+  double device_height = draw_height;
+  cairo_user_to_device_distance(cr, &device_width, &device_height);
+  device_width = fabs(device_width);
+  device_height = fabs(device_height);
+
+  int chosen = 0;
+  for (int i = 1; i < media_note->mip_count; i++) {
+    cairo_surface_t *level = media_note->mip_levels[i];
+    if (cairo_image_surface_get_width(level) < device_width ||
+        cairo_image_surface_get_height(level) < device_height) {
+      break;
+    }
+    chosen = i;
+  }
+  return media_note->mip_levels[chosen];
+}
+
 void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   MediaNote *media_note = (MediaNote*)element;
 
@@ -897,11 +1177,20 @@ void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
     cairo_save(cr);
     cairo_rectangle(cr, draw_x, draw_y, draw_width, draw_height);
     cairo_clip(cr);
+    cairo_surface_t *image = media_note_pick_mip_level(media_note, cr, draw_width, draw_height);
     cairo_translate(cr, draw_x, draw_y);
-    double scale_x = (double)draw_width / gdk_pixbuf_get_width(media_note->pixbuf);
-    double scale_y = (double)draw_height / gdk_pixbuf_get_height(media_note->pixbuf);
-    cairo_scale(cr, scale_x, scale_y);
-    gdk_cairo_set_source_pixbuf(cr, media_note->pixbuf, 0, 0);
+    if (image) {
+      double scale_x = (double)draw_width / cairo_image_surface_get_width(image);
+      double scale_y = (double)draw_height / cairo_image_surface_get_height(image);
+      cairo_scale(cr, scale_x, scale_y);
+      cairo_set_source_surface(cr, image, 0, 0);
+      cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    } else {
+      double scale_x = (double)draw_width / gdk_pixbuf_get_width(media_note->pixbuf);
+      double scale_y = (double)draw_height / gdk_pixbuf_get_height(media_note->pixbuf);
+      cairo_scale(cr, scale_x, scale_y);
+      gdk_cairo_set_source_pixbuf(cr, media_note->pixbuf, 0, 0);
+    }
 
     if (media_note->media_type == MEDIA_TYPE_VIDEO && media_note->media_playing) {
       cairo_paint_with_alpha(cr, 0.3); // Semi-transparent when media is playing
@@ -954,11 +1243,6 @@ void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   if (!media_note->editing &&
       !(media_note->media_type == MEDIA_TYPE_VIDEO && media_note->media_playing)) {
     cairo_save(cr);
-    PangoLayout *layout = pango_cairo_create_layout(cr);
-    PangoFontDescription *font_desc = pango_font_description_from_string(media_note->font_description);
-    pango_layout_set_font_description(layout, font_desc);
-    pango_font_description_free(font_desc);
-
     char display_text[64] = {0};
 
     if (media_note->media_type == MEDIA_TYPE_VIDEO && media_note->duration > 0) {
@@ -974,20 +1258,17 @@ void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
 
     // Only draw if we have something to show
     if (display_text[0] != '\0') {
-      pango_layout_set_text(layout, display_text, -1);
-      pango_layout_set_alignment(layout, element_get_pango_alignment(media_note->alignment));
-
-      // Apply strikethrough if enabled
-      if (media_note->strikethrough) {
-        PangoAttrList *attrs = pango_attr_list_new();
-        PangoAttribute *strike_attr = pango_attr_strikethrough_new(TRUE);
-        pango_attr_list_insert(attrs, strike_attr);
-        pango_layout_set_attributes(layout, attrs);
-        pango_attr_list_unref(attrs);
-      }
-
+      ElementTextLayoutKey key = {
+        .text = display_text,
+        .font_description = media_note->font_description,
+        .wrap_width = 0,
+        .alignment = element_get_pango_alignment(media_note->alignment),
+        .ellipsize = PANGO_ELLIPSIZE_NONE,
+        .strikethrough = media_note->strikethrough,
+        .max_height = -1,
+      };
       int text_width, text_height;
-      pango_layout_get_pixel_size(layout, &text_width, &text_height);
+      PangoLayout *layout = element_get_text_layout(element, cr, &key, &text_width, &text_height);
 
       // Calculate horizontal position based on alignment
       int text_x;
@@ -1022,7 +1303,6 @@ void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
       pango_cairo_show_layout(cr, layout);
     }
 
-    g_object_unref(layout);
     cairo_restore(cr);
   }
 
@@ -1073,6 +1353,66 @@ void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   }
 }
 
+// Mean colour of the image, computed once and used as its zoomed-out stand-in
+static void media_note_update_average_color(MediaNote *media_note) {
+  if (media_note->has_average_color) return;
+
+  media_note->average_r = media_note->base.bg_r;
+  media_note->average_g = media_note->base.bg_g;
+  media_note->average_b = media_note->base.bg_b;
+
+  // Averaged from the smallest pyramid level, so a full-resolution photo is
+  // never rescaled on the main thread
+  if (media_note->mip_count > 0) {
+    cairo_surface_t *level = media_note->mip_levels[media_note->mip_count - 1];
+    cairo_surface_flush(level);
+    const guint8 *data = cairo_image_surface_get_data(level);
+    int width = cairo_image_surface_get_width(level);
+    int height = cairo_image_surface_get_height(level);
+    int stride = cairo_image_surface_get_stride(level);
+    gboolean has_alpha = cairo_image_surface_get_format(level) == CAIRO_FORMAT_ARGB32;
+    guint64 sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+    for (int y = 0; y < height; y++) {
+      const guint32 *row = (const guint32*)(data + y * stride);
+      for (int x = 0; x < width; x++) {
+        guint32 pixel = row[x];
+        sum_a += has_alpha ? pixel >> 24 : 0xff;
+        sum_r += (pixel >> 16) & 0xff;
+        sum_g += (pixel >> 8) & 0xff;
+        sum_b += pixel & 0xff;
+      }
+    }
+    // Levels are premultiplied; dividing by the summed alpha undoes it
+    if (sum_a > 0) {
+      media_note->average_r = (double)sum_r / sum_a;
+      media_note->average_g = (double)sum_g / sum_a;
+      media_note->average_b = (double)sum_b / sum_a;
+    }
+  }
+  media_note->has_average_color = TRUE;
+}
+
+void media_note_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod) {
+  MediaNote *media_note = (MediaNote*)element;
+
+  // An open editor or readable text still needs the full renderer
+  if (media_note->editing ||
+      (lod == ELEMENT_LOD_SIMPLE && element_text_is_legible(element, media_note->text, media_note->font_description))) {
+    media_note_draw(element, cr, is_selected);
+    return;
+  }
+
+  gboolean audio_card = media_note->media_type == MEDIA_TYPE_AUDIO && !media_note->has_thumbnail;
+  if (media_note->pixbuf && !audio_card) {
+    media_note_update_average_color(media_note);
+    element_draw_lod_rect(element, cr, is_selected,
+                          media_note->average_r, media_note->average_g, media_note->average_b, 1.0, TRUE);
+  } else {
+    element_draw_lod_rect(element, cr, is_selected,
+                          element->bg_r, element->bg_g, element->bg_b, element->bg_a, TRUE);
+  }
+}
+
 void media_note_get_connection_point(Element *element, int point, int *cx, int *cy) {
   MediaNote *media_note = (MediaNote*)element;
   int draw_x, draw_y, draw_width, draw_height;
@@ -1202,6 +1542,12 @@ void media_note_free(Element *element) {
   }
   media_note->media_widget = NULL;
 
+  if (media_note->decode_job) {
+    g_atomic_int_set(&media_note->decode_job->cancelled, 1);
+    media_note->decode_job->owner = NULL;
+    media_note->decode_job = NULL;
+  }
+  media_note_free_mip_levels(media_note);
   if (media_note->pixbuf) g_object_unref(media_note->pixbuf);
   if (media_note->text) g_free(media_note->text);
   if (media_note->font_description) g_free(media_note->font_description);
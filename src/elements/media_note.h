@@ -6,6 +6,12 @@
 
 typedef struct _CanvasData CanvasData;
 
+// Image pyramid depth (full, 1/2, 1/4 ...) and the smallest level edge
+#define MEDIA_NOTE_MIP_LEVELS 8
+#define MEDIA_NOTE_MIP_MIN_SIZE 32
+
+typedef struct MediaDecodeJob MediaDecodeJob;
+
 typedef struct {
   Element base;
   MediaType media_type;
@@ -29,6 +35,17 @@ typedef struct {
   gboolean reset_media_data;
   gboolean has_thumbnail;
 
+  // Premultiplied copies of pixbuf at halving resolutions, built with the decode
+  cairo_surface_t *mip_levels[MEDIA_NOTE_MIP_LEVELS];
+  int mip_count;
+
+  // Pending background decode of the thumbnail; pixbuf stays NULL until it lands
+  MediaDecodeJob *decode_job;
+
+  // Image mean colour for zoomed-out rendering
+  gboolean has_average_color;
+  double average_r, average_g, average_b;
+
   // Fields for data feeding
   const guint8 *current_pos;
   guint remaining;
@@ -42,6 +59,7 @@ MediaNote* media_note_create(ElementPosition position,
                              CanvasData *data);
 void media_note_finish_editing(Element *element);
 void media_note_draw(Element *element, cairo_t *cr, gboolean is_selected);
+void media_note_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod);
 void media_note_get_connection_point(Element *element, int point, int *cx, int *cy);
 int media_note_pick_resize_handle(Element *element, int x, int y);
 int media_note_pick_connection_point(Element *element, int x, int y);
@@ -51,6 +69,8 @@ void media_note_update_size(Element *element, int width, int height);
 void media_note_free(Element *element);
 void media_note_toggle_video_playback(Element *element);
 void media_note_toggle_audio_playback(Element *element);
+// Stop the thumbnail decode workers; called once on app shutdown
+void media_note_decode_shutdown(void);
 void media_note_get_visible_bounds(MediaNote *media_note,
                                    int *out_x,
                                    int *out_y,
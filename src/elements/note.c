@@ -9,6 +9,7 @@
 
 static ElementVTable note_vtable = {
   .draw = note_draw,
+  .draw_lod = note_draw_lod,
   .get_connection_point = note_get_connection_point,
   .pick_resize_handle = note_pick_resize_handle,
   .pick_connection_point = note_pick_connection_point,
@@ -167,32 +168,24 @@ void note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
 
   // Draw text if not editing
   if (!note->editing) {
-    PangoLayout *layout = pango_cairo_create_layout(cr);
-    PangoFontDescription *font_desc = pango_font_description_from_string(note->font_description);
-    pango_layout_set_font_description(layout, font_desc);
-    pango_font_description_free(font_desc);
-
-    pango_layout_set_text(layout, note->text, -1);
-    pango_layout_set_width(layout, (element->width - 20) * PANGO_SCALE);
-    pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
-    pango_layout_set_alignment(layout, element_get_pango_alignment(note->alignment));
-
-    // Apply strikethrough if enabled
-    if (note->strikethrough) {
-      PangoAttrList *attrs = pango_attr_list_new();
-      PangoAttribute *strike_attr = pango_attr_strikethrough_new(TRUE);
-      pango_attr_list_insert(attrs, strike_attr);
-      pango_layout_set_attributes(layout, attrs);
-      pango_attr_list_unref(attrs);
-    }
+    int padding = 10;
+    int available_height = element->height - (2 * padding);
 
+    // Layout is cached on the element; overflowing text comes back ellipsized
+    ElementTextLayoutKey key = {
+      .text = note->text,
+      .font_description = note->font_description,
+      .wrap_width = element->width - 20,
+      .alignment = element_get_pango_alignment(note->alignment),
+      .ellipsize = PANGO_ELLIPSIZE_NONE,
+      .strikethrough = note->strikethrough,
+      .max_height = available_height,
+    };
     int text_width, text_height;
-    pango_layout_get_pixel_size(layout, &text_width, &text_height);
+    PangoLayout *layout = element_get_text_layout(element, cr, &key, &text_width, &text_height);
 
     cairo_set_source_rgba(cr, note->text_r, note->text_g, note->text_b, note->text_a);
 
-    int padding = 10;
-    int available_height = element->height - (2 * padding);
     int text_x = element->x + padding;
     int text_y;
 
@@ -217,19 +210,29 @@ void note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
       cairo_move_to(cr, text_x, text_y);
       pango_cairo_show_layout(cr, layout);
     } else {
-      pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
-      pango_layout_set_height(layout, available_height * PANGO_SCALE);
       cairo_move_to(cr, text_x, element->y + padding);
       pango_cairo_show_layout(cr, layout);
     }
-
-    g_object_unref(layout);
   }
 
   // Restore cairo state
   cairo_restore(cr);
 }
 
+void note_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod) {
+  Note *note = (Note*)element;
+
+  // An open editor or readable text still needs the full renderer
+  if (note->editing ||
+      (lod == ELEMENT_LOD_SIMPLE && element_text_is_legible(element, note->text, note->font_description))) {
+    note_draw(element, cr, is_selected);
+    return;
+  }
+
+  element_draw_lod_rect(element, cr, is_selected,
+                        element->bg_r, element->bg_g, element->bg_b, element->bg_a, TRUE);
+}
+
 void note_get_connection_point(Element *element, int point, int *cx, int *cy) {
   int unrotated_x, unrotated_y;
   switch(point) {
@@ -306,6 +309,7 @@ int note_pick_connection_point(Element *element, int x, int y) {
 void note_start_editing(Element *element, GtkWidget *overlay) {
   Note *note = (Note*)element;
   note->editing = TRUE;
+  element_invalidate(element);
 
   if (!note->text_view) {
     // Create scrolled window
@@ -369,6 +373,7 @@ void note_finish_editing(Element *element) {
   model_update_text(model, model_element, new_text);
 
   note->editing = FALSE;
+  element_invalidate(element);
 
   // Hide the scrolled window instead of the text view
   if (note->scrolled_window) {
@@ -23,6 +23,7 @@ Note* note_create(ElementPosition position,
                   ElementText text,
                   CanvasData *data);
 void note_draw(Element *element, cairo_t *cr, gboolean is_selected);
+void note_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod);
 void note_get_connection_point(Element *element, int point, int *cx, int *cy);
 int note_pick_resize_handle(Element *element, int x, int y);
 int note_pick_connection_point(Element *element, int x, int y);
@@ -9,6 +9,7 @@
 
 static ElementVTable paper_note_vtable = {
   .draw = paper_note_draw,
+  .draw_lod = paper_note_draw_lod,
   .get_connection_point = paper_note_get_connection_point,
   .pick_resize_handle = paper_note_pick_resize_handle,
   .pick_connection_point = paper_note_pick_connection_point,
@@ -86,11 +87,35 @@ gboolean paper_note_on_textview_key_press(GtkEventControllerKey *controller, gui
   return FALSE;
 }
 
+typedef struct {
+  double radius_x, radius_y;
+  double offset_x, offset_y;
+} PaperNoteShadow;
+
+static PaperNoteShadow paper_note_shadow(Element *element) {
+  return (PaperNoteShadow){
+    .radius_x = fmax(22.0, element->width * 0.58),
+    .radius_y = fmax(8.0, element->height * 0.11),
+    .offset_x = -fmax(3.0, element->width * 0.03),
+    .offset_y = fmax(1.5, element->height * 0.02),
+  };
+}
+
+double paper_note_get_shadow_margin(Element *element) {
+  PaperNoteShadow shadow = paper_note_shadow(element);
+  // The ellipse is centred under the bottom edge, shifted left
+  double left = shadow.radius_x - shadow.offset_x - element->width * 0.5;
+  double right = shadow.radius_x + shadow.offset_x - element->width * 0.5;
+  double below = shadow.radius_y + shadow.offset_y;
+  return fmax(0.0, fmax(below, fmax(left, right)));
+}
+
 static void paper_note_draw_shadow(Element *element, cairo_t *cr) {
-  const double bottom_radius_x = fmax(22.0, element->width * 0.58);
-  const double bottom_radius_y = fmax(8.0, element->height * 0.11);
-  const double bottom_offset_x = -fmax(3.0, element->width * 0.03);
-  const double bottom_offset_y = fmax(1.5, element->height * 0.02);
+  PaperNoteShadow shadow = paper_note_shadow(element);
+  const double bottom_radius_x = shadow.radius_x;
+  const double bottom_radius_y = shadow.radius_y;
+  const double bottom_offset_x = shadow.offset_x;
+  const double bottom_offset_y = shadow.offset_y;
 
   // Bottom soft shadow inspired by Lucid sticky note
   cairo_save(cr);
@@ -147,27 +172,18 @@ void paper_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   cairo_stroke(cr);
 
   if (!note->editing) {
-    PangoLayout *layout = pango_cairo_create_layout(cr);
-    PangoFontDescription *font_desc = pango_font_description_from_string(note->font_description);
-    pango_layout_set_font_description(layout, font_desc);
-    pango_font_description_free(font_desc);
-
-    pango_layout_set_text(layout, note->text, -1);
-    pango_layout_set_width(layout, (element->width - 10) * PANGO_SCALE);
-    pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
-    pango_layout_set_alignment(layout, element_get_pango_alignment(note->alignment));
-
-    // Apply strikethrough if enabled
-    if (note->strikethrough) {
-      PangoAttrList *attrs = pango_attr_list_new();
-      PangoAttribute *strike_attr = pango_attr_strikethrough_new(TRUE);
-      pango_attr_list_insert(attrs, strike_attr);
-      pango_layout_set_attributes(layout, attrs);
-      pango_attr_list_unref(attrs);
-    }
-
+    // Layout is cached on the element; overflowing text comes back ellipsized
+    ElementTextLayoutKey key = {
+      .text = note->text,
+      .font_description = note->font_description,
+      .wrap_width = element->width - 10,
+      .alignment = element_get_pango_alignment(note->alignment),
+      .ellipsize = PANGO_ELLIPSIZE_NONE,
+      .strikethrough = note->strikethrough,
+      .max_height = element->height - 10,
+    };
     int text_width, text_height;
-    pango_layout_get_pixel_size(layout, &text_width, &text_height);
+    PangoLayout *layout = element_get_text_layout(element, cr, &key, &text_width, &text_height);
 
     cairo_set_source_rgba(cr, note->text_r, note->text_g, note->text_b, note->text_a);
 
@@ -192,17 +208,8 @@ void paper_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
       break;
     }
 
-    if (text_height <= element->height - 10) {
-      cairo_move_to(cr, text_x, text_y);
-      pango_cairo_show_layout(cr, layout);
-    } else {
-      pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
-      pango_layout_set_height(layout, (element->height - 10) * PANGO_SCALE);
-      cairo_move_to(cr, text_x, text_y);
-      pango_cairo_show_layout(cr, layout);
-    }
-
-    g_object_unref(layout);
+    cairo_move_to(cr, text_x, text_y);
+    pango_cairo_show_layout(cr, layout);
   }
 
   cairo_reset_clip(cr);
@@ -225,6 +232,20 @@ void paper_note_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   }
 }
 
+void paper_note_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod) {
+  PaperNote *note = (PaperNote*)element;
+
+  // An open editor or readable text still needs the full renderer
+  if (note->editing ||
+      (lod == ELEMENT_LOD_SIMPLE && element_text_is_legible(element, note->text, note->font_description))) {
+    paper_note_draw(element, cr, is_selected);
+    return;
+  }
+
+  element_draw_lod_rect(element, cr, is_selected,
+                        element->bg_r, element->bg_g, element->bg_b, element->bg_a, TRUE);
+}
+
 void paper_note_get_connection_point(Element *element, int point, int *cx, int *cy) {
   int unrotated_x, unrotated_y;
   switch(point) {
@@ -301,6 +322,7 @@ int paper_note_pick_connection_point(Element *element, int x, int y) {
 void paper_note_start_editing(Element *element, GtkWidget *overlay) {
   PaperNote *note = (PaperNote*)element;
   note->editing = TRUE;
+  element_invalidate(element);
 
   if (!note->text_view) {
     // Create scrolled window
@@ -364,6 +386,7 @@ void paper_note_finish_editing(Element *element) {
   model_update_text(model, model_element, new_text);
 
   note->editing = FALSE;
+  element_invalidate(element);
 
   // Hide the scrolled window
   if (note->scrolled_window) {
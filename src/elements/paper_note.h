@@ -26,6 +26,9 @@ PaperNote* paper_note_create(ElementPosition position,
                              ElementText text,
                              CanvasData *data);
 void paper_note_draw(Element *element, cairo_t *cr, gboolean is_selected);
+// How far the soft shadow reaches past the note's box on any side
+double paper_note_get_shadow_margin(Element *element);
+void paper_note_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod);
 void paper_note_get_connection_point(Element *element, int point, int *cx, int *cy);
 int paper_note_pick_resize_handle(Element *element, int x, int y);
 int paper_note_pick_connection_point(Element *element, int x, int y);
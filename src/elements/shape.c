@@ -1403,14 +1403,17 @@ static const BrushGlyph* brush_lookup(gunichar ch) {
   return &brush_default_glyph;
 }
 
+// Jitter depends on content, font and size only, so moving the shape keeps
+// its strokes and lets the cached body be reused at the new position
 static guint32 text_outline_seed(const Shape *shape) {
-  guint32 seed = (guint32)(shape->base.x * 73856093u) ^
-                 (guint32)(shape->base.y * 19349663u) ^
-                 (guint32)(shape->base.width * 83492791u) ^
+  guint32 seed = (guint32)(shape->base.width * 83492791u) ^
                  (guint32)(shape->base.height * 2654435761u);
   if (shape->text && *shape->text) {
     seed ^= g_str_hash(shape->text);
   }
+  if (shape->font_description) {
+    seed ^= g_str_hash(shape->font_description) * 73856093u;
+  }
   if (seed == 0) seed = 0x9e3779b9u;
   return seed;
 }
@@ -1484,6 +1487,10 @@ static void brush_draw_stroke(cairo_t *cr,
   }
 }
 
+// Brush glyphs cast a shadow offset by these fractions of the glyph size
+#define BRUSH_SHADOW_OFFSET_X 0.08
+#define BRUSH_SHADOW_OFFSET_Y 0.10
+
 static void brush_draw_glyph(cairo_t *cr,
                              const BrushGlyph *glyph,
                              double origin_x,
@@ -1498,8 +1505,8 @@ static void brush_draw_glyph(cairo_t *cr,
   if (!glyph) return;
   if (glyph->stroke_count > 0) {
     guint32 shadow_seed = *seed ^ 0x5f5f5f5f;
-    double shadow_offset_x = scale * 0.08;
-    double shadow_offset_y = scale * 0.10;
+    double shadow_offset_x = scale * BRUSH_SHADOW_OFFSET_X;
+    double shadow_offset_y = scale * BRUSH_SHADOW_OFFSET_Y;
     for (guint i = 0; i < glyph->stroke_count; i++) {
       brush_draw_stroke(cr, &glyph->strokes[i],
                         origin_x + shadow_offset_x,
@@ -1651,6 +1658,21 @@ static void brush_render_text(cairo_t *cr,
   g_strfreev(lines);
 }
 
+// Brush text leans right by this fraction of each glyph's height
+#define BRUSH_TEXT_SHEAR -0.22
+// Widest BrushStroke width and jitter in the glyph table
+#define BRUSH_MAX_STROKE_WIDTH 0.28
+#define BRUSH_MAX_STROKE_JITTER 0.15
+
+double shape_text_outline_margin(Shape *shape) {
+  // Glyphs are never taller than the box. Past their glyph box they reach by
+  // the shadow offset, the shear, half the jitter and half the widest stroke
+  // pass (1.35 width multiplier at up to 1.15 variance).
+  double reach = MAX(BRUSH_SHADOW_OFFSET_X, BRUSH_SHADOW_OFFSET_Y) + fabs(BRUSH_TEXT_SHEAR) +
+                 BRUSH_MAX_STROKE_JITTER / 2.0 + BRUSH_MAX_STROKE_WIDTH * 1.35 * 1.15 / 2.0;
+  return ((Element*)shape)->height * reach;
+}
+
 void shape_render_text_outline_sample(cairo_t *cr,
                                       const char *text,
                                       double x,
@@ -1671,7 +1693,7 @@ void shape_render_text_outline_sample(cairo_t *cr,
                     stroke_g,
                     stroke_b,
                     stroke_a <= 0.0 ? 1.0 : stroke_a,
-                    -0.22,
+                    BRUSH_TEXT_SHEAR,
                     seed ^ 0x9e3779b9u);
 }
 
@@ -1698,7 +1720,7 @@ static void text_outline_draw(Shape *shape, cairo_t *cr) {
                     shape->stroke_g,
                     shape->stroke_b,
                     base_a,
-                    -0.22,
+                    BRUSH_TEXT_SHEAR,
                     seed);
 }
 
@@ -2098,23 +2120,266 @@ gboolean shape_contains_point(Element *element, int x, int y, double threshold)
   return distance <= threshold;
 }
 
-static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
-  Shape *shape = (Shape*)element;
+// One parsed plot series. draw_x/draw_y hold a decimated copy when the raw
+// series has more points than the plot has pixels to show them.
+typedef struct {
+  gchar *label;
+  GArray *x_values;
+  GArray *y_values;
+  GArray *draw_x;
+  GArray *draw_y;
+} PlotSeries;
+
+struct ShapePlotData {
+  guint render_generation;     // Element generation the series were parsed at
+  GArray *series;              // PlotSeries
+  double min_x, max_x, min_y, max_y;
+  guint point_budget;          // Budget the decimated copies were built for
+};
+
+static void plot_series_clear_decimated(PlotSeries *series) {
+  if (series->draw_x) g_array_free(series->draw_x, TRUE);
+  if (series->draw_y) g_array_free(series->draw_y, TRUE);
+  series->draw_x = NULL;
+  series->draw_y = NULL;
+}
 
-  if (shape->editing) {
-    shape_update_text_view_position(shape);
+static void shape_plot_data_free(Shape *shape) {
+  ShapePlotData *plot = shape->plot_data;
+  if (!plot) return;
+  for (guint i = 0; i < plot->series->len; i++) {
+    PlotSeries *series = &g_array_index(plot->series, PlotSeries, i);
+    g_free(series->label);
+    g_array_free(series->x_values, TRUE);
+    g_array_free(series->y_values, TRUE);
+    plot_series_clear_decimated(series);
   }
+  g_array_free(plot->series, TRUE);
+  g_free(plot);
+  shape->plot_data = NULL;
+}
 
-  // Save cairo state and apply rotation if needed
-  cairo_save(cr);
-  if (element->rotation_degrees != 0.0) {
-    double center_x = element->x + element->width / 2.0;
-    double center_y = element->y + element->height / 2.0;
-    cairo_translate(cr, center_x, center_y);
-    cairo_rotate(cr, element->rotation_degrees * M_PI / 180.0);
-    cairo_translate(cr, -center_x, -center_y);
+static PlotSeries* plot_append_series(GArray *series_list, gchar *label) {
+  PlotSeries series = {0};
+  series.label = label;
+  series.x_values = g_array_new(FALSE, FALSE, sizeof(double));
+  series.y_values = g_array_new(FALSE, FALSE, sizeof(double));
+  g_array_append_val(series_list, series);
+  return &g_array_index(series_list, PlotSeries, series_list->len - 1);
+}
+
+// Parse multi-line plot data: each line can be "line \"Name\" x,y x,y ..." or simple "x,y" format
+static ShapePlotData* shape_plot_parse(const char *text) {
+  ShapePlotData *plot = g_new0(ShapePlotData, 1);
+  plot->series = g_array_new(FALSE, FALSE, sizeof(PlotSeries));
+
+  gchar **lines = g_strsplit(text, "\n", -1);
+  PlotSeries *current_line = NULL;
+
+  for (int i = 0; lines[i] != NULL; i++) {
+    gchar *line = g_strstrip(lines[i]);
+    if (strlen(line) == 0) continue;
+
+    // Check if line starts with "line " keyword
+    if (g_str_has_prefix(line, "line ")) {
+      // New line definition: line "Name" x,y x,y ... or line Name x,y x,y ...
+      const char *rest = line + 5; // skip "line "
+
+      // Parse label (with or without quotes)
+      gchar *label = NULL;
+      const char *data_start = rest;
+
+      if (*rest == '"') {
+        // Quoted label
+        rest++; // skip opening quote
+        const char *end_quote = strchr(rest, '"');
+        if (end_quote) {
+          label = g_strndup(rest, end_quote - rest);
+          data_start = end_quote + 1;
+        }
+      } else {
+        // Unquoted label (read until space or comma)
+        const char *label_end = rest;
+        while (*label_end && !g_ascii_isspace(*label_end) && *label_end != ',') {
+          label_end++;
+        }
+        if (label_end > rest) {
+          label = g_strndup(rest, label_end - rest);
+          data_start = label_end;
+        }
+      }
+
+      current_line = plot_append_series(plot->series, label ? label : g_strdup("Series"));
+
+      // Parse data points from the rest of the line
+      gchar **points = g_strsplit_set(data_start, " \t", -1);
+      for (int j = 0; points[j] != NULL; j++) {
+        gchar *point = g_strstrip(points[j]);
+        if (strlen(point) == 0) continue;
+
+        // Parse x,y pair
+        gchar **coords = g_strsplit(point, ",", 2);
+        if (coords[0] && coords[1]) {
+          double x = g_strtod(g_strstrip(coords[0]), NULL);
+          double y = g_strtod(g_strstrip(coords[1]), NULL);
+          g_array_append_val(current_line->x_values, x);
+          g_array_append_val(current_line->y_values, y);
+        }
+        g_strfreev(coords);
+      }
+      g_strfreev(points);
+
+    } else {
+      // Legacy format: simple x,y pairs or single values
+      if (plot->series->len == 0) {
+        // Create default line if none exists
+        current_line = plot_append_series(plot->series, g_strdup("Data"));
+      }
+
+      // Parse as comma or space-separated values
+      gchar **parts = g_strsplit_set(line, ", \t", -1);
+      int value_count = 0;
+      double values[2] = {0.0, 0.0};
+
+      for (int j = 0; parts[j] != NULL && value_count < 2; j++) {
+        gchar *trimmed = g_strstrip(parts[j]);
+        if (strlen(trimmed) > 0) {
+          char *endptr;
+          double val = g_strtod(trimmed, &endptr);
+          if (*endptr == '\0' || g_ascii_isspace(*endptr)) {
+            values[value_count++] = val;
+          }
+        }
+      }
+      g_strfreev(parts);
+
+      if (value_count >= 2) {
+        g_array_append_val(current_line->x_values, values[0]);
+        g_array_append_val(current_line->y_values, values[1]);
+      } else if (value_count == 1) {
+        // If only one value, use index as x
+        double x_val = (double)current_line->x_values->len;
+        g_array_append_val(current_line->x_values, x_val);
+        g_array_append_val(current_line->y_values, values[0]);
+      }
+    }
+  }
+  g_strfreev(lines);
+
+  // Global min/max for scaling across all lines
+  plot->min_x = G_MAXDOUBLE;
+  plot->max_x = -G_MAXDOUBLE;
+  plot->min_y = G_MAXDOUBLE;
+  plot->max_y = -G_MAXDOUBLE;
+  for (guint line_idx = 0; line_idx < plot->series->len; line_idx++) {
+    PlotSeries *series = &g_array_index(plot->series, PlotSeries, line_idx);
+    for (guint i = 0; i < series->x_values->len; i++) {
+      double x = g_array_index(series->x_values, double, i);
+      double y = g_array_index(series->y_values, double, i);
+      if (x < plot->min_x) plot->min_x = x;
+      if (x > plot->max_x) plot->max_x = x;
+      if (y < plot->min_y) plot->min_y = y;
+      if (y > plot->max_y) plot->max_y = y;
+    }
   }
 
+  return plot;
+}
+
+// Parsed plot for the shape's current text. Every text writer calls
+// element_invalidate(), so the render generation alone says when to reparse.
+static ShapePlotData* shape_get_plot_data(Shape *shape) {
+  ShapePlotData *plot = shape->plot_data;
+  if (plot && plot->render_generation == shape->base.render_generation) {
+    return plot;
+  }
+
+  shape_plot_data_free(shape);
+  plot = shape_plot_parse(shape->text);
+  plot->render_generation = shape->base.render_generation;
+  shape->plot_data = plot;
+  return plot;
+}
+
+// Largest-Triangle-Three-Buckets downsampling. Keeps the first and last
+// points and, from each of threshold - 2 equal index buckets, the point that
+// forms the largest triangle with the previously kept point and the average
+// of the next bucket. Peaks and troughs survive, unlike plain striding.
+void shape_plot_downsample(const double *xs, const double *ys, guint count, guint threshold,
+                           GArray *out_x, GArray *out_y) {
+  if (count <= threshold || threshold < 3) {
+    g_array_append_vals(out_x, xs, count);
+    g_array_append_vals(out_y, ys, count);
+    return;
+  }
+
+  g_array_append_val(out_x, xs[0]);
+  g_array_append_val(out_y, ys[0]);
+
+  double bucket_size = (double)(count - 2) / (threshold - 2);
+  guint kept = 0;
+  for (guint bucket = 0; bucket < threshold - 2; bucket++) {
+    guint next_start = (guint)floor((bucket + 1) * bucket_size) + 1;
+    guint next_end = MIN((guint)floor((bucket + 2) * bucket_size) + 1, count);
+    double avg_x = 0.0;
+    double avg_y = 0.0;
+    for (guint i = next_start; i < next_end; i++) {
+      avg_x += xs[i];
+      avg_y += ys[i];
+    }
+    guint next_count = next_end > next_start ? next_end - next_start : 0;
+    if (next_count > 0) {
+      avg_x /= next_count;
+      avg_y /= next_count;
+    } else {
+      avg_x = xs[count - 1];
+      avg_y = ys[count - 1];
+    }
+
+    guint start = (guint)floor(bucket * bucket_size) + 1;
+    guint end = (guint)floor((bucket + 1) * bucket_size) + 1;
+    double best_area = -1.0;
+    guint best = start;
+    for (guint i = start; i < end; i++) {
+      double area = fabs((xs[kept] - avg_x) * (ys[i] - ys[kept]) -
+                         (xs[kept] - xs[i]) * (avg_y - ys[kept]));
+      if (area > best_area) {
+        best_area = area;
+        best = i;
+      }
+    }
+
+    g_array_append_val(out_x, xs[best]);
+    g_array_append_val(out_y, ys[best]);
+    kept = best;
+  }
+
+  g_array_append_val(out_x, xs[count - 1]);
+  g_array_append_val(out_y, ys[count - 1]);
+}
+
+// Rebuild decimated copies of long series when the pixel budget changes
+static void shape_plot_decimate(ShapePlotData *plot, guint point_budget) {
+  if (plot->point_budget == point_budget) return;
+  plot->point_budget = point_budget;
+
+  for (guint i = 0; i < plot->series->len; i++) {
+    PlotSeries *series = &g_array_index(plot->series, PlotSeries, i);
+    plot_series_clear_decimated(series);
+    guint count = series->x_values->len;
+    if (count <= point_budget) continue;
+
+    series->draw_x = g_array_sized_new(FALSE, FALSE, sizeof(double), point_budget);
+    series->draw_y = g_array_sized_new(FALSE, FALSE, sizeof(double), point_budget);
+    shape_plot_downsample((const double*)series->x_values->data, (const double*)series->y_values->data,
+                          count, point_budget, series->draw_x, series->draw_y);
+  }
+}
+
+// Shape geometry, fill and stroke in the element's unrotated frame
+static void shape_draw_body(Shape *shape, cairo_t *cr) {
+  Element *element = (Element*)shape;
+
   // Set stroke style (dashed, dotted, or solid)
   if (shape->stroke_style == STROKE_STYLE_DASHED) {
     double dashes[] = {12.0, 8.0};
@@ -2209,17 +2474,19 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
         if (shape->text && strlen(shape->text) > 0) {
           char *ascii_art = text_to_ascii_art(shape->text);
 
-          // Use Pango to render the ASCII art with monospace font
-          PangoLayout *layout = pango_cairo_create_layout(cr);
-          PangoFontDescription *font_desc = pango_font_description_from_string("Monospace 10");
-          pango_layout_set_font_description(layout, font_desc);
-          pango_font_description_free(font_desc);
-
-          pango_layout_set_text(layout, ascii_art, -1);
-
-          // Get the size of the rendered ASCII art
+          // Use Pango to render the ASCII art with monospace font (the label
+          // layout slot is free since ASCII art shapes draw no other text)
+          ElementTextLayoutKey key = {
+            .text = ascii_art,
+            .font_description = "Monospace 10",
+            .wrap_width = 0,
+            .alignment = PANGO_ALIGN_LEFT,
+            .ellipsize = PANGO_ELLIPSIZE_NONE,
+            .strikethrough = FALSE,
+            .max_height = -1,
+          };
           int text_width, text_height;
-          pango_layout_get_pixel_size(layout, &text_width, &text_height);
+          PangoLayout *layout = element_get_text_layout(element, cr, &key, &text_width, &text_height);
 
           // Calculate scale to fit within element bounds
           double padding = 10.0;
@@ -2244,7 +2511,6 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
 
           cairo_restore(cr);
 
-          g_object_unref(layout);
           g_free(ascii_art);
         }
       }
@@ -2572,7 +2838,7 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
       break;
     case SHAPE_PLOT:
       {
-        // Parse multi-line plot data: each line can be "line \"Name\" x,y x,y ..." or simple "x,y" format
+        // Series are parsed once per text change, see shape_get_plot_data
         if (!shape->text || strlen(shape->text) == 0) {
           // Draw empty plot with axes
           double margin = 20.0;
@@ -2586,138 +2852,13 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
           cairo_line_to(cr, element->x + element->width - margin, element->y + element->height - margin);
           cairo_stroke(cr);
         } else {
-          // Data structure for multi-line support
-          typedef struct {
-            gchar *label;
-            GArray *x_values;
-            GArray *y_values;
-          } PlotLine;
-
-          GArray *plot_lines = g_array_new(FALSE, FALSE, sizeof(PlotLine));
-
-          // Parse input text
-          gchar **lines = g_strsplit(shape->text, "\n", -1);
-          PlotLine *current_line = NULL;
-
-          for (int i = 0; lines[i] != NULL; i++) {
-            gchar *line = g_strstrip(lines[i]);
-            if (strlen(line) == 0) continue;
-
-            // Check if line starts with "line " keyword
-            if (g_str_has_prefix(line, "line ")) {
-              // New line definition: line "Name" x,y x,y ... or line Name x,y x,y ...
-              const char *rest = line + 5; // skip "line "
-
-              // Parse label (with or without quotes)
-              gchar *label = NULL;
-              const char *data_start = rest;
-
-              if (*rest == '"') {
-                // Quoted label
-                rest++; // skip opening quote
-                const char *end_quote = strchr(rest, '"');
-                if (end_quote) {
-                  label = g_strndup(rest, end_quote - rest);
-                  data_start = end_quote + 1;
-                }
-              } else {
-                // Unquoted label (read until space or comma)
-                const char *label_end = rest;
-                while (*label_end && !g_ascii_isspace(*label_end) && *label_end != ',') {
-                  label_end++;
-                }
-                if (label_end > rest) {
-                  label = g_strndup(rest, label_end - rest);
-                  data_start = label_end;
-                }
-              }
+          ShapePlotData *plot = shape_get_plot_data(shape);
 
-              // Create new plot line
-              PlotLine new_line;
-              new_line.label = label ? label : g_strdup("Series");
-              new_line.x_values = g_array_new(FALSE, FALSE, sizeof(double));
-              new_line.y_values = g_array_new(FALSE, FALSE, sizeof(double));
-              g_array_append_val(plot_lines, new_line);
-              current_line = &g_array_index(plot_lines, PlotLine, plot_lines->len - 1);
-
-              // Parse data points from the rest of the line
-              gchar **points = g_strsplit_set(data_start, " \t", -1);
-              for (int j = 0; points[j] != NULL; j++) {
-                gchar *point = g_strstrip(points[j]);
-                if (strlen(point) == 0) continue;
-
-                // Parse x,y pair
-                gchar **coords = g_strsplit(point, ",", 2);
-                if (coords[0] && coords[1]) {
-                  double x = g_strtod(g_strstrip(coords[0]), NULL);
-                  double y = g_strtod(g_strstrip(coords[1]), NULL);
-                  g_array_append_val(current_line->x_values, x);
-                  g_array_append_val(current_line->y_values, y);
-                }
-                g_strfreev(coords);
-              }
-              g_strfreev(points);
-
-            } else {
-              // Legacy format: simple x,y pairs or single values
-              if (plot_lines->len == 0) {
-                // Create default line if none exists
-                PlotLine new_line;
-                new_line.label = g_strdup("Data");
-                new_line.x_values = g_array_new(FALSE, FALSE, sizeof(double));
-                new_line.y_values = g_array_new(FALSE, FALSE, sizeof(double));
-                g_array_append_val(plot_lines, new_line);
-                current_line = &g_array_index(plot_lines, PlotLine, 0);
-              }
-
-              // Parse as comma or space-separated values
-              gchar **parts = g_strsplit_set(line, ", \t", -1);
-              int value_count = 0;
-              double values[2] = {0.0, 0.0};
-
-              for (int j = 0; parts[j] != NULL && value_count < 2; j++) {
-                gchar *trimmed = g_strstrip(parts[j]);
-                if (strlen(trimmed) > 0) {
-                  char *endptr;
-                  double val = g_strtod(trimmed, &endptr);
-                  if (*endptr == '\0' || g_ascii_isspace(*endptr)) {
-                    values[value_count++] = val;
-                  }
-                }
-              }
-              g_strfreev(parts);
-
-              if (value_count >= 2) {
-                g_array_append_val(current_line->x_values, values[0]);
-                g_array_append_val(current_line->y_values, values[1]);
-              } else if (value_count == 1) {
-                // If only one value, use index as x
-                double x_val = (double)current_line->x_values->len;
-                g_array_append_val(current_line->x_values, x_val);
-                g_array_append_val(current_line->y_values, values[0]);
-              }
-            }
-          }
-          g_strfreev(lines);
-
-          if (plot_lines->len > 0) {
-            // Find global min/max for scaling across all lines
-            double min_x = G_MAXDOUBLE;
-            double max_x = -G_MAXDOUBLE;
-            double min_y = G_MAXDOUBLE;
-            double max_y = -G_MAXDOUBLE;
-
-            for (guint line_idx = 0; line_idx < plot_lines->len; line_idx++) {
-              PlotLine *pline = &g_array_index(plot_lines, PlotLine, line_idx);
-              for (guint i = 0; i < pline->x_values->len; i++) {
-                double x = g_array_index(pline->x_values, double, i);
-                double y = g_array_index(pline->y_values, double, i);
-                if (x < min_x) min_x = x;
-                if (x > max_x) max_x = x;
-                if (y < min_y) min_y = y;
-                if (y > max_y) max_y = y;
-              }
-            }
+          if (plot->series->len > 0) {
+            double min_x = plot->min_x;
+            double max_x = plot->max_x;
+            double min_y = plot->min_y;
+            double max_y = plot->max_y;
 
             // Force axes to start from 0 (don't auto-scale away from zero)
             if (min_x > 0) min_x = 0;
@@ -2832,12 +2973,21 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
             cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
             cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
 
-            for (guint line_idx = 0; line_idx < plot_lines->len; line_idx++) {
-              PlotLine *pline = &g_array_index(plot_lines, PlotLine, line_idx);
+            // Two points per device pixel column is all a polyline can show
+            double device_dx = plot_width;
+            double device_dy = 0.0;
+            cairo_user_to_device_distance(cr, &device_dx, &device_dy);
+            guint point_budget = MAX(3u, (guint)ceil(hypot(device_dx, device_dy)) * 2);
+            shape_plot_decimate(plot, point_budget);
+
+            for (guint line_idx = 0; line_idx < plot->series->len; line_idx++) {
+              PlotSeries *pline = &g_array_index(plot->series, PlotSeries, line_idx);
+              GArray *xs = pline->draw_x ? pline->draw_x : pline->x_values;
+              GArray *ys = pline->draw_y ? pline->draw_y : pline->y_values;
 
               // Select color (use shape's color for single line, palette for multiple)
               Color line_color;
-              if (plot_lines->len == 1) {
+              if (plot->series->len == 1) {
                 line_color.r = shape->stroke_r;
                 line_color.g = shape->stroke_g;
                 line_color.b = shape->stroke_b;
@@ -2848,9 +2998,9 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
               cairo_set_source_rgba(cr, line_color.r, line_color.g, line_color.b, shape->stroke_a);
 
               // Draw line
-              for (guint i = 0; i < pline->x_values->len; i++) {
-                double x = g_array_index(pline->x_values, double, i);
-                double y = g_array_index(pline->y_values, double, i);
+              for (guint i = 0; i < xs->len; i++) {
+                double x = g_array_index(xs, double, i);
+                double y = g_array_index(ys, double, i);
 
                 double norm_x = (x - min_x) / x_range;
                 double norm_y = 1.0 - ((y - min_y) / y_range);
@@ -2867,9 +3017,9 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
               cairo_stroke(cr);
 
               // Draw points
-              for (guint i = 0; i < pline->x_values->len; i++) {
-                double x = g_array_index(pline->x_values, double, i);
-                double y = g_array_index(pline->y_values, double, i);
+              for (guint i = 0; i < xs->len; i++) {
+                double x = g_array_index(xs, double, i);
+                double y = g_array_index(ys, double, i);
 
                 double norm_x = (x - min_x) / x_range;
                 double norm_y = 1.0 - ((y - min_y) / y_range);
@@ -2883,7 +3033,7 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
             }
 
             // Draw legend if multiple lines
-            if (plot_lines->len > 1) {
+            if (plot->series->len > 1) {
               double legend_x = element->x + element->width - margin_right - 120;
               double legend_y = element->y + margin_top + 10;
               double legend_line_height = 18;
@@ -2891,8 +3041,8 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
               PangoLayout *legend_layout = pango_cairo_create_layout(cr);
               pango_layout_set_font_description(legend_layout, pango_font_description_from_string("Sans 9"));
 
-              for (guint line_idx = 0; line_idx < plot_lines->len; line_idx++) {
-                PlotLine *pline = &g_array_index(plot_lines, PlotLine, line_idx);
+              for (guint line_idx = 0; line_idx < plot->series->len; line_idx++) {
+                PlotSeries *pline = &g_array_index(plot->series, PlotSeries, line_idx);
                 Color line_color = colors[line_idx % num_colors];
 
                 double y_pos = legend_y + line_idx * legend_line_height;
@@ -2912,15 +3062,6 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
               g_object_unref(legend_layout);
             }
           }
-
-          // Clean up plot_lines
-          for (guint i = 0; i < plot_lines->len; i++) {
-            PlotLine *pline = &g_array_index(plot_lines, PlotLine, i);
-            g_free(pline->label);
-            g_array_free(pline->x_values, TRUE);
-            g_array_free(pline->y_values, TRUE);
-          }
-          g_array_free(plot_lines, TRUE);
         }
       }
       break;
@@ -2944,6 +3085,166 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
       }
       break;
   }
+}
+
+// Largest cached body surface edge in pixels; bigger shapes are drawn directly
+#define SHAPE_BODY_CACHE_MAX_PIXELS 4096
+
+// Inputs the rasterized body depends on. Text edits bump the element's
+// render generation; style fields are compared directly because context
+// menus and dialogs set them in place.
+typedef struct {
+  guint render_generation;
+  int width;
+  int height;
+  int shape_type;
+  int stroke_width;
+  int stroke_style;
+  int fill_style;
+  gboolean filled;
+  double bg_r, bg_g, bg_b, bg_a;
+  double stroke_r, stroke_g, stroke_b, stroke_a;
+  guint32 seed;   // Text outline jitter; position independent
+  double scale;   // Zoom bucket the surface was rendered at
+} ShapeBodyKey;
+
+struct ShapeBodyCache {
+  cairo_surface_t *surface;
+  ShapeBodyKey key;
+  double margin;  // Canvas units of overdraw kept around the element box
+};
+
+static gboolean shape_body_key_equal(const ShapeBodyKey *a, const ShapeBodyKey *b) {
+  return a->render_generation == b->render_generation &&
+         a->width == b->width && a->height == b->height &&
+         a->shape_type == b->shape_type && a->stroke_width == b->stroke_width &&
+         a->stroke_style == b->stroke_style && a->fill_style == b->fill_style &&
+         a->filled == b->filled &&
+         a->bg_r == b->bg_r && a->bg_g == b->bg_g && a->bg_b == b->bg_b && a->bg_a == b->bg_a &&
+         a->stroke_r == b->stroke_r && a->stroke_g == b->stroke_g &&
+         a->stroke_b == b->stroke_b && a->stroke_a == b->stroke_a &&
+         a->seed == b->seed && a->scale == b->scale;
+}
+
+static void shape_body_cache_free(Shape *shape) {
+  if (!shape->body_cache) return;
+  if (shape->body_cache->surface) cairo_surface_destroy(shape->body_cache->surface);
+  g_free(shape->body_cache);
+  shape->body_cache = NULL;
+}
+
+// Brush text, ASCII art, plots and hatch fills cost far more than a blit
+static gboolean shape_body_is_expensive(Shape *shape) {
+  switch (shape->shape_type) {
+    case SHAPE_TEXT_OUTLINE:
+    case SHAPE_ASCII_ART:
+    case SHAPE_PLOT:
+      return TRUE;
+    default:
+      return shape->filled && shape->fill_style != FILL_STYLE_SOLID;
+  }
+}
+
+// Power-of-two raster scale covering the current zoom and device scale, so
+// small zoom changes reuse the surface
+static double shape_body_scale(Shape *shape) {
+  CanvasData *data = shape->base.canvas_data;
+  double scale = data ? data->zoom_scale : 1.0;
+  if (data && data->drawing_area) {
+    scale *= gtk_widget_get_scale_factor(data->drawing_area);
+  }
+  scale = pow(2.0, ceil(log2(MAX(scale, 1e-3))));
+  return CLAMP(scale, 0.125, 8.0);
+}
+
+static void shape_draw_body_cached(Shape *shape, cairo_t *cr) {
+  Element *element = (Element*)shape;
+  if (!shape_body_is_expensive(shape)) {
+    shape_body_cache_free(shape);
+    shape_draw_body(shape, cr);
+    return;
+  }
+
+  // Same ink extent the spatial index inflates the bounds by
+  double margin = element_get_draw_margin(element);
+  double scale = shape_body_scale(shape);
+  int surface_width = (int)ceil((element->width + 2.0 * margin) * scale);
+  int surface_height = (int)ceil((element->height + 2.0 * margin) * scale);
+  if (surface_width <= 0 || surface_height <= 0 ||
+      surface_width > SHAPE_BODY_CACHE_MAX_PIXELS || surface_height > SHAPE_BODY_CACHE_MAX_PIXELS) {
+    shape_body_cache_free(shape);
+    shape_draw_body(shape, cr);
+    return;
+  }
+
+  ShapeBodyKey key = {
+    .render_generation = element->render_generation,
+    .width = element->width,
+    .height = element->height,
+    .shape_type = shape->shape_type,
+    .stroke_width = shape->stroke_width,
+    .stroke_style = shape->stroke_style,
+    .fill_style = shape->fill_style,
+    .filled = shape->filled,
+    .bg_r = element->bg_r, .bg_g = element->bg_g, .bg_b = element->bg_b, .bg_a = element->bg_a,
+    .stroke_r = shape->stroke_r, .stroke_g = shape->stroke_g,
+    .stroke_b = shape->stroke_b, .stroke_a = shape->stroke_a,
+    .seed = shape->shape_type == SHAPE_TEXT_OUTLINE ? text_outline_seed(shape) : 0,
+    .scale = scale,
+  };
+
+  ShapeBodyCache *cache = shape->body_cache;
+  if (!cache || !shape_body_key_equal(&cache->key, &key)) {
+    shape_body_cache_free(shape);
+
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, surface_width, surface_height);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+      cairo_surface_destroy(surface);
+      shape_draw_body(shape, cr);
+      return;
+    }
+
+    // Render in canvas units with the element box offset by the margin
+    cairo_t *surface_cr = cairo_create(surface);
+    cairo_scale(surface_cr, scale, scale);
+    cairo_translate(surface_cr, margin - element->x, margin - element->y);
+    shape_draw_body(shape, surface_cr);
+    cairo_destroy(surface_cr);
+
+    cache = g_new0(ShapeBodyCache, 1);
+    cache->surface = surface;
+    cache->key = key;
+    cache->margin = margin;
+    shape->body_cache = cache;
+  }
+
+  cairo_save(cr);
+  cairo_translate(cr, element->x - cache->margin, element->y - cache->margin);
+  cairo_scale(cr, 1.0 / scale, 1.0 / scale);
+  cairo_set_source_surface(cr, cache->surface, 0, 0);
+  cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+  cairo_paint(cr);
+  cairo_restore(cr);
+}
+
+static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
+  Shape *shape = (Shape*)element;
+
+  if (shape->editing) {
+    shape_update_text_view_position(shape);
+  }
+
+  // Save cairo state and apply rotation if needed
+  cairo_save(cr);
+  if (element->rotation_degrees != 0.0) {
+    double center_x = element->x + element->width / 2.0;
+    double center_y = element->y + element->height / 2.0;
+    cairo_translate(cr, center_x, center_y);
+    cairo_rotate(cr, element->rotation_degrees * M_PI / 180.0);
+    cairo_translate(cr, -center_x, -center_y);
+  }
+
+  shape_draw_body_cached(shape, cr);
 
   // Restore cairo state before drawing selection UI
   cairo_restore(cr);
@@ -3014,33 +3315,25 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
 
   // Draw text if not editing and text exists (but not for plots - their text is data)
   if (!shape->editing && shape->text && strlen(shape->text) > 0 && shape->shape_type != SHAPE_PLOT && shape->shape_type != SHAPE_TEXT_OUTLINE && shape->shape_type != SHAPE_ASCII_ART) {
-    PangoLayout *layout = pango_cairo_create_layout(cr);
-    PangoFontDescription *font_desc = pango_font_description_from_string(shape->font_description);
-    pango_layout_set_font_description(layout, font_desc);
-    pango_font_description_free(font_desc);
-
-    pango_layout_set_text(layout, shape->text, -1);
-    pango_layout_set_width(layout, (element->width - 20) * PANGO_SCALE);
-    pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
-    pango_layout_set_alignment(layout, element_get_pango_alignment(shape->alignment));
-
-    // Apply strikethrough if enabled
-    if (shape->strikethrough) {
-      PangoAttrList *attrs = pango_attr_list_new();
-      PangoAttribute *strike_attr = pango_attr_strikethrough_new(TRUE);
-      pango_attr_list_insert(attrs, strike_attr);
-      pango_layout_set_attributes(layout, attrs);
-      pango_attr_list_unref(attrs);
-    }
+    int padding = 10;
+    int available_height = element->height - (2 * padding);
 
+    // Layout is cached on the element; overflowing text comes back ellipsized
+    ElementTextLayoutKey key = {
+      .text = shape->text,
+      .font_description = shape->font_description,
+      .wrap_width = element->width - 20,
+      .alignment = element_get_pango_alignment(shape->alignment),
+      .ellipsize = PANGO_ELLIPSIZE_NONE,
+      .strikethrough = shape->strikethrough,
+      .max_height = available_height,
+    };
     int text_width, text_height;
-    pango_layout_get_pixel_size(layout, &text_width, &text_height);
+    PangoLayout *layout = element_get_text_layout(element, cr, &key, &text_width, &text_height);
 
     cairo_set_source_rgba(cr, shape->text_r, shape->text_g, shape->text_b, shape->text_a);
 
     // Position text based on alignment
-    int padding = 10;
-    int available_height = element->height - (2 * padding);
 
     // Calculate horizontal position based on alignment
     int text_x;
@@ -3073,13 +3366,9 @@ static void shape_draw(Element *element, cairo_t *cr, gboolean is_selected) {
       cairo_move_to(cr, text_x, text_y);
       pango_cairo_show_layout(cr, layout);
     } else {
-      pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
-      pango_layout_set_height(layout, available_height * PANGO_SCALE);
       cairo_move_to(cr, text_x, element->y + padding);
       pango_cairo_show_layout(cr, layout);
     }
-
-    g_object_unref(layout);
   }
 
   // Restore cairo state at end
@@ -3145,6 +3434,7 @@ static int shape_pick_connection_point(Element *element, int x, int y) {
 static void shape_start_editing(Element *element, GtkWidget *overlay) {
   Shape *shape = (Shape*)element;
   shape->editing = TRUE;
+  element_invalidate(element);
 
   if (!shape->text_view) {
     // Create scrolled window
@@ -3208,6 +3498,7 @@ void shape_finish_editing(Element *element) {
   model_update_text(model, model_element, new_text);
 
   shape->editing = FALSE;
+  element_invalidate(element);
 
   // Hide the scrolled window instead of the text view
   if (shape->scrolled_window) {
@@ -3257,6 +3548,8 @@ void shape_free(Element *element) {
   if (shape->text) g_free(shape->text);
   if (shape->font_description) g_free(shape->font_description);
   if (shape->alignment) g_free(shape->alignment);
+  shape_body_cache_free(shape);
+  shape_plot_data_free(shape);
   if (shape->scrolled_window && GTK_IS_WIDGET(shape->scrolled_window) &&
       gtk_widget_get_parent(shape->scrolled_window)) {
     gtk_widget_unparent(shape->scrolled_window);
@@ -3264,8 +3557,41 @@ void shape_free(Element *element) {
   g_free(element);
 }
 
+static void shape_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod) {
+  Shape *shape = (Shape*)element;
+
+  switch (shape->shape_type) {
+    case SHAPE_LINE:
+    case SHAPE_ARROW:
+    case SHAPE_BEZIER:
+    case SHAPE_CURVED_ARROW:
+      // A single stroke is already as cheap as any stand-in
+      shape_draw(element, cr, is_selected);
+      return;
+    default:
+      break;
+  }
+
+  if (shape->editing ||
+      (lod == ELEMENT_LOD_SIMPLE && element_text_is_legible(element, shape->text, shape->font_description))) {
+    shape_draw(element, cr, is_selected);
+    return;
+  }
+
+  // Filled shapes become a flat block of their fill (hachure included), outlines stay outlines
+  if (shape->filled) {
+    element_draw_lod_rect(element, cr, is_selected,
+                          element->bg_r, element->bg_g, element->bg_b, element->bg_a, TRUE);
+  } else {
+    element_draw_lod_rect(element, cr, is_selected,
+                          shape->stroke_r, shape->stroke_g, shape->stroke_b, shape->stroke_a,
+                          lod == ELEMENT_LOD_BLOCK);
+  }
+}
+
 static ElementVTable shape_vtable = {
   .draw = shape_draw,
+  .draw_lod = shape_draw_lod,
   .get_connection_point = shape_get_connection_point,
   .pick_resize_handle = shape_pick_resize_handle,
   .pick_connection_point = shape_pick_connection_point,
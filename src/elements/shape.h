@@ -35,6 +35,9 @@ typedef enum {
   FILL_STYLE_CROSS_HATCH = 2
 } FillStyle;
 
+typedef struct ShapeBodyCache ShapeBodyCache;
+typedef struct ShapePlotData ShapePlotData;
+
 typedef struct {
   Element base;
   ShapeType shape_type;
@@ -67,6 +70,8 @@ typedef struct {
   double bezier_p3_v;
   gboolean dragging_control_point;
   int dragging_control_point_index;
+  ShapeBodyCache *body_cache;  // Rasterized body of expensive shape types
+  ShapePlotData *plot_data;    // Parsed SHAPE_PLOT series for the current text
 } Shape;
 
 Shape* shape_create(ElementPosition position,
@@ -93,6 +98,14 @@ void shape_render_text_outline_sample(cairo_t *cr,
                                       double stroke_g,
                                       double stroke_b,
                                       double stroke_a);
+// How far SHAPE_TEXT_OUTLINE brush ink can reach past the element box
+double shape_text_outline_margin(Shape *shape);
+
+// Largest-Triangle-Three-Buckets reduction of a series to threshold points,
+// appended to out_x/out_y. Keeps both endpoints; input of threshold points or
+// fewer (or a threshold below 3) is copied unchanged.
+void shape_plot_downsample(const double *xs, const double *ys, guint count, guint threshold,
+                           GArray *out_x, GArray *out_y);
 
 gboolean shape_is_line_based(Element *element);
 gboolean shape_contains_point(Element *element, int x, int y, double threshold);
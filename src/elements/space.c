@@ -47,30 +47,18 @@ void space_element_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   cairo_set_line_width(cr, 2);
   cairo_stroke(cr);
 
-  // Draw space name
-  PangoLayout *layout = pango_cairo_create_layout(cr);
-  PangoFontDescription *font_desc = pango_font_description_from_string(space_elem->font_description);
-  pango_layout_set_font_description(layout, font_desc);
-  pango_font_description_free(font_desc);
-
-  pango_layout_set_text(layout, space_elem->text, -1);
-
-  // Set text width to fit within the rounded rectangle (with padding)
-  pango_layout_set_width(layout, (width - 40) * PANGO_SCALE); // 20px padding on each side
-  pango_layout_set_alignment(layout, element_get_pango_alignment(space_elem->alignment));
-  pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
-
-  // Apply strikethrough if enabled
-  if (space_elem->strikethrough) {
-    PangoAttrList *attrs = pango_attr_list_new();
-    PangoAttribute *strike_attr = pango_attr_strikethrough_new(TRUE);
-    pango_attr_list_insert(attrs, strike_attr);
-    pango_layout_set_attributes(layout, attrs);
-    pango_attr_list_unref(attrs);
-  }
-
+  // Draw space name, fitted within the rounded rectangle (20px padding on each side)
+  ElementTextLayoutKey key = {
+    .text = space_elem->text,
+    .font_description = space_elem->font_description,
+    .wrap_width = width - 40,
+    .alignment = element_get_pango_alignment(space_elem->alignment),
+    .ellipsize = PANGO_ELLIPSIZE_END,
+    .strikethrough = space_elem->strikethrough,
+    .max_height = -1,
+  };
   int text_width, text_height;
-  pango_layout_get_pixel_size(layout, &text_width, &text_height);
+  PangoLayout *layout = element_get_text_layout(element, cr, &key, &text_width, &text_height);
 
   int padding = 20;
   double text_x = x + padding;
@@ -95,8 +83,6 @@ void space_element_draw(Element *element, cairo_t *cr, gboolean is_selected) {
   cairo_set_source_rgba(cr, space_elem->text_r, space_elem->text_g, space_elem->text_b, space_elem->text_a);
   pango_cairo_show_layout(cr, layout);
 
-  g_object_unref(layout);
-
   // Restore cairo state
   cairo_restore(cr);
 
@@ -232,8 +218,22 @@ void space_element_start_editing(Element *element, GtkWidget *overlay) {
   return;
 }
 
+static void space_element_draw_lod(Element *element, cairo_t *cr, gboolean is_selected, ElementLod lod) {
+  SpaceElement *space_elem = (SpaceElement*)element;
+
+  if (lod == ELEMENT_LOD_SIMPLE &&
+      element_text_is_legible(element, space_elem->text, space_elem->font_description)) {
+    space_element_draw(element, cr, is_selected);
+    return;
+  }
+
+  element_draw_lod_rect(element, cr, is_selected,
+                        element->bg_r, element->bg_g, element->bg_b, element->bg_a, TRUE);
+}
+
 static ElementVTable space_element_vtable = {
   .draw = space_element_draw,
+  .draw_lod = space_element_draw_lod,
   .get_connection_point = space_element_get_connection_point,
   .pick_resize_handle = space_element_pick_resize_handle,
   .pick_connection_point = space_element_pick_connection_point,
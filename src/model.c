@@ -8,17 +8,41 @@
 #include "canvas/canvas_core.h"
 #include <glib.h>
 
+typedef struct {
+  GHashTable *types[MODEL_ELEMENT_TYPE_COUNT];  // Element uuid sets, created on first use
+} ModelSpaceElements;
+
+static void model_space_elements_free(ModelSpaceElements *space) {
+  for (int i = 0; i < MODEL_ELEMENT_TYPE_COUNT; i++) {
+    if (space->types[i]) g_hash_table_destroy(space->types[i]);
+  }
+  g_free(space);
+}
+
 void model_free(Model *model) {
   if (!model) return;
 
+  database_ref_collector_free(model->ref_collector);
+  database_checkpointer_free(model->checkpointer);
+  if (model->read_db && model->read_db != model->db) {
+    database_close(model->read_db);
+  }
+
+  // Arena elements go with the arena; heap ones never enter the table
+  g_hash_table_steal_all(model->elements);
   g_hash_table_destroy(model->elements);
-  g_hash_table_destroy(model->types);
   g_hash_table_destroy(model->texts);
   g_hash_table_destroy(model->positions);
   g_hash_table_destroy(model->sizes);
   g_hash_table_destroy(model->colors);
   g_hash_table_destroy(model->images);
   g_hash_table_destroy(model->videos);
+  g_hash_table_destroy(model->outgoing);
+  g_hash_table_destroy(model->incoming);
+  g_hash_table_destroy(model->space_elements);
+  g_hash_table_destroy(model->dirty);
+  g_hash_table_destroy(model->changed);
+  model_arena_clear(&model->arena);
   g_free(model->current_space_uuid);
   g_free(model->current_space_background_color);
   g_free(model->current_space_name);
@@ -46,9 +70,20 @@ void model_image_free(ModelImage *image) {
   g_free(image);
 }
 
-void model_type_free(ModelType *type) {
-  if (!type) return;
-  g_free(type);
+static ModelType model_types[MODEL_ELEMENT_TYPE_COUNT] = {
+  [ELEMENT_NOTE] = { ELEMENT_NOTE },
+  [ELEMENT_PAPER_NOTE] = { ELEMENT_PAPER_NOTE },
+  [ELEMENT_CONNECTION] = { ELEMENT_CONNECTION },
+  [ELEMENT_SPACE] = { ELEMENT_SPACE },
+  [ELEMENT_MEDIA_FILE] = { ELEMENT_MEDIA_FILE },
+  [ELEMENT_FREEHAND_DRAWING] = { ELEMENT_FREEHAND_DRAWING },
+  [ELEMENT_SHAPE] = { ELEMENT_SHAPE },
+  [ELEMENT_INLINE_TEXT] = { ELEMENT_INLINE_TEXT },
+};
+
+ModelType* model_type_get(ElementType type) {
+  if ((guint)type >= MODEL_ELEMENT_TYPE_COUNT) return NULL;
+  return &model_types[type];
 }
 
 void model_text_free(ModelText *text) {
@@ -77,31 +112,45 @@ void model_color_free(ModelColor *color) {
 void model_element_free(ModelElement *element) {
   if (!element) return;
 
-  g_free(element->uuid);
-  g_free(element->from_element_uuid);
-  g_free(element->to_element_uuid);
-  g_free(element->target_space_uuid);
-  g_free(element->description);
-  g_free(element->created_at);
-  g_free(element->stroke_color);
+  // Strings and drawing points of arena elements stay until the space unloads
+  if (!element->arena) {
+    g_free(element->uuid);
+    g_free(element->space_uuid);
+    g_free(element->from_element_uuid);
+    g_free(element->to_element_uuid);
+    g_free(element->target_space_uuid);
+    g_free(element->description);
+    g_free(element->created_at);
+    g_free(element->stroke_color);
+
+    if (element->drawing_points != NULL) {
+      g_array_free(element->drawing_points, TRUE);
+    }
+  }
 
-  if (element->drawing_points != NULL) {
-    g_array_free(element->drawing_points, TRUE);
+  // Detach the visual from the canvas render list and spatial index so it
+  // is never drawn through a dangling model pointer
+  if (element->visual_element && element->visual_element->canvas_data) {
+    display_list_remove(element->visual_element->canvas_data->display_list, element->visual_element);
+    spatial_index_remove(element->visual_element->canvas_data->spatial_index, element->visual_element);
+    element->visual_element->model_element = NULL;
   }
 
   // Important: Don't free shared resources here!
-  // They are managed by the respective hash tables and will be
-  // automatically freed when the hash tables are destroyed
-  // or when their reference counts drop to zero
+  // They can be shared with other elements and live in the model arena,
+  // which releases them all when the space is unloaded
 
-  g_free(element);
+  if (element->arena) {
+    model_slab_free(&element->arena->elements, element);
+  } else {
+    g_free(element);
+  }
 }
 
 
 Model* model_new_with_file(const char *db_filename) {
   Model *model = g_new0(Model, 1);
-  model->elements = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)model_element_free);
-  model->types = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+  model->elements = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)model_element_free);
   model->texts = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
   model->positions = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
   model->sizes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
@@ -109,6 +158,12 @@ Model* model_new_with_file(const char *db_filename) {
   model->images = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
   model->videos = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
   model->audios = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+  model->outgoing = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)g_array_unref);
+  model->incoming = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)g_array_unref);
+  model->space_elements = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                (GDestroyNotify)model_space_elements_free);
+  model->dirty = g_hash_table_new(g_direct_hash, g_direct_equal);
+  model->changed = g_hash_table_new(g_direct_hash, g_direct_equal);
   model->db = NULL;
 
   model->current_space_background_color = NULL;
@@ -121,6 +176,12 @@ Model* model_new_with_file(const char *db_filename) {
     return NULL;
   }
 
+  if (!database_open_reader(model->db, &model->read_db)) {
+    model->read_db = model->db;
+  }
+  model->checkpointer = database_checkpointer_new(model->db);
+  model->ref_collector = database_ref_collector_new(model->db);
+
   // Get current space UUID
   char *space_uuid = NULL;
   database_get_current_space_uuid(model->db, &space_uuid);
@@ -136,16 +197,24 @@ Model* model_new_with_file(const char *db_filename) {
 void model_load_space(Model *model) {
   if (!model || !model->current_space_uuid) return;
 
-  // Clear current elements and shared resources
-  g_hash_table_remove_all(model->elements);
-  g_hash_table_remove_all(model->types);
+  // Clear current elements and shared resources. The elements, their strings
+  // and refs all live in the arena, so they are dropped without a per-element
+  // destroy; the canvas has already let go of the old visuals.
+  g_hash_table_steal_all(model->elements);
   g_hash_table_remove_all(model->texts);
   g_hash_table_remove_all(model->positions);
   g_hash_table_remove_all(model->sizes);
   g_hash_table_remove_all(model->colors);
+  g_hash_table_remove_all(model->outgoing);
+  g_hash_table_remove_all(model->incoming);
+  g_hash_table_remove_all(model->space_elements);
+  g_hash_table_remove_all(model->dirty);
+  g_hash_table_remove_all(model->changed);
+  model->reloaded = TRUE;
+  model_arena_reset(&model->arena);
 
   // Use database_load_space to populate the model
-  database_load_space(model->db, model);
+  database_load_space(model->read_db, model);
 }
 
 void model_load_space_settings(Model *model, const char *space_uuid) {
@@ -176,7 +245,7 @@ int model_get_space_name(Model *model, const char *space_uuid, char **space_name
     return 0;
   }
 
-  return database_get_space_name(model->db, space_uuid, space_name);
+  return database_get_space_name(model->read_db, space_uuid, space_name);
 }
 
 
@@ -189,6 +258,266 @@ gchar* model_generate_uuid(void) {
   return buf;
 }
 
+UuidHandle model_element_handle(ModelElement *element) {
+  if (!element) return UUID_HANDLE_NONE;
+  if (element->handle == UUID_HANDLE_NONE) {
+    element->handle = uuid_intern(element->uuid);
+  }
+  return element->handle;
+}
+
+UuidHandle model_connection_from(ModelElement *element) {
+  if (!element) return UUID_HANDLE_NONE;
+  if (element->from_handle == UUID_HANDLE_NONE) {
+    element->from_handle = uuid_intern(element->from_element_uuid);
+  }
+  return element->from_handle;
+}
+
+UuidHandle model_connection_to(ModelElement *element) {
+  if (!element) return UUID_HANDLE_NONE;
+  if (element->to_handle == UUID_HANDLE_NONE) {
+    element->to_handle = uuid_intern(element->to_element_uuid);
+  }
+  return element->to_handle;
+}
+
+ModelElement* model_get_element(Model *model, UuidHandle handle) {
+  if (!model || !model->elements || handle == UUID_HANDLE_NONE) return NULL;
+  return g_hash_table_lookup(model->elements, UUID_HANDLE_TO_POINTER(handle));
+}
+
+ModelElement* model_lookup_element(Model *model, const char *uuid) {
+  // A uuid that was never interned cannot belong to a model element
+  return model_get_element(model, uuid_intern_lookup(uuid));
+}
+
+void model_insert_element(Model *model, ModelElement *element) {
+  if (!model || !model->elements || !element || !element->uuid) return;
+  g_hash_table_insert(model->elements, UUID_HANDLE_TO_POINTER(model_element_handle(element)), element);
+}
+
+static void model_index_add(GHashTable *index, UuidHandle endpoint, UuidHandle connection) {
+  GArray *connections = g_hash_table_lookup(index, UUID_HANDLE_TO_POINTER(endpoint));
+  if (!connections) {
+    connections = g_array_new(FALSE, FALSE, sizeof(UuidHandle));
+    g_hash_table_insert(index, UUID_HANDLE_TO_POINTER(endpoint), connections);
+  }
+
+  for (guint i = 0; i < connections->len; i++) {
+    if (g_array_index(connections, UuidHandle, i) == connection) {
+      return;
+    }
+  }
+  g_array_append_val(connections, connection);
+}
+
+void model_index_connection(Model *model, ModelElement *element) {
+  if (!model || !model->outgoing || !element || !element->uuid) return;
+
+  // The uuid strings may have been re-pointed since the handles were taken
+  element->from_handle = UUID_HANDLE_NONE;
+  element->to_handle = UUID_HANDLE_NONE;
+  UuidHandle from = model_connection_from(element);
+  UuidHandle to = model_connection_to(element);
+
+  if (from != UUID_HANDLE_NONE) {
+    model_index_add(model->outgoing, from, model_element_handle(element));
+  }
+  if (to != UUID_HANDLE_NONE) {
+    model_index_add(model->incoming, to, model_element_handle(element));
+  }
+}
+
+// Append the connections indexed under an element that still exist and still
+// end there. Stale entries are pruned on the way, so removals need no
+// bookkeeping.
+static void model_collect_connections(Model *model, GHashTable *index, UuidHandle handle, GPtrArray *out) {
+  GArray *connections = index ? g_hash_table_lookup(index, UUID_HANDLE_TO_POINTER(handle)) : NULL;
+  if (!connections) return;
+
+  gboolean outgoing = index == model->outgoing;
+  guint i = 0;
+  while (i < connections->len) {
+    ModelElement *connection = model_get_element(model, g_array_index(connections, UuidHandle, i));
+    UuidHandle endpoint = UUID_HANDLE_NONE;
+    if (connection) {
+      endpoint = outgoing ? model_connection_from(connection) : model_connection_to(connection);
+    }
+    if (endpoint != handle) {
+      g_array_remove_index_fast(connections, i);
+      continue;
+    }
+    g_ptr_array_add(out, connection);
+    i++;
+  }
+
+  if (connections->len == 0) {
+    g_hash_table_remove(index, UUID_HANDLE_TO_POINTER(handle));
+  }
+}
+
+void model_collect_element_connections(Model *model, ModelElement *element, GPtrArray *out) {
+  if (!model || !element || !element->uuid) return;
+
+  UuidHandle handle = model_element_handle(element);
+  model_collect_connections(model, model->outgoing, handle, out);
+  model_collect_connections(model, model->incoming, handle, out);
+}
+
+static GHashTable* model_space_bucket(Model *model, const char *space_uuid, ElementType type, gboolean create) {
+  if (!model->space_elements || !space_uuid || (guint)type >= MODEL_ELEMENT_TYPE_COUNT) {
+    return NULL;
+  }
+
+  ModelSpaceElements *space = g_hash_table_lookup(model->space_elements, space_uuid);
+  if (!space) {
+    if (!create) return NULL;
+    space = g_new0(ModelSpaceElements, 1);
+    g_hash_table_insert(model->space_elements, g_strdup(space_uuid), space);
+  }
+  if (!space->types[type] && create) {
+    space->types[type] = g_hash_table_new(g_direct_hash, g_direct_equal);
+  }
+  return space->types[type];
+}
+
+void model_index_element(Model *model, ModelElement *element) {
+  if (!model || !element || !element->uuid || !element->type) return;
+
+  model_index_connection(model, element);
+  if (element->state == MODEL_STATE_DELETED) return;
+
+  GHashTable *bucket = model_space_bucket(model, element->space_uuid, element->type->type, TRUE);
+  if (bucket) {
+    g_hash_table_add(bucket, UUID_HANDLE_TO_POINTER(model_element_handle(element)));
+  }
+}
+
+static void model_unindex_element(Model *model, ModelElement *element) {
+  if (!element->uuid || !element->type) return;
+
+  GHashTable *bucket = model_space_bucket(model, element->space_uuid, element->type->type, FALSE);
+  if (bucket) {
+    g_hash_table_remove(bucket, UUID_HANDLE_TO_POINTER(model_element_handle(element)));
+  }
+}
+
+void model_collect_space_elements(Model *model, const char *space_uuid, guint type_mask, GPtrArray *out) {
+  if (!model || !model->space_elements || !space_uuid || !out) return;
+
+  ModelSpaceElements *space = g_hash_table_lookup(model->space_elements, space_uuid);
+  if (!space) return;
+
+  for (int type = 0; type < MODEL_ELEMENT_TYPE_COUNT; type++) {
+    if (!space->types[type] || !(type_mask & MODEL_TYPE_BIT(type))) continue;
+
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, space->types[type]);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+      ModelElement *element = model_get_element(model, UUID_POINTER_TO_HANDLE(key));
+      // Drop entries for elements that left the model, moved away or were deleted
+      if (!element || element->state == MODEL_STATE_DELETED ||
+          g_strcmp0(element->space_uuid, space_uuid) != 0) {
+        g_hash_table_iter_remove(&iter);
+        continue;
+      }
+      g_ptr_array_add(out, element);
+    }
+  }
+}
+
+void model_mark_dirty(Model *model, ModelElement *element) {
+  if (!model || !model->dirty || !element || !element->uuid) return;
+
+  gpointer key = UUID_HANDLE_TO_POINTER(model_element_handle(element));
+  g_hash_table_add(model->dirty, key);
+  if (model->changed) {
+    g_hash_table_add(model->changed, key);
+  }
+}
+
+GList* model_take_changed(Model *model, gboolean *reloaded) {
+  if (reloaded) *reloaded = FALSE;
+  if (!model || !model->elements) return NULL;
+
+  GList *elements = NULL;
+  if (model->reloaded) {
+    elements = g_hash_table_get_values(model->elements);
+    if (reloaded) *reloaded = TRUE;
+  } else if (model->changed) {
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, model->changed);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+      // Elements already saved away after deletion are skipped
+      ModelElement *element = model_get_element(model, UUID_POINTER_TO_HANDLE(key));
+      if (element) {
+        elements = g_list_prepend(elements, element);
+      }
+    }
+  }
+
+  model->reloaded = FALSE;
+  if (model->changed) {
+    g_hash_table_remove_all(model->changed);
+  }
+  return g_list_sort(elements, (GCompareFunc)model_compare_for_saving_loading);
+}
+
+void model_element_set_string(ModelElement *element, char **field, const char *value) {
+  if (!element || !field) return;
+
+  if (element->arena) {
+    model_arena_set_string(element->arena, field, value);
+  } else {
+    g_free(*field);
+    *field = g_strdup(value);
+  }
+}
+
+// Clones share ref structs, so an edit through one of them changes what
+// every sharer draws. Only the edited element is saved; the others are
+// queued for the canvas alone.
+static void model_mark_ref_sharers_changed(Model *model, ModelElement *element, guint fields) {
+  if (!model || !model->changed || !model->elements) return;
+
+  ModelPosition *position = (fields & MODEL_FIELD_POSITION) && element->position &&
+                            element->position->ref_count > 1 ? element->position : NULL;
+  ModelSize *size = (fields & MODEL_FIELD_SIZE) && element->size &&
+                    element->size->ref_count > 1 ? element->size : NULL;
+  ModelText *text = (fields & MODEL_FIELD_TEXT) && element->text &&
+                    element->text->ref_count > 1 ? element->text : NULL;
+  ModelColor *color = (fields & MODEL_FIELD_COLOR) && element->bg_color &&
+                      element->bg_color->ref_count > 1 ? element->bg_color : NULL;
+  if (!position && !size && !text && !color) return;
+
+  GHashTableIter iter;
+  gpointer key, value;
+  g_hash_table_iter_init(&iter, model->elements);
+  while (g_hash_table_iter_next(&iter, &key, &value)) {
+    ModelElement *other = value;
+    if (other == element || other->state == MODEL_STATE_DELETED) continue;
+
+    if ((position && other->position == position) || (size && other->size == size) ||
+        (text && other->text == text) || (color && other->bg_color == color)) {
+      g_hash_table_add(model->changed, key);
+    }
+  }
+}
+
+void model_mark_updated(Model *model, ModelElement *element, guint fields) {
+  if (!element) return;
+
+  if (element->state != MODEL_STATE_NEW) {
+    element->state = MODEL_STATE_UPDATED;
+    element->changed_fields |= fields;
+  }
+  model_mark_dirty(model, element);
+  model_mark_ref_sharers_changed(model, element, fields);
+}
+
 ModelElement* model_create_element(Model *model, ElementConfig config) {
   if (model == NULL) {
     g_printerr("Error: model is NULL in model_create_element\n");
@@ -196,21 +525,20 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
   }
 
   // Create a new ModelElement
-  ModelElement *element = g_new0(ModelElement, 1);
-  element->uuid = model_generate_uuid();
+  ModelElement *element = model_slab_new0(&model->arena.elements, ModelElement);
+  element->arena = &model->arena;
+  gchar *uuid = model_generate_uuid();
+  element->uuid = model_arena_strdup(&model->arena, uuid);
+  g_free(uuid);
+  element->handle = uuid_intern(element->uuid);
   element->state = MODEL_STATE_NEW;
 
-  element->space_uuid = g_strdup(model->current_space_uuid);
+  element->space_uuid = model_arena_strdup(&model->arena, model->current_space_uuid);
 
-  // Create type reference
-  ModelType *model_type = g_new0(ModelType, 1);
-  model_type->id = -1;  // Temporary ID until saved to database
-  model_type->type = config.type;
-  model_type->ref_count = 1;
-  element->type = model_type;
+  element->type = model_type_get(config.type);
 
   // Create position reference
-  ModelPosition *position = g_new0(ModelPosition, 1);
+  ModelPosition *position = model_slab_new0(&model->arena.positions, ModelPosition);
   position->id = -1;  // Temporary ID until saved to database
   position->x = config.position.x;
   position->y = config.position.y;
@@ -219,7 +547,7 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
   element->position = position;
 
   // Create size reference
-  ModelSize *size = g_new0(ModelSize, 1);
+  ModelSize *size = model_slab_new0(&model->arena.sizes, ModelSize);
   size->id = -1;  // Temporary ID until saved to database
   size->width = config.size.width;
   size->height = config.size.height;
@@ -228,10 +556,10 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
 
   // Create text reference if text is provided
   if (config.text.text != NULL) {
-    ModelText *model_text = g_new0(ModelText, 1);
+    ModelText *model_text = model_slab_new0(&model->arena.texts, ModelText);
     model_text->id = -1;  // Temporary ID until saved to database
-    model_text->text = g_strdup(config.text.text);
-    model_text->font_description = g_strdup(config.text.font_description);
+    model_text->text = model_arena_strdup(&model->arena, config.text.text);
+    model_text->font_description = model_arena_strdup(&model->arena, config.text.font_description);
     model_text->r = config.text.text_color.r;
     model_text->g = config.text.text_color.g;
     model_text->b = config.text.text_color.b;
@@ -240,18 +568,18 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
 
     // Use alignment from config if provided, otherwise set default based on element type
     if (config.text.alignment) {
-      model_text->alignment = g_strdup(config.text.alignment);
+      model_text->alignment = model_arena_strdup(&model->arena, config.text.alignment);
     } else if (config.type == ELEMENT_PAPER_NOTE) {
-      model_text->alignment = g_strdup("top-left");
+      model_text->alignment = model_arena_strdup(&model->arena, "top-left");
     } else {
-      model_text->alignment = g_strdup("center");
+      model_text->alignment = model_arena_strdup(&model->arena, "center");
     }
 
     element->text = model_text;
   }
 
   // Always create background color, even if transparent
-  ModelColor *color = g_new0(ModelColor, 1);
+  ModelColor *color = model_slab_new0(&model->arena.colors, ModelColor);
   color->id = -1;  // Temporary ID until saved to database
   color->r = config.bg_color.r;
   color->g = config.bg_color.g;
@@ -261,12 +589,8 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
   element->bg_color = color;
 
   // Set connection properties
-  if (config.connection.from_element_uuid) {
-    element->from_element_uuid = g_strdup(config.connection.from_element_uuid);
-  }
-  if (config.connection.to_element_uuid) {
-    element->to_element_uuid = g_strdup(config.connection.to_element_uuid);
-  }
+  element->from_element_uuid = model_arena_strdup(&model->arena, config.connection.from_element_uuid);
+  element->to_element_uuid = model_arena_strdup(&model->arena, config.connection.to_element_uuid);
   if (config.connection.from_point) {
     element->from_point = config.connection.from_point;
   }
@@ -341,7 +665,8 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
   }
 
   if (config.drawing.drawing_points != NULL) {
-    element->drawing_points = g_array_copy((GArray*)config.drawing.drawing_points);
+    element->drawing_points = model_arena_adopt_array(&model->arena,
+                                                      g_array_copy((GArray*)config.drawing.drawing_points));
   } else {
     element->drawing_points = NULL;
   }
@@ -354,11 +679,13 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
 
   // Convert stroke color from ElementColor to hex string
   if (config.shape.stroke_color.a > 0.0) {
-    element->stroke_color = g_strdup_printf("#%02x%02x%02x%02x",
+    gchar stroke_color[10];
+    g_snprintf(stroke_color, sizeof(stroke_color), "#%02x%02x%02x%02x",
       (int)(config.shape.stroke_color.r * 255),
       (int)(config.shape.stroke_color.g * 255),
       (int)(config.shape.stroke_color.b * 255),
       (int)(config.shape.stroke_color.a * 255));
+    element->stroke_color = model_arena_strdup(&model->arena, stroke_color);
   } else {
     element->stroke_color = NULL;
   }
@@ -382,7 +709,9 @@ ModelElement* model_create_element(Model *model, ElementConfig config) {
   // Set rotation from config
   element->rotation_degrees = config.rotation_degrees;
 
-  g_hash_table_insert(model->elements, g_strdup(element->uuid), element);
+  model_insert_element(model, element);
+  model_index_element(model, element);
+  model_mark_dirty(model, element);
 
   return element;
 }
@@ -433,12 +762,12 @@ int model_update_text(Model *model, ModelElement *element, const char *text) {
 
   // If element has no text reference, create one
   if (!element->text) {
-    element->text = g_new0(ModelText, 1);
-    element->text->text = g_strdup(text);
+    element->text = model_slab_new0(&model->arena.texts, ModelText);
+    element->text->text = model_arena_strdup(&model->arena, text);
     element->text->ref_count = 1;
 
     // Initialize default font and colors
-    element->text->font_description = g_strdup("Sans 14");
+    element->text->font_description = model_arena_strdup(&model->arena, "Sans 14");
     element->text->r = 1.0;
     element->text->g = 1.0;
     element->text->b = 1.0;
@@ -447,24 +776,19 @@ int model_update_text(Model *model, ModelElement *element, const char *text) {
 
     // Set default alignment based on element type
     if (element->type && element->type->type == ELEMENT_PAPER_NOTE) {
-      element->text->alignment = g_strdup("top-left");
+      element->text->alignment = model_arena_strdup(&model->arena, "top-left");
     } else {
-      element->text->alignment = g_strdup("center");
+      element->text->alignment = model_arena_strdup(&model->arena, "center");
     }
 
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_TEXT | MODEL_FIELD_REFS);
     return 1;
   }
 
   // If text content changed, update it
   if (!element->text->text || strcmp(element->text->text, text) != 0) {
-    g_free(element->text->text);
-    element->text->text = g_strdup(text);
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_element_set_string(element, &element->text->text, text);
+    model_mark_updated(model, element, MODEL_FIELD_TEXT);
     return 1;
   }
 
@@ -485,9 +809,7 @@ int model_update_text_color(Model *model, ModelElement *element, double r, doubl
     element->text->g = g;
     element->text->b = b;
     element->text->a = a;
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_TEXT);
     return 1;
   }
 
@@ -502,11 +824,8 @@ int model_update_font(Model *model, ModelElement *element, const char *font_desc
   // If font description changed, update it
   if (!element->text->font_description ||
       strcmp(element->text->font_description, font_description) != 0) {
-    g_free(element->text->font_description);
-    element->text->font_description = g_strdup(font_description);
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_element_set_string(element, &element->text->font_description, font_description);
+    model_mark_updated(model, element, MODEL_FIELD_TEXT);
     return 1;
   }
 
@@ -526,11 +845,8 @@ int model_update_text_alignment(Model *model, ModelElement *element, const char
   // If alignment changed, update it
   if (!element->text->alignment ||
       strcmp(element->text->alignment, alignment) != 0) {
-    g_free(element->text->alignment);
-    element->text->alignment = g_strdup(alignment);
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_element_set_string(element, &element->text->alignment, alignment);
+    model_mark_updated(model, element, MODEL_FIELD_TEXT);
     return 1;
   }
 
@@ -550,9 +866,7 @@ int model_update_strikethrough(Model *model, ModelElement *element, gboolean str
   // If strikethrough changed, update it
   if (element->text->strikethrough != strikethrough) {
     element->text->strikethrough = strikethrough;
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_TEXT);
     return 1;
   }
 
@@ -569,9 +883,7 @@ int model_update_color(Model *model, ModelElement *element, double r, double g,
   color->b = b;
   color->a = a;
 
-  if (element->state != MODEL_STATE_NEW) {
-    element->state = MODEL_STATE_UPDATED;
-  }
+  model_mark_updated(model, element, MODEL_FIELD_COLOR);
 
   return 1;
 }
@@ -583,13 +895,11 @@ int model_update_position(Model *model, ModelElement *element, int x, int y, int
 
   // If element has no position reference, create one
   if (!element->position) {
-    element->position = g_new0(ModelPosition, 1);
+    element->position = model_slab_new0(&model->arena.positions, ModelPosition);
     element->position->x = x;
     element->position->y = y;
     element->position->z = z;
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_POSITION | MODEL_FIELD_REFS);
     return 1;
   }
 
@@ -598,9 +908,7 @@ int model_update_position(Model *model, ModelElement *element, int x, int y, int
     element->position->x = x;
     element->position->y = y;
     element->position->z = z;
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_POSITION);
     return 1;
   }
 
@@ -614,12 +922,10 @@ int model_update_size(Model *model, ModelElement *element, int width, int height
 
   // If element has no size reference, create one
   if (!element->size) {
-    element->size = g_new0(ModelSize, 1);
+    element->size = model_slab_new0(&model->arena.sizes, ModelSize);
     element->size->width = width;
     element->size->height = height;
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_SIZE | MODEL_FIELD_REFS);
     return 1;
   }
 
@@ -627,9 +933,7 @@ int model_update_size(Model *model, ModelElement *element, int width, int height
   if (element->size->width != width || element->size->height != height) {
     element->size->width = width;
     element->size->height = height;
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_SIZE);
     return 1;
   }
 
@@ -645,11 +949,29 @@ int model_update_locked(Model *model, ModelElement *element, gboolean locked) {
   if (element->locked != locked) {
     element->locked = locked;
 
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
+    model_mark_updated(model, element, MODEL_FIELD_LOCKED);
+  }
+
+  return 1;
+}
+
+int model_update_drawing_points(Model *model, ModelElement *element, const DrawingPoint *points, guint count) {
+  if (!model || !element || (!points && count > 0)) {
+    return 0;
+  }
+
+  // Refill the existing array; arena elements share theirs with the arena
+  if (element->drawing_points) {
+    g_array_set_size(element->drawing_points, 0);
+  } else {
+    element->drawing_points = g_array_sized_new(FALSE, FALSE, sizeof(DrawingPoint), count);
+    if (element->arena) {
+      model_arena_adopt_array(element->arena, element->drawing_points);
     }
   }
+  g_array_append_vals(element->drawing_points, points, count);
 
+  model_mark_updated(model, element, MODEL_FIELD_SHAPE);
   return 1;
 }
 
@@ -671,9 +993,7 @@ int model_update_rotation(Model *model, ModelElement *element, double rotation_d
       element->visual_element->rotation_degrees = rotation_degrees;
     }
 
-    if (element->state != MODEL_STATE_NEW) {
-      element->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, element, MODEL_FIELD_ROTATION);
     return 1;
   }
 
@@ -692,31 +1012,22 @@ int model_delete_element(Model *model, ModelElement *element) {
 
   // Mark element as deleted
   element->state = MODEL_STATE_DELETED;
+  model_unindex_element(model, element);
+  model_mark_dirty(model, element);
 
   // If this is NOT a connection element, find and mark any connections that reference it
-  if (element->type->type != ELEMENT_CONNECTION) {
-    GHashTableIter iter;
-    gpointer key, value;
-
-    g_hash_table_iter_init(&iter, model->elements);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-      ModelElement *current_element = (ModelElement*)value;
-
-      // Only check connection elements that aren't already marked for deletion
-      if (current_element->type->type == ELEMENT_CONNECTION &&
-          current_element->state != MODEL_STATE_DELETED) {
-
-        // Check if this connection references the element being deleted
-        if ((current_element->from_element_uuid && element->uuid &&
-             strcmp(current_element->from_element_uuid, element->uuid) == 0) ||
-            (current_element->to_element_uuid && element->uuid &&
-             strcmp(current_element->to_element_uuid, element->uuid) == 0)) {
-
-          // Mark this connection for deletion too
-          model_delete_element(model, current_element);
-        }
+  if (element->type->type != ELEMENT_CONNECTION && element->uuid) {
+    GPtrArray *connections = g_ptr_array_new();
+    model_collect_element_connections(model, element, connections);
+
+    for (guint i = 0; i < connections->len; i++) {
+      ModelElement *connection = g_ptr_array_index(connections, i);
+      // Mark this connection for deletion too
+      if (connection->type->type == ELEMENT_CONNECTION) {
+        model_delete_element(model, connection);
       }
     }
+    g_ptr_array_free(connections, TRUE);
   }
 
   return 1;
@@ -887,10 +1198,7 @@ ModelElement* model_element_clone(Model *model, ModelElement *element, CloneFlag
 
   // Clone text if requested and available
   if ((flags & CLONE_FLAG_TEXT) && element->text && cloned_element->text) {
-    g_free(cloned_element->text->text);
-    g_free(cloned_element->text->font_description);
-    g_free(cloned_element->text->alignment);
-    g_free(cloned_element->text);
+    model_slab_free(&model->arena.texts, cloned_element->text);
 
     cloned_element->text = element->text;
     cloned_element->text->ref_count++;
@@ -898,7 +1206,7 @@ ModelElement* model_element_clone(Model *model, ModelElement *element, CloneFlag
 
   // Clone size if requested and available
   if ((flags & CLONE_FLAG_SIZE) && element->size && cloned_element->size) {
-    g_free(cloned_element->size);
+    model_slab_free(&model->arena.sizes, cloned_element->size);
 
     cloned_element->size = element->size;
     cloned_element->size->ref_count++;
@@ -906,7 +1214,7 @@ ModelElement* model_element_clone(Model *model, ModelElement *element, CloneFlag
 
   // Clone position if requested and available
   if ((flags & CLONE_FLAG_POSITION) && element->position && cloned_element->position) {
-    g_free(cloned_element->position);
+    model_slab_free(&model->arena.positions, cloned_element->position);
 
     cloned_element->position = element->position;
     cloned_element->position->ref_count++;
@@ -914,7 +1222,7 @@ ModelElement* model_element_clone(Model *model, ModelElement *element, CloneFlag
 
   // Clone color if requested and available
   if ((flags & CLONE_FLAG_COLOR) && element->bg_color && cloned_element->bg_color) {
-    g_free(cloned_element->bg_color);
+    model_slab_free(&model->arena.colors, cloned_element->bg_color);
 
     cloned_element->bg_color = element->bg_color;
     cloned_element->bg_color->ref_count++;
@@ -923,6 +1231,50 @@ ModelElement* model_element_clone(Model *model, ModelElement *element, CloneFlag
   return cloned_element;
 }
 
+// Orphaned refs are deleted off the main thread, so neither a save nor the
+// main loop pays for scanning the ref tables. Databases without a collector
+// connection are small in-memory ones and collect right after the save.
+static void model_schedule_ref_collection(Model *model) {
+  if (model->ref_collector) {
+    database_ref_collector_request(model->ref_collector);
+  } else {
+    database_collect_orphaned_refs(model->db, -1);
+  }
+}
+
+// Remember which of an element's refs have no row yet, so ids handed out
+// inside a rolled back transaction can be cleared again
+static void model_collect_unsaved_ref_ids(ModelElement *element, GPtrArray *ids) {
+  if (element->position && element->position->id == -1) g_ptr_array_add(ids, &element->position->id);
+  if (element->size && element->size->id == -1) g_ptr_array_add(ids, &element->size->id);
+  if (element->text && element->text->id == -1) g_ptr_array_add(ids, &element->text->id);
+  if (element->bg_color && element->bg_color->id == -1) g_ptr_array_add(ids, &element->bg_color->id);
+  if (element->image && element->image->id == -1) g_ptr_array_add(ids, &element->image->id);
+  if (element->video && element->video->id == -1) g_ptr_array_add(ids, &element->video->id);
+  if (element->audio && element->audio->id == -1) g_ptr_array_add(ids, &element->audio->id);
+}
+
+static void model_cache_element_refs(Model *model, ModelElement *element) {
+  if (element->position && element->position->id > 0) {
+    g_hash_table_insert(model->positions, GINT_TO_POINTER(element->position->id), element->position);
+  }
+  if (element->size && element->size->id > 0) {
+    g_hash_table_insert(model->sizes, GINT_TO_POINTER(element->size->id), element->size);
+  }
+  if (element->text && element->text->id > 0) {
+    g_hash_table_insert(model->texts, GINT_TO_POINTER(element->text->id), element->text);
+  }
+  if (element->bg_color && element->bg_color->id > 0) {
+    g_hash_table_insert(model->colors, GINT_TO_POINTER(element->bg_color->id), element->bg_color);
+  }
+  if (element->image && element->image->id > 0) {
+    g_hash_table_insert(model->images, GINT_TO_POINTER(element->image->id), element->image);
+  }
+  if (element->video && element->video->id > 0) {
+    g_hash_table_insert(model->videos, GINT_TO_POINTER(element->video->id), element->video);
+  }
+}
+
 int model_save_elements(Model *model) {
   if (!model || !model->db) {
     return 0;
@@ -937,28 +1289,37 @@ int model_save_elements(Model *model) {
 
   int saved_count = 0;
   int error_occurred = 0;
-  GList *to_remove = NULL;
 
-  // FIRST: Process DELETIONS with connections first order
+  // Only queued elements can need work. Entries for elements that have
+  // since left the model or were saved already are dropped here.
   GList *deleted_elements = NULL;
+  GList *elements_to_save = NULL;
   GHashTableIter iter;
-  gpointer key, value;
+  gpointer key;
+
+  g_hash_table_iter_init(&iter, model->dirty);
+  while (g_hash_table_iter_next(&iter, &key, NULL)) {
+    ModelElement *element = model_get_element(model, UUID_POINTER_TO_HANDLE(key));
+    if (!element) continue;
 
-  // Collect all deleted elements
-  g_hash_table_iter_init(&iter, model->elements);
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *element = (ModelElement *)value;
     if (element->state == MODEL_STATE_DELETED) {
       deleted_elements = g_list_prepend(deleted_elements, element);
+    } else if (element->state == MODEL_STATE_NEW || element->state == MODEL_STATE_UPDATED) {
+      elements_to_save = g_list_prepend(elements_to_save, element);
     }
   }
+  g_hash_table_remove_all(model->dirty);
+
+  // The batch is one transaction: element states, ref caches and removals
+  // only change once it commits, and a rollback re-queues all of it
+  GPtrArray *unsaved_ref_ids = g_ptr_array_new();
 
+  // FIRST: Process DELETIONS with connections first order
   // Sort deletions: connections first, then elements
   deleted_elements = g_list_sort(deleted_elements, (GCompareFunc)model_compare_for_deletion);
 
   // Process deletions in proper order
-  GList *del_iter = deleted_elements;
-  while (del_iter != NULL) {
+  for (GList *del_iter = deleted_elements; del_iter && !error_occurred; del_iter = del_iter->next) {
     ModelElement *element = (ModelElement *)del_iter->data;
 
     // Check if element exists in database
@@ -994,120 +1355,109 @@ int model_save_elements(Model *model) {
         g_free(db_element);
       }
     }
-
-    to_remove = g_list_append(to_remove, g_strdup(element->uuid));
-    del_iter = del_iter->next;
   }
 
-  g_list_free(deleted_elements);
-
-  // Recalculate ref_counts from actual DB state, then cleanup orphaned refs
-  database_recalculate_ref_counts(model->db);
-  cleanup_database_references(model->db);
+  // Ref counts follow the elements rows via triggers; deleted elements
+  // leave orphaned refs for the background collector
+  gboolean refs_released = deleted_elements != NULL;
 
   // SECOND: Process NEW and UPDATED elements with elements first order
-  GList *elements_to_save = NULL;
-
-  // Collect all elements that need to be saved (NEW or UPDATED)
-  g_hash_table_iter_init(&iter, model->elements);
-  while (g_hash_table_iter_next(&iter, &key, &value)) {
-    ModelElement *element = (ModelElement *)value;
-    if (element->state == MODEL_STATE_NEW || element->state == MODEL_STATE_UPDATED) {
-      elements_to_save = g_list_prepend(elements_to_save, element);
-    }
-  }
-
   // Sort for saving: elements first, then connections
   elements_to_save = g_list_sort(elements_to_save, (GCompareFunc)model_compare_for_saving_loading);
 
   // Process saves in proper order
-  GList *save_iter = elements_to_save;
-  while (save_iter != NULL) {
+  for (GList *save_iter = elements_to_save; save_iter && !error_occurred; save_iter = save_iter->next) {
     ModelElement *element = (ModelElement *)save_iter->data;
 
+    model_collect_unsaved_ref_ids(element, unsaved_ref_ids);
+
     if (element->state == MODEL_STATE_NEW) {
       if (element->type->type == ELEMENT_SPACE) {
         char *target_space_uuid = NULL;
         if (!database_create_space(model->db, element->text->text, model->current_space_uuid, &target_space_uuid)) {
           g_error("Failed to create target space");
         }
-        element->target_space_uuid = target_space_uuid;
+        model_element_set_string(element, &element->target_space_uuid, target_space_uuid);
+        g_free(target_space_uuid);
       }
 
       // Save NEW elements to database
       const char *target_space_uuid = element->space_uuid ? element->space_uuid : model->current_space_uuid;
       if (database_create_element(model->db, target_space_uuid, element)) {
-        // Add shared resources to model caches
-        if (element->type && element->type->id > 0) {
-          g_hash_table_insert(model->types, GINT_TO_POINTER(element->type->id), element->type);
-        }
-        if (element->position && element->position->id > 0) {
-          g_hash_table_insert(model->positions, GINT_TO_POINTER(element->position->id), element->position);
-        }
-        if (element->size && element->size->id > 0) {
-          g_hash_table_insert(model->sizes, GINT_TO_POINTER(element->size->id), element->size);
-        }
-        if (element->text && element->text->id > 0) {
-          g_hash_table_insert(model->texts, GINT_TO_POINTER(element->text->id), element->text);
-        }
-        if (element->bg_color && element->bg_color->id > 0) {
-          g_hash_table_insert(model->colors, GINT_TO_POINTER(element->bg_color->id), element->bg_color);
-        }
-        if (element->image && element->image->id > 0) {
-          g_hash_table_insert(model->images, GINT_TO_POINTER(element->image->id), element->image);
-        }
-        if (element->video && element->video->id > 0) {
-          g_hash_table_insert(model->videos, GINT_TO_POINTER(element->video->id), element->video);
-        }
-
-        // Change state to SAVED
-        element->state = MODEL_STATE_SAVED;
         saved_count++;
       } else {
         fprintf(stderr, "Failed to save element %s to database\n", element->uuid);
         error_occurred = 1;
       }
     } else if (element->state == MODEL_STATE_UPDATED) {
-      // Handle space element updates - set parent UUID
-      if (element->type->type == ELEMENT_SPACE && element->target_space_uuid) {
+      // Handle space element moves - set parent UUID
+      if (element->type->type == ELEMENT_SPACE && element->target_space_uuid &&
+          (!element->changed_fields || (element->changed_fields & MODEL_FIELD_SPACE))) {
         if (!database_set_space_parent_id(model->db, element->target_space_uuid, element->space_uuid)) {
           fprintf(stderr, "Failed to update parent for space %s\n", element->target_space_uuid);
         }
       }
 
       if (database_update_element(model->db, element->uuid, element)) {
-        // Change state back to SAVED
-        element->state = MODEL_STATE_SAVED;
+        if (!element->changed_fields || (element->changed_fields & MODEL_FIELD_REFS)) {
+          refs_released = TRUE;
+        }
         saved_count++;
       } else {
         fprintf(stderr, "Failed to update element %s in database\n", element->uuid);
         error_occurred = 1;
       }
     }
+  }
 
-    save_iter = save_iter->next;
+  if (error_occurred) {
+    database_rollback_transaction(model->db);
+  } else if (!database_commit_transaction(model->db)) {
+    fprintf(stderr, "Failed to commit transaction\n");
+    database_rollback_transaction(model->db);
+    error_occurred = 1;
   }
 
-  g_list_free(elements_to_save);
+  if (error_occurred) {
+    // Nothing from this batch reached the database: forget ref ids it
+    // handed out and keep every element queued in its current state
+    for (guint i = 0; i < unsaved_ref_ids->len; i++) {
+      *(gint *)g_ptr_array_index(unsaved_ref_ids, i) = -1;
+    }
+    for (GList *l = deleted_elements; l; l = l->next) {
+      g_hash_table_add(model->dirty, UUID_HANDLE_TO_POINTER(model_element_handle(l->data)));
+    }
+    for (GList *l = elements_to_save; l; l = l->next) {
+      g_hash_table_add(model->dirty, UUID_HANDLE_TO_POINTER(model_element_handle(l->data)));
+    }
+    saved_count = 0;
+  } else {
+    for (GList *l = elements_to_save; l; l = l->next) {
+      ModelElement *element = (ModelElement *)l->data;
+      if (element->state == MODEL_STATE_NEW) {
+        // Add shared resources to model caches
+        model_cache_element_refs(model, element);
+      }
+      element->state = MODEL_STATE_SAVED;
+      element->changed_fields = 0;
+    }
 
-  // Remove deleted elements from model after all processing is complete
-  GList *iter_list = to_remove;
-  while (iter_list) {
-    char *uuid = (char *)iter_list->data;
-    g_hash_table_remove(model->elements, uuid);
-    g_free(uuid);
-    iter_list = iter_list->next;
+    // Remove deleted elements from model after all processing is complete
+    for (GList *l = deleted_elements; l; l = l->next) {
+      g_hash_table_remove(model->elements, UUID_HANDLE_TO_POINTER(model_element_handle(l->data)));
+    }
   }
-  g_list_free(to_remove);
+
+  g_ptr_array_free(unsaved_ref_ids, TRUE);
+  g_list_free(deleted_elements);
+  g_list_free(elements_to_save);
 
   if (error_occurred) {
-    database_rollback_transaction(model->db);
     return 0;
   }
 
-  if (!database_commit_transaction(model->db)) {
-    fprintf(stderr, "Failed to commit transaction\n");
-    return 0;
+  if (refs_released) {
+    model_schedule_ref_collection(model);
   }
 
   return saved_count;
@@ -1164,14 +1514,14 @@ ModelElement* model_get_by_visual(Model *model, Element *visual_element) {
 }
 
 int model_get_amount_of_elements(Model *model, const char *space_uuid) {
-  return database_get_amount_of_elements(model->db, space_uuid);
+  return database_get_amount_of_elements(model->read_db, space_uuid);
 }
 
 int model_search_elements(Model *model, const char *search_term, GList **results) {
   if (!model || !model->db) return -1;
 
   GList *db_results = NULL;
-  int rc = database_search_elements(model->db, search_term, &db_results);
+  int rc = database_search_elements(model->read_db, search_term, &db_results);
   if (rc != 0) return rc;
 
   // Convert SearchResult to ModelSearchResult
@@ -1204,113 +1554,88 @@ void model_free_search_result(ModelSearchResult *result) {
   }
 }
 
+// Queue an element unless it was seen before
+static void bfs_enqueue(GQueue *queue, GHashTable *visited, UuidHandle handle) {
+  if (handle != UUID_HANDLE_NONE && !g_hash_table_contains(visited, UUID_HANDLE_TO_POINTER(handle))) {
+    g_hash_table_add(visited, UUID_HANDLE_TO_POINTER(handle));
+    g_queue_push_tail(queue, UUID_HANDLE_TO_POINTER(handle));
+  }
+}
+
 GList* find_connected_elements_bfs(Model *model, const char *start_uuid) {
   GList *result = NULL;
   GQueue *queue = g_queue_new();
-  GHashTable *visited = g_hash_table_new(g_str_hash, g_str_equal);
+  GHashTable *visited = g_hash_table_new(g_direct_hash, g_direct_equal);
+  GPtrArray *connections = g_ptr_array_new();
 
-  g_queue_push_tail(queue, g_strdup(start_uuid));
-  g_hash_table_add(visited, g_strdup(start_uuid));
+  bfs_enqueue(queue, visited, uuid_intern_lookup(start_uuid));
 
   while (!g_queue_is_empty(queue)) {
-    char *current_uuid = g_queue_pop_head(queue);
-    ModelElement *current_element = g_hash_table_lookup(model->elements, current_uuid);
-
-    if (current_element) {
-      // Add current element to result
-      result = g_list_append(result, current_element);
-
-      GHashTableIter iter;
-      gpointer key, value;
-      g_hash_table_iter_init(&iter, model->elements);
-
-      while (g_hash_table_iter_next(&iter, &key, &value)) {
-        ModelElement *element = (ModelElement*)value;
-        char *element_uuid = (char*)key;
-
-        // Check if this element is connected to the current element
-        int is_connected = 0;
-        if ((element->from_element_uuid && g_strcmp0(element->from_element_uuid, current_uuid) == 0) ||
-            (element->to_element_uuid && g_strcmp0(element->to_element_uuid, current_uuid) == 0)) {
-          is_connected = 1;
-        }
-
-        // Also check if current element is connected to this element
-        if (!is_connected && current_element->from_element_uuid &&
-            g_strcmp0(current_element->from_element_uuid, element_uuid) == 0) {
-          is_connected = 1;
-        }
-        if (!is_connected && current_element->to_element_uuid &&
-            g_strcmp0(current_element->to_element_uuid, element_uuid) == 0) {
-          is_connected = 1;
-        }
-
-        if (is_connected && !g_hash_table_contains(visited, element_uuid)) {
-          g_queue_push_tail(queue, g_strdup(element_uuid));
-          g_hash_table_add(visited, g_strdup(element_uuid));
-        }
-      }
+    UuidHandle current = UUID_POINTER_TO_HANDLE(g_queue_pop_head(queue));
+    ModelElement *current_element = model_get_element(model, current);
+    if (!current_element) continue;
+
+    // Add current element to result
+    result = g_list_prepend(result, current_element);
+
+    // Connections attached to the current element, in either direction
+    g_ptr_array_set_size(connections, 0);
+    model_collect_connections(model, model->outgoing, current, connections);
+    model_collect_connections(model, model->incoming, current, connections);
+    for (guint i = 0; i < connections->len; i++) {
+      ModelElement *connection = g_ptr_array_index(connections, i);
+      bfs_enqueue(queue, visited, model_element_handle(connection));
     }
 
-    g_free(current_uuid);
+    // And the elements the current element connects, if it is a connection
+    bfs_enqueue(queue, visited, model_connection_from(current_element));
+    bfs_enqueue(queue, visited, model_connection_to(current_element));
   }
 
+  g_ptr_array_free(connections, TRUE);
   g_queue_free(queue);
   g_hash_table_destroy(visited);
-  return result;
+  return g_list_reverse(result);
 }
 
 GList* find_children_bfs(Model *model, const char *parent_uuid) {
   GList *result = NULL;
   GQueue *queue = g_queue_new();
-  GHashTable *visited = g_hash_table_new(g_str_hash, g_str_equal);
+  GHashTable *visited = g_hash_table_new(g_direct_hash, g_direct_equal);
+  GPtrArray *connections = g_ptr_array_new();
+  UuidHandle parent = uuid_intern_lookup(parent_uuid);
 
-  g_queue_push_tail(queue, g_strdup(parent_uuid));
-  g_hash_table_add(visited, g_strdup(parent_uuid));
+  bfs_enqueue(queue, visited, parent);
 
   while (!g_queue_is_empty(queue)) {
-    char *current_uuid = g_queue_pop_head(queue);
-    ModelElement *current_element = g_hash_table_lookup(model->elements, current_uuid);
-
-    if (current_element) {
-      // Add current element to result, but exclude the starting parent
-      if (g_strcmp0(current_uuid, parent_uuid) != 0) {
-        result = g_list_append(result, current_element);
-      }
+    UuidHandle current = UUID_POINTER_TO_HANDLE(g_queue_pop_head(queue));
+    ModelElement *current_element = model_get_element(model, current);
+    if (!current_element) continue;
 
-      // Find all connections that originate FROM the current element
-      GHashTableIter iter;
-      gpointer key, value;
-      g_hash_table_iter_init(&iter, model->elements);
-
-      while (g_hash_table_iter_next(&iter, &key, &value)) {
-        ModelElement *element = (ModelElement*)value;
-
-        // Only follow outgoing connections (arrows going FROM current element TO other elements)
-        if (element->type->type == ELEMENT_CONNECTION &&
-            element->from_element_uuid && g_strcmp0(element->from_element_uuid, current_uuid) == 0) {
-
-          // This connection goes FROM current_uuid TO element->to_element_uuid
-          if (element->to_element_uuid && !g_hash_table_contains(visited, element->to_element_uuid)) {
-            g_queue_push_tail(queue, g_strdup(element->to_element_uuid));
-            g_hash_table_add(visited, g_strdup(element->to_element_uuid));
-          }
-
-          // Also include the connection itself in the result (but not in the starting case)
-          if (g_strcmp0(current_uuid, parent_uuid) != 0 ||
-              g_strcmp0(element->from_element_uuid, parent_uuid) == 0) {
-            result = g_list_append(result, element);
-          }
-        }
-      }
+    // Add current element to result, but exclude the starting parent
+    if (current != parent) {
+      result = g_list_prepend(result, current_element);
     }
 
-    g_free(current_uuid);
+    // Only follow outgoing connections (arrows going FROM current element TO other elements)
+    g_ptr_array_set_size(connections, 0);
+    model_collect_connections(model, model->outgoing, current, connections);
+    for (guint i = 0; i < connections->len; i++) {
+      ModelElement *connection = g_ptr_array_index(connections, i);
+      if (connection->type->type != ELEMENT_CONNECTION) continue;
+
+      // This connection goes FROM the current element TO its to endpoint
+      bfs_enqueue(queue, visited, model_connection_to(connection));
+
+      // Also include the connection itself in the result
+      result = g_list_prepend(result, connection);
+    }
   }
 
+  g_ptr_array_free(connections, TRUE);
   g_queue_free(queue);
   g_hash_table_destroy(visited);
-  return result;
+  return g_list_reverse(result);
 }
 
 int move_element_to_space(Model *model, ModelElement *element, const char *new_space_uuid) {
@@ -1324,12 +1649,11 @@ int move_element_to_space(Model *model, ModelElement *element, const char *new_s
   for (GList *iter = all_elements_to_move; iter != NULL; iter = iter->next) {
     ModelElement *elem = (ModelElement*)iter->data;
 
-    g_free(elem->space_uuid);
-    elem->space_uuid = g_strdup(new_space_uuid);
+    model_unindex_element(model, elem);
+    model_element_set_string(elem, &elem->space_uuid, new_space_uuid);
 
-    if (elem->state != MODEL_STATE_NEW) {
-      elem->state = MODEL_STATE_UPDATED;
-    }
+    model_mark_updated(model, elem, MODEL_FIELD_SPACE);
+    model_index_element(model, elem);
   }
 
   g_list_free(all_elements_to_move);
@@ -1340,7 +1664,7 @@ int model_get_all_spaces(Model *model, GList **spaces) {
   if (!model || !model->db) return 0;
 
   GList *db_spaces = NULL;
-  int rc = database_get_all_spaces(model->db, &db_spaces);
+  int rc = database_get_all_spaces(model->read_db, &db_spaces);
   if (!rc) return 0;
 
   // Convert SpaceInfo to ModelSpaceInfo
@@ -1374,7 +1698,7 @@ int model_load_video_data(Model *model, ModelVideo *video) {
     return 0;  // Already loaded or invalid
   }
 
-  if (database_load_video_data(model->db, video->id, &video->video_data, &video->video_size)) {
+  if (database_load_video_data(model->read_db, video->id, &video->video_data, &video->video_size)) {
     video->is_loaded = TRUE;
     return 1;
   }
@@ -1387,7 +1711,7 @@ int model_load_audio_data(Model *model, ModelAudio *audio) {
     return 0;  // Already loaded or invalid
   }
 
-  if (database_load_audio_data(model->db, audio->id, &audio->audio_data, &audio->audio_size)) {
+  if (database_load_audio_data(model->read_db, audio->id, &audio->audio_data, &audio->audio_size)) {
     audio->is_loaded = TRUE;
     return 1;
   }
@@ -1432,5 +1756,5 @@ int model_get_space_parent_uuid(Model *model, const char *space_uuid, char **par
     return 0;
   }
 
-  return database_get_space_parent_id(model->db, space_uuid, parent_uuid);
+  return database_get_space_parent_id(model->read_db, space_uuid, parent_uuid);
 }
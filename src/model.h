@@ -5,6 +5,8 @@
 #include <glib.h>
 #include <uuid/uuid.h>
 #include "elements/element.h"
+#include "uuid_intern.h"
+#include "model_arena.h"
 
 typedef enum {
   MODEL_STATE_NEW,      // Not yet saved to database
@@ -13,6 +15,31 @@ typedef enum {
   MODEL_STATE_DELETED,
 } ModelState;
 
+// What changed on an UPDATED element since it was last saved, so the save
+// writes only the affected ref rows and elements columns
+typedef enum {
+  MODEL_FIELD_POSITION    = 1 << 0,   // position_refs row
+  MODEL_FIELD_SIZE        = 1 << 1,   // size_refs row
+  MODEL_FIELD_TEXT        = 1 << 2,   // text_refs row: text, color, font, alignment, strikethrough
+  MODEL_FIELD_COLOR       = 1 << 3,   // color_refs row
+  MODEL_FIELD_IMAGE       = 1 << 4,   // image_refs row, including the image blob
+  MODEL_FIELD_VIDEO       = 1 << 5,   // video_refs row, including the video blob
+  MODEL_FIELD_REFS        = 1 << 6,   // Which ref rows the element points at
+  MODEL_FIELD_CONNECTION  = 1 << 7,   // Endpoints, anchor points, connection and arrowhead type
+  MODEL_FIELD_SPACE       = 1 << 8,   // space_uuid and target_space_uuid
+  MODEL_FIELD_SHAPE       = 1 << 9,   // Shape kind, fill, stroke and drawing points
+  MODEL_FIELD_ROTATION    = 1 << 10,
+  MODEL_FIELD_DESCRIPTION = 1 << 11,
+  MODEL_FIELD_LOCKED      = 1 << 12,
+} ModelField;
+
+// Everything but the media rows, whose blobs are only rewritten when their
+// own bit is set
+#define MODEL_FIELD_ALL (MODEL_FIELD_POSITION | MODEL_FIELD_SIZE | MODEL_FIELD_TEXT | \
+                         MODEL_FIELD_COLOR | MODEL_FIELD_REFS | MODEL_FIELD_CONNECTION | \
+                         MODEL_FIELD_SPACE | MODEL_FIELD_SHAPE | MODEL_FIELD_ROTATION | \
+                         MODEL_FIELD_DESCRIPTION | MODEL_FIELD_LOCKED)
+
 typedef struct _ModelText ModelText;
 typedef struct _ModelType ModelType;
 typedef struct _ModelSize ModelSize;
@@ -20,6 +47,8 @@ typedef struct _ModelColor ModelColor;
 typedef struct _ModelPosition ModelPosition;
 typedef struct _ModelElement ModelElement;
 typedef struct _Model Model;
+typedef struct _DatabaseCheckpointer DatabaseCheckpointer;
+typedef struct _DatabaseRefCollector DatabaseRefCollector;
 typedef struct _ModelImage ModelImage;
 typedef struct _ModelVideo ModelVideo;
 typedef struct _ModelAudio ModelAudio;
@@ -46,10 +75,11 @@ struct _ModelAudio {
   gint ref_count;
 };
 
+// Element types are a fixed lookup: every element of a type points at the
+// same ModelType from model_type_get(), and the database stores the enum
+// value directly in elements.type
 struct _ModelType {
-  gint id;                    // Unique ID for this element type
   ElementType type;           // The actual enum value
-  gint ref_count;
 };
 
 struct _ModelText {
@@ -92,10 +122,17 @@ struct _ModelImage {
 
 typedef graphene_point_t DrawingPoint;
 
+// Number of ElementType values, for per-type tables and masks
+#define MODEL_ELEMENT_TYPE_COUNT (ELEMENT_INLINE_TEXT + 1)
+#define MODEL_TYPE_BIT(type) (1u << (type))
+#define MODEL_TYPE_MASK_ALL (MODEL_TYPE_BIT(MODEL_ELEMENT_TYPE_COUNT) - 1)
+
 struct _ModelElement {
   gchar* uuid;                // UUID string for the element
+  UuidHandle handle;          // Interned uuid; use model_element_handle()
+  ModelArena *arena;          // Arena the element was carved from; NULL when heap allocated
   gchar* space_uuid;
-  ModelType* type;            // Shared element type reference
+  ModelType* type;            // Shared element type, from model_type_get()
   ModelPosition* position;    // Shared position
   ModelSize* size;            // Shared size
   ModelText* text;            // Shared text
@@ -105,10 +142,13 @@ struct _ModelElement {
   ModelImage* image;
   Element* visual_element;    // Pointer to visual representation
   ModelState state;
+  guint changed_fields;       // ModelField bits written since the last save
 
   // For connections
   gchar *from_element_uuid;
   gchar *to_element_uuid;
+  UuidHandle from_handle;     // Interned endpoints; use model_connection_from/to()
+  UuidHandle to_handle;
   gint from_point;
   gint to_point;
 
@@ -143,8 +183,7 @@ struct _ModelElement {
 // Model manages all elements
 struct _Model {
   gchar *current_space_uuid;
-  GHashTable *elements;       // uuid string -> ModelElement*
-  GHashTable *types;          // type_id -> ModelType* (shared types)
+  GHashTable *elements;       // UuidHandle -> ModelElement*
   GHashTable *texts;          // text_id -> ModelText* (shared texts)
   GHashTable *positions;      // positon_id -> ModelPosition* (shared position)
   GHashTable *sizes;          // size_id -> ModelSize* (shared size)
@@ -152,7 +191,17 @@ struct _Model {
   GHashTable *images;         // image_id -> ModelImage (shared image)
   GHashTable *videos;         // video_id -> ModelVideo (shared video)
   GHashTable *audios;         // audio_id -> ModelAudio (shared audio)
+  GHashTable *outgoing;       // element handle -> GArray of handles of connections leaving it
+  GHashTable *incoming;       // element handle -> GArray of handles of connections entering it
+  GHashTable *space_elements; // space uuid -> ModelSpaceElements* (live element handles by type)
+  GHashTable *dirty;          // handles of elements changed since the last save
+  GHashTable *changed;        // handles of elements changed since the canvas last synced
+  gboolean reloaded;          // model_load_space() ran since the canvas last synced
+  ModelArena arena;           // Elements and shared refs of the loaded space
   sqlite3 *db;
+  sqlite3 *read_db;           // Read-only connection for loads and search; db when unavailable
+  DatabaseCheckpointer *checkpointer; // Background WAL checkpoints; NULL when unavailable
+  DatabaseRefCollector *ref_collector; // Background orphaned-ref collection; NULL when unavailable
 
   // Cached space settings
   char *current_space_background_color;
@@ -198,14 +247,69 @@ int model_update_position(Model *model, ModelElement *element, int x, int y, int
 int model_update_size(Model *model, ModelElement *element, int width, int height);
 int model_update_rotation(Model *model, ModelElement *element, double rotation_degrees);
 int model_update_locked(Model *model, ModelElement *element, gboolean locked);
+int model_update_drawing_points(Model *model, ModelElement *element, const DrawingPoint *points, guint count);
 // This method slightly inconsistent with other update methods: it doesn't create ModelColor if it is NULL
 int model_update_color(Model *model, ModelElement *element, double r, double g, double b, double a);
 
 // Deletion
 int model_delete_element(Model *model, ModelElement *element);
 
+// Queue an element for the next model_save_elements(), which only visits
+// queued elements. The create, update and delete functions above do this;
+// call it after changing element->state by hand.
+void model_mark_dirty(Model *model, ModelElement *element);
+// Flag a saved element as UPDATED (NEW ones stay NEW), record which
+// ModelField bits changed and queue it. Call after writing ModelElement
+// fields directly.
+void model_mark_updated(Model *model, ModelElement *element, guint fields);
+
+// Elements queued by model_mark_dirty() since the last call, in load order
+// (connections after their endpoints), and clear the queue. After
+// model_load_space() it is every element and *reloaded is set, so the caller
+// rebuilds instead of patching. Caller frees the list.
+GList* model_take_changed(Model *model, gboolean *reloaded);
+
+// Replace one of the element's string fields (or its text ref's) with a copy
+// of value. Arena elements take the copy from the arena and keep the old one
+// until the space is unloaded, so never g_free() those fields by hand.
+void model_element_set_string(ModelElement *element, char **field, const char *value);
+
+// Adjacency index used by the graph walks below. Call after a connection is
+// put into model->elements or its from/to uuids change; it also refreshes the
+// endpoint handles. Entries left behind
+// by removed or re-pointed connections are dropped when next looked up.
+void model_index_connection(Model *model, ModelElement *element);
+
+// Add an element to the space/type index and, for connections, the adjacency
+// index. Call after it is put into model->elements or leaves the deleted
+// state. Deleted, removed and moved elements are dropped like stale adjacency
+// entries.
+void model_index_element(Model *model, ModelElement *element);
+
+// Append the connections leaving or entering an element to a caller-owned
+// array (a self-connection appears twice)
+void model_collect_element_connections(Model *model, ModelElement *element, GPtrArray *out);
+
+// Append the live (not deleted) elements of a space whose type is in
+// type_mask, a set of MODEL_TYPE_BIT()s, to a caller-owned array
+void model_collect_space_elements(Model *model, const char *space_uuid, guint type_mask, GPtrArray *out);
+
 // Helper functions
 gchar *model_generate_uuid(void);
+// Shared type entry for an ElementType; NULL when out of range
+ModelType* model_type_get(ElementType type);
+// Interned handle of an element's uuid, assigned on first use
+UuidHandle model_element_handle(ModelElement *element);
+// Interned handles of a connection's endpoints; UUID_HANDLE_NONE when unset
+UuidHandle model_connection_from(ModelElement *element);
+UuidHandle model_connection_to(ModelElement *element);
+
+// Element lookups. model->elements is keyed by handle; uuid strings from the
+// database, the DSL or UI actions go through model_lookup_element().
+ModelElement* model_get_element(Model *model, UuidHandle handle);
+ModelElement* model_lookup_element(Model *model, const char *uuid);
+// Put an element into model->elements, replacing one with the same uuid
+void model_insert_element(Model *model, ModelElement *element);
 ModelElement* model_get_by_visual(Model *model, Element *visual_element);
 gint model_compare_for_saving_loading(const ModelElement *a, const ModelElement *b);
 gint model_compare_for_deletion(const ModelElement *a, const ModelElement *b);
@@ -0,0 +1,154 @@
+#include "model_arena.h"
+#include <string.h>
+
+#define MODEL_SLAB_FIRST_BLOCK 256
+#define MODEL_SLAB_MAX_BLOCK 65536
+#define MODEL_ARENA_STRING_BLOCK 16384
+
+typedef struct {
+  gsize capacity;         // Objects the block holds
+  gsize used;             // Objects handed out from it so far
+  guint8 objects[];       // 16-byte offset keeps doubles and pointers aligned
+} ModelSlabBlock;
+
+static gsize model_slab_stride(gsize object_size) {
+  // Room for the free-list link and pointer alignment for every slot
+  gsize stride = MAX(object_size, sizeof(gpointer));
+  return (stride + sizeof(gpointer) - 1) & ~(sizeof(gpointer) - 1);
+}
+
+static ModelSlabBlock* model_slab_last_block(ModelSlab *slab) {
+  if (!slab->blocks || slab->blocks->len == 0) return NULL;
+  return g_ptr_array_index(slab->blocks, slab->blocks->len - 1);
+}
+
+gpointer model_slab_alloc0(ModelSlab *slab, gsize object_size) {
+  if (slab->object_size == 0) {
+    slab->object_size = model_slab_stride(object_size);
+  }
+  g_assert(model_slab_stride(object_size) == slab->object_size);
+
+  gpointer object;
+  if (slab->free_list) {
+    object = slab->free_list;
+    slab->free_list = *(gpointer*)object;
+    *(gpointer*)object = NULL;
+  } else {
+    ModelSlabBlock *block = model_slab_last_block(slab);
+    if (!block || block->used == block->capacity) {
+      gsize capacity = block ? MIN(block->capacity * 2, MODEL_SLAB_MAX_BLOCK) : MODEL_SLAB_FIRST_BLOCK;
+      block = g_malloc0(sizeof(ModelSlabBlock) + capacity * slab->object_size);
+      block->capacity = capacity;
+      if (!slab->blocks) {
+        slab->blocks = g_ptr_array_new_with_free_func(g_free);
+      }
+      g_ptr_array_add(slab->blocks, block);
+    }
+    object = block->objects + block->used++ * slab->object_size;
+  }
+
+  slab->live++;
+  return object;
+}
+
+void model_slab_free(ModelSlab *slab, gpointer object) {
+  if (!object) return;
+
+  memset(object, 0, slab->object_size);
+  *(gpointer*)object = slab->free_list;
+  slab->free_list = object;
+  slab->live--;
+}
+
+void model_slab_foreach(ModelSlab *slab, GFunc func, gpointer user_data) {
+  if (!slab->blocks) return;
+
+  for (guint b = 0; b < slab->blocks->len; b++) {
+    ModelSlabBlock *block = g_ptr_array_index(slab->blocks, b);
+    for (gsize i = 0; i < block->used; i++) {
+      func(block->objects + i * slab->object_size, user_data);
+    }
+  }
+}
+
+void model_slab_reset(ModelSlab *slab) {
+  ModelSlabBlock *keep = model_slab_last_block(slab);
+  if (!keep) return;
+
+  // Keep the largest block; the next space is likely of similar size
+  g_ptr_array_steal_index(slab->blocks, slab->blocks->len - 1);
+  g_ptr_array_set_size(slab->blocks, 0);
+  memset(keep->objects, 0, keep->used * slab->object_size);
+  keep->used = 0;
+  g_ptr_array_add(slab->blocks, keep);
+
+  slab->free_list = NULL;
+  slab->live = 0;
+}
+
+void model_slab_clear(ModelSlab *slab) {
+  if (slab->blocks) {
+    g_ptr_array_free(slab->blocks, TRUE);
+  }
+  memset(slab, 0, sizeof(*slab));
+}
+
+gchar* model_arena_strdup(ModelArena *arena, const gchar *string) {
+  if (!string) return NULL;
+
+  if (!arena->strings) {
+    arena->strings = g_string_chunk_new(MODEL_ARENA_STRING_BLOCK);
+  }
+  return g_string_chunk_insert(arena->strings, string);
+}
+
+void model_arena_set_string(ModelArena *arena, gchar **field, const gchar *value) {
+  if (!arena->edited) {
+    arena->edited = g_hash_table_new_full(g_direct_hash, g_direct_equal, g_free, NULL);
+  }
+
+  // Copy first: value may point into the string being replaced
+  gchar *copy = g_strdup(value);
+  if (*field) {
+    g_hash_table_remove(arena->edited, *field);
+  }
+  if (copy) {
+    g_hash_table_add(arena->edited, copy);
+  }
+  *field = copy;
+}
+
+GArray* model_arena_adopt_array(ModelArena *arena, GArray *array) {
+  if (!array) return NULL;
+
+  if (!arena->arrays) {
+    arena->arrays = g_ptr_array_new_with_free_func((GDestroyNotify)g_array_unref);
+  }
+  g_ptr_array_add(arena->arrays, array);
+  return array;
+}
+
+void model_arena_reset(ModelArena *arena) {
+  model_slab_reset(&arena->elements);
+  model_slab_reset(&arena->positions);
+  model_slab_reset(&arena->sizes);
+  model_slab_reset(&arena->texts);
+  model_slab_reset(&arena->colors);
+  if (arena->strings) g_string_chunk_clear(arena->strings);
+  if (arena->edited) g_hash_table_remove_all(arena->edited);
+  if (arena->arrays) g_ptr_array_set_size(arena->arrays, 0);
+}
+
+void model_arena_clear(ModelArena *arena) {
+  model_slab_clear(&arena->elements);
+  model_slab_clear(&arena->positions);
+  model_slab_clear(&arena->sizes);
+  model_slab_clear(&arena->texts);
+  model_slab_clear(&arena->colors);
+  if (arena->strings) g_string_chunk_free(arena->strings);
+  if (arena->edited) g_hash_table_destroy(arena->edited);
+  if (arena->arrays) g_ptr_array_free(arena->arrays, TRUE);
+  arena->strings = NULL;
+  arena->edited = NULL;
+  arena->arrays = NULL;
+}
@@ -0,0 +1,60 @@
+#ifndef MODEL_ARENA_H
+#define MODEL_ARENA_H
+
+#include <glib.h>
+
+// Typed slab: fixed-size objects carved out of a few large blocks that grow
+// geometrically. Freed objects are zeroed and kept on a free list; a reset
+// forgets every object at once. A zero-filled slab is ready to use.
+typedef struct {
+  gsize object_size;      // Slot stride, set by the first allocation
+  GPtrArray *blocks;      // Owned ModelSlabBlock*, oldest first
+  gpointer free_list;     // Freed objects, linked through their first pointer
+  guint live;             // Objects currently handed out
+} ModelSlab;
+
+// Per-space arena for model objects. Everything in it belongs to the loaded
+// space: model_load_space() resets it after dropping the old elements, so a
+// space loads with a handful of block allocations and unloads without
+// freeing objects one by one.
+typedef struct {
+  ModelSlab elements;
+  ModelSlab positions;
+  ModelSlab sizes;
+  ModelSlab texts;
+  ModelSlab colors;
+  GStringChunk *strings;  // Element and text strings, created on first use
+  GHashTable *edited;     // Owned heap copies from model_arena_set_string()
+  GPtrArray *arrays;      // Owned GArray*s (drawing points)
+} ModelArena;
+
+#define model_slab_new0(slab, Type) ((Type*)model_slab_alloc0((slab), sizeof(Type)))
+
+gpointer model_slab_alloc0(ModelSlab *slab, gsize object_size);
+void model_slab_free(ModelSlab *slab, gpointer object);
+
+// Call func on every object handed out since the last reset, freed ones
+// included (those are zero apart from their first pointer)
+void model_slab_foreach(ModelSlab *slab, GFunc func, gpointer user_data);
+
+// Drop every object, keeping the largest block for the next space
+void model_slab_reset(ModelSlab *slab);
+// Release all memory
+void model_slab_clear(ModelSlab *slab);
+
+// Copy a string into the arena; NULL stays NULL. The copy is never freed on
+// its own, only with the rest of the arena.
+gchar* model_arena_strdup(ModelArena *arena, const gchar *string);
+// Point *field at a heap copy of value (NULL stays NULL) that the arena
+// owns. The copy it replaces is freed when the arena owns it too, so a string
+// edited over and over holds one allocation; chunk strings from load time
+// stay until reset.
+void model_arena_set_string(ModelArena *arena, gchar **field, const gchar *value);
+// Hand an array over to the arena, which frees it on reset
+GArray* model_arena_adopt_array(ModelArena *arena, GArray *array);
+
+// Drop every object, string and array of the loaded space
+void model_arena_reset(ModelArena *arena);
+void model_arena_clear(ModelArena *arena);
+
+#endif
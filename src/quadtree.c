@@ -2,183 +2,569 @@
 #include <stdlib.h>
 #include <math.h>
 
-static QuadTreeNode* quadtree_node_new(double x, double y, double width, double height, int depth) {
-    QuadTreeNode *node = g_new0(QuadTreeNode, 1);
-    node->bounds.x = x;
-    node->bounds.y = y;
-    node->bounds.width = width;
-    node->bounds.height = height;
-    node->elements = g_ptr_array_new();
-    node->depth = depth;
-    for (int i = 0; i < 4; i++) {
-        node->children[i] = NULL;
-    }
-    return node;
+// Pool accessors. Pointers returned here are only valid until the next
+// node or block allocation, which may move the pool.
+static inline QuadTreeNode* quadtree_node(QuadTree *tree, gint32 index) {
+    return &g_array_index(tree->nodes, QuadTreeNode, index);
 }
 
-static void quadtree_node_free(QuadTreeNode *node) {
-    if (!node) return;
+static inline QuadTreeBounds* quadtree_node_bounds(QuadTree *tree, gint32 index) {
+    return &g_array_index(tree->node_bounds, QuadTreeBounds, index);
+}
+
+static inline QuadTreeBlock* quadtree_block(QuadTree *tree, gint32 index) {
+    return &g_array_index(tree->blocks, QuadTreeBlock, index);
+}
+
+static void quadtree_node_init(QuadTree *tree, gint32 index, const QuadTreeBounds *bounds) {
+    QuadTreeNode *node = quadtree_node(tree, index);
+    node->first_child = QUADTREE_NONE;
+    node->first_block = QUADTREE_NONE;
+    node->last_block = QUADTREE_NONE;
+    node->count = 0;
+    node->capacity = QUADTREE_LEAF_CAPACITY;
+    *quadtree_node_bounds(tree, index) = *bounds;
+}
+
+static void quadtree_child_bounds(const QuadTreeBounds *parent, int index, QuadTreeBounds *child) {
+    child->width = parent->width / 2.0;
+    child->height = parent->height / 2.0;
+    child->x = parent->x + (index & 1) * child->width;
+    child->y = parent->y + (index >> 1) * child->height;
+}
 
-    if (node->elements) {
-        g_ptr_array_free(node->elements, TRUE);
+// Four empty leaves covering the quadrants of parent (NW, NE, SW, SE)
+static gint32 quadtree_group_alloc(QuadTree *tree, const QuadTreeBounds *parent) {
+    gint32 first;
+    if (tree->free_groups->len > 0) {
+        first = g_array_index(tree->free_groups, gint32, tree->free_groups->len - 1);
+        g_array_set_size(tree->free_groups, tree->free_groups->len - 1);
+    } else {
+        first = (gint32)tree->nodes->len;
+        g_array_set_size(tree->nodes, tree->nodes->len + 4);
+        g_array_set_size(tree->node_bounds, tree->node_bounds->len + 4);
     }
+
     for (int i = 0; i < 4; i++) {
-        quadtree_node_free(node->children[i]);
+        QuadTreeBounds child;
+        quadtree_child_bounds(parent, i, &child);
+        quadtree_node_init(tree, first + i, &child);
+    }
+    return first;
+}
+
+static gint32 quadtree_block_alloc(QuadTree *tree) {
+    gint32 index = tree->free_block;
+    if (index != QUADTREE_NONE) {
+        tree->free_block = quadtree_block(tree, index)->next;
+    } else {
+        index = (gint32)tree->blocks->len;
+        g_array_set_size(tree->blocks, tree->blocks->len + 1);
     }
-    g_free(node);
+    quadtree_block(tree, index)->next = QUADTREE_NONE;
+    return index;
 }
 
-static gboolean bounds_intersects_element(QuadTreeBounds *bounds, Element *element) {
-    double elem_x = element->x;
-    double elem_y = element->y;
-    double elem_width = element->width;
-    double elem_height = element->height;
+static void quadtree_block_release(QuadTree *tree, gint32 index) {
+    quadtree_block(tree, index)->next = tree->free_block;
+    tree->free_block = index;
+}
 
-    // Fast path for non-rotated elements (most common case)
-    if (element->rotation_degrees == 0.0) {
-        double elem_right = elem_x + elem_width;
-        double elem_bottom = elem_y + elem_height;
-        double bounds_right = bounds->x + bounds->width;
-        double bounds_bottom = bounds->y + bounds->height;
-        return !(elem_x > bounds_right || elem_right < bounds->x ||
-                 elem_y > bounds_bottom || elem_bottom < bounds->y);
+static void quadtree_leaf_append(QuadTree *tree, gint32 index, Element *element) {
+    guint slot = quadtree_node(tree, index)->count % QUADTREE_BLOCK_SIZE;
+    if (slot == 0) {
+        gint32 block = quadtree_block_alloc(tree);
+        QuadTreeNode *node = quadtree_node(tree, index);
+        if (node->last_block == QUADTREE_NONE) {
+            node->first_block = block;
+        } else {
+            quadtree_block(tree, node->last_block)->next = block;
+        }
+        node->last_block = block;
     }
 
-    // Slow path for rotated elements - calculate axis-aligned bounding box
-    double cx = elem_x + elem_width / 2.0;
-    double cy = elem_y + elem_height / 2.0;
-    double angle = element->rotation_degrees * M_PI / 180.0;
-    double cos_a = cos(angle);
-    double sin_a = sin(angle);
-    double half_w = elem_width / 2.0;
-    double half_h = elem_height / 2.0;
+    QuadTreeNode *node = quadtree_node(tree, index);
+    quadtree_block(tree, node->last_block)->items[slot] = element;
+    node->count++;
+}
+
+// Swap the last entry into the removed slot; drop the tail block once empty
+static void quadtree_leaf_remove(QuadTree *tree, gint32 index, Element *element) {
+    QuadTreeNode *node = quadtree_node(tree, index);
+    guint remaining = node->count;
+    for (gint32 block = node->first_block; block != QUADTREE_NONE; block = quadtree_block(tree, block)->next) {
+        QuadTreeBlock *entries = quadtree_block(tree, block);
+        guint n = MIN(remaining, QUADTREE_BLOCK_SIZE);
+        for (guint i = 0; i < n; i++) {
+            if (entries->items[i] != element) continue;
 
-    // Calculate four corners
-    double dx1 = -half_w * cos_a + half_h * sin_a;
-    double dy1 = -half_w * sin_a - half_h * cos_a;
-    double dx2 = half_w * cos_a + half_h * sin_a;
-    double dy2 = half_w * sin_a - half_h * cos_a;
+            guint last_slot = (node->count - 1) % QUADTREE_BLOCK_SIZE;
+            entries->items[i] = quadtree_block(tree, node->last_block)->items[last_slot];
+            node->count--;
 
-    // Find min/max efficiently
-    double min_x = cx + fmin(fmin(dx1, -dx1), fmin(dx2, -dx2));
-    double max_x = cx + fmax(fmax(dx1, -dx1), fmax(dx2, -dx2));
-    double min_y = cy + fmin(fmin(dy1, -dy1), fmin(dy2, -dy2));
-    double max_y = cy + fmax(fmax(dy1, -dy1), fmax(dy2, -dy2));
+            if (last_slot == 0) {
+                gint32 tail = node->last_block;
+                if (node->first_block == tail) {
+                    node->first_block = QUADTREE_NONE;
+                    node->last_block = QUADTREE_NONE;
+                } else {
+                    gint32 prev = node->first_block;
+                    while (quadtree_block(tree, prev)->next != tail) {
+                        prev = quadtree_block(tree, prev)->next;
+                    }
+                    quadtree_block(tree, prev)->next = QUADTREE_NONE;
+                    node->last_block = prev;
+                }
+                quadtree_block_release(tree, tail);
+            }
+            return;
+        }
+        remaining -= n;
+    }
+}
+
+static void quadtree_leaf_release(QuadTree *tree, gint32 index) {
+    QuadTreeNode *node = quadtree_node(tree, index);
+    gint32 block = node->first_block;
+    while (block != QUADTREE_NONE) {
+        gint32 next = quadtree_block(tree, block)->next;
+        quadtree_block_release(tree, block);
+        block = next;
+    }
+    node->first_block = QUADTREE_NONE;
+    node->last_block = QUADTREE_NONE;
+    node->count = 0;
+}
+
+// Return a node's storage and all of its descendants to the pools
+static void quadtree_subtree_release(QuadTree *tree, gint32 index) {
+    gint32 first_child = quadtree_node(tree, index)->first_child;
+    if (first_child != QUADTREE_NONE) {
+        for (int i = 0; i < 4; i++) {
+            quadtree_subtree_release(tree, first_child + i);
+        }
+        g_array_append_val(tree->free_groups, first_child);
+        quadtree_node(tree, index)->first_child = QUADTREE_NONE;
+    }
+    quadtree_leaf_release(tree, index);
+}
+
+static gboolean bounds_contains(const QuadTreeBounds *outer, const QuadTreeBounds *inner) {
+    return inner->x >= outer->x && inner->y >= outer->y &&
+           inner->x + inner->width <= outer->x + outer->width &&
+           inner->y + inner->height <= outer->y + outer->height;
+}
+
+// Splitting only pays off when it separates elements. If most of them
+// straddle the child boundaries every child would inherit nearly all of
+// them, so the leaf is better off just holding more.
+static gboolean quadtree_node_should_split(QuadTree *tree, gint32 index) {
+    const QuadTreeBounds *node_bounds = quadtree_node_bounds(tree, index);
+    if (node_bounds->width / 2.0 < QUADTREE_MIN_NODE_SIZE ||
+        node_bounds->height / 2.0 < QUADTREE_MIN_NODE_SIZE) {
+        return FALSE;
+    }
 
-    double bounds_right = bounds->x + bounds->width;
-    double bounds_bottom = bounds->y + bounds->height;
+    QuadTreeBounds children[4];
+    for (int i = 0; i < 4; i++) {
+        quadtree_child_bounds(node_bounds, i, &children[i]);
+    }
 
-    return !(min_x > bounds_right || max_x < bounds->x ||
-             min_y > bounds_bottom || max_y < bounds->y);
+    const QuadTreeNode *node = quadtree_node(tree, index);
+    guint remaining = node->count;
+    guint entries = 0;
+    for (gint32 block = node->first_block; block != QUADTREE_NONE; block = quadtree_block(tree, block)->next) {
+        const QuadTreeBlock *stored = quadtree_block(tree, block);
+        guint n = MIN(remaining, QUADTREE_BLOCK_SIZE);
+        for (guint i = 0; i < n; i++) {
+            const QuadTreeBounds *elem_bounds = g_hash_table_lookup(tree->indexed, stored->items[i]);
+            for (int j = 0; j < 4; j++) {
+                if (spatial_bounds_intersects(&children[j], elem_bounds)) entries++;
+            }
+        }
+        remaining -= n;
+    }
+    return entries <= node->count * QUADTREE_MAX_SPLIT_FANOUT;
 }
 
-static gboolean bounds_contains_point(QuadTreeBounds *bounds, double x, double y) {
-    return x >= bounds->x && x <= bounds->x + bounds->width &&
-           y >= bounds->y && y <= bounds->y + bounds->height;
+// Double the root towards bounds until it covers them. The old root's
+// contents move into one quadrant of the new one, so nothing already indexed
+// is re-inserted, and the root keeps its pool index.
+static void quadtree_grow_to_fit(QuadTree *tree, const QuadTreeBounds *bounds) {
+    if (!isfinite(bounds->x) || !isfinite(bounds->y) ||
+        !isfinite(bounds->width) || !isfinite(bounds->height)) {
+        return;
+    }
+
+    while (!bounds_contains(quadtree_node_bounds(tree, tree->root), bounds) &&
+           quadtree_node_bounds(tree, tree->root)->width < QUADTREE_MAX_EXTENT) {
+        QuadTreeBounds old_bounds = *quadtree_node_bounds(tree, tree->root);
+
+        // Grow left/up when the content sticks out on that side, right/down otherwise
+        gboolean grow_left = bounds->x < old_bounds.x;
+        gboolean grow_up = bounds->y < old_bounds.y;
+        QuadTreeBounds new_bounds = {
+            grow_left ? old_bounds.x - old_bounds.width : old_bounds.x,
+            grow_up ? old_bounds.y - old_bounds.height : old_bounds.y,
+            old_bounds.width * 2.0,
+            old_bounds.height * 2.0,
+        };
+
+        gint32 first_child = quadtree_group_alloc(tree, &new_bounds);
+        gint32 old_slot = first_child + (grow_left ? 1 : 0) + (grow_up ? 2 : 0);
+        *quadtree_node(tree, old_slot) = *quadtree_node(tree, tree->root);
+        *quadtree_node_bounds(tree, old_slot) = old_bounds;
+
+        quadtree_node_init(tree, tree->root, &new_bounds);
+        quadtree_node(tree, tree->root)->first_child = first_child;
+    }
 }
 
-static void quadtree_node_subdivide(QuadTreeNode *node) {
-    if (node->children[0] != NULL) return;
+static void quadtree_node_insert(QuadTree *tree, gint32 index, Element *element,
+                                 const QuadTreeBounds *bounds);
 
-    double half_width = node->bounds.width / 2.0;
-    double half_height = node->bounds.height / 2.0;
-    double x = node->bounds.x;
-    double y = node->bounds.y;
-    int new_depth = node->depth + 1;
+// Turn a full leaf into four children and hand its entries down. The entry
+// chain is detached first and its blocks recycled as they are drained.
+static void quadtree_node_split(QuadTree *tree, gint32 index) {
+    QuadTreeNode *node = quadtree_node(tree, index);
+    gint32 block = node->first_block;
+    guint remaining = node->count;
+    node->first_block = QUADTREE_NONE;
+    node->last_block = QUADTREE_NONE;
+    node->count = 0;
 
-    // NW, NE, SW, SE
-    node->children[0] = quadtree_node_new(x, y, half_width, half_height, new_depth);
-    node->children[1] = quadtree_node_new(x + half_width, y, half_width, half_height, new_depth);
-    node->children[2] = quadtree_node_new(x, y + half_height, half_width, half_height, new_depth);
-    node->children[3] = quadtree_node_new(x + half_width, y + half_height, half_width, half_height, new_depth);
+    QuadTreeBounds node_bounds = *quadtree_node_bounds(tree, index);
+    gint32 first_child = quadtree_group_alloc(tree, &node_bounds);
+    quadtree_node(tree, index)->first_child = first_child;
+
+    while (block != QUADTREE_NONE) {
+        guint n = MIN(remaining, QUADTREE_BLOCK_SIZE);
+        for (guint i = 0; i < n; i++) {
+            Element *element = quadtree_block(tree, block)->items[i];
+            const QuadTreeBounds *elem_bounds = g_hash_table_lookup(tree->indexed, element);
+            for (int j = 0; j < 4; j++) {
+                quadtree_node_insert(tree, first_child + j, element, elem_bounds);
+            }
+        }
+        remaining -= n;
+
+        gint32 next = quadtree_block(tree, block)->next;
+        quadtree_block_release(tree, block);
+        block = next;
+    }
 }
 
-static void quadtree_node_insert(QuadTreeNode *node, Element *element) {
-    if (!bounds_intersects_element(&node->bounds, element)) {
+// Elements are placed by the bounds recorded in tree->indexed rather than
+// their live geometry, so a later remove walks exactly the same leaves even
+// if the element has moved in the meantime
+static void quadtree_node_insert(QuadTree *tree, gint32 index, Element *element,
+                                 const QuadTreeBounds *bounds) {
+    if (!spatial_bounds_intersects(quadtree_node_bounds(tree, index), bounds)) {
         return;
     }
 
     // If we have children, try to insert into them
-    if (node->children[0] != NULL) {
+    gint32 first_child = quadtree_node(tree, index)->first_child;
+    if (first_child != QUADTREE_NONE) {
         for (int i = 0; i < 4; i++) {
-            quadtree_node_insert(node->children[i], element);
+            quadtree_node_insert(tree, first_child + i, element, bounds);
         }
         return;
     }
 
-    // Add to this node (O(1) operation)
-    g_ptr_array_add(node->elements, element);
+    quadtree_leaf_append(tree, index, element);
 
-    // Subdivide if necessary (using len field is O(1))
-    if (node->elements->len > QUADTREE_MAX_ELEMENTS &&
-        node->depth < QUADTREE_MAX_DEPTH) {
-        quadtree_node_subdivide(node);
+    QuadTreeNode *node = quadtree_node(tree, index);
+    if (node->count > node->capacity) {
+        if (!quadtree_node_should_split(tree, index)) {
+            node->capacity *= 2;
+            return;
+        }
+        quadtree_node_split(tree, index);
+    }
+}
 
-        // Move all elements to children
-        GPtrArray *elements = node->elements;
-        node->elements = g_ptr_array_new();
+// Entries under a node, counting multi-leaf elements once per leaf. Stops
+// early once the count exceeds limit.
+static guint quadtree_node_count(QuadTree *tree, gint32 index, guint limit) {
+    const QuadTreeNode *node = quadtree_node(tree, index);
+    guint count = node->count;
+    if (node->first_child != QUADTREE_NONE) {
+        for (int i = 0; i < 4 && count <= limit; i++) {
+            count += quadtree_node_count(tree, node->first_child + i, limit);
+        }
+    }
+    return count;
+}
 
-        for (guint i = 0; i < elements->len; i++) {
-            Element *elem = g_ptr_array_index(elements, i);
-            for (int j = 0; j < 4; j++) {
-                quadtree_node_insert(node->children[j], elem);
+static void quadtree_node_collect(QuadTree *tree, gint32 index, GPtrArray *elements) {
+    const QuadTreeNode *node = quadtree_node(tree, index);
+    guint remaining = node->count;
+    for (gint32 block = node->first_block; block != QUADTREE_NONE; block = quadtree_block(tree, block)->next) {
+        const QuadTreeBlock *stored = quadtree_block(tree, block);
+        guint n = MIN(remaining, QUADTREE_BLOCK_SIZE);
+        for (guint i = 0; i < n; i++) {
+            if (!g_ptr_array_find(elements, stored->items[i], NULL)) {
+                g_ptr_array_add(elements, stored->items[i]);
             }
         }
-        g_ptr_array_free(elements, TRUE);
+        remaining -= n;
+    }
+    if (node->first_child != QUADTREE_NONE) {
+        for (int i = 0; i < 4; i++) {
+            quadtree_node_collect(tree, node->first_child + i, elements);
+        }
+    }
+}
+
+// Fold a sparse subtree back into a single leaf
+static void quadtree_node_merge(QuadTree *tree, gint32 index) {
+    GPtrArray *elements = tree->scratch;
+    g_ptr_array_set_size(elements, 0);
+    quadtree_node_collect(tree, index, elements);
+
+    quadtree_subtree_release(tree, index);
+    quadtree_node(tree, index)->capacity = QUADTREE_LEAF_CAPACITY;
+    for (guint i = 0; i < elements->len; i++) {
+        quadtree_leaf_append(tree, index, g_ptr_array_index(elements, i));
     }
+    g_ptr_array_set_size(elements, 0);
 }
 
-static void quadtree_node_query_point(QuadTreeNode *node, double x, double y, GList **results) {
-    if (!bounds_contains_point(&node->bounds, x, y)) {
+static void quadtree_node_remove(QuadTree *tree, gint32 index, Element *element,
+                                 const QuadTreeBounds *bounds) {
+    if (!spatial_bounds_intersects(quadtree_node_bounds(tree, index), bounds)) {
         return;
     }
 
-    // Add elements from this node
-    for (guint i = 0; i < node->elements->len; i++) {
-        *results = g_list_prepend(*results, g_ptr_array_index(node->elements, i));
+    QuadTreeNode *node = quadtree_node(tree, index);
+    if (node->first_child == QUADTREE_NONE) {
+        quadtree_leaf_remove(tree, index, element);
+        // Give back capacity a crowded leaf gained once it has thinned out
+        if (node->capacity > QUADTREE_LEAF_CAPACITY && node->count < node->capacity / 4) {
+            node->capacity /= 2;
+        }
+        return;
     }
 
-    // Query children
-    if (node->children[0] != NULL) {
-        for (int i = 0; i < 4; i++) {
-            quadtree_node_query_point(node->children[i], x, y, results);
+    gint32 first_child = node->first_child;
+    for (int i = 0; i < 4; i++) {
+        quadtree_node_remove(tree, first_child + i, element, bounds);
+    }
+
+    if (quadtree_node_count(tree, index, QUADTREE_MERGE_ELEMENTS) <= QUADTREE_MERGE_ELEMENTS) {
+        quadtree_node_merge(tree, index);
+    }
+}
+
+// Visits a leaf's entries not yet seen under this stamp. Returns FALSE once
+// the visitor asks to stop.
+static gboolean quadtree_leaf_visit(QuadTree *tree, const QuadTreeNode *node, const QuadTreeBounds *rect,
+                                    guint stamp, QuadTreeVisitFunc func, gpointer user_data) {
+    guint remaining = node->count;
+    for (gint32 block = node->first_block; block != QUADTREE_NONE; block = quadtree_block(tree, block)->next) {
+        const QuadTreeBlock *stored = quadtree_block(tree, block);
+        guint n = MIN(remaining, QUADTREE_BLOCK_SIZE);
+        for (guint i = 0; i < n; i++) {
+            Element *element = stored->items[i];
+            if (element->spatial_stamp == stamp) {
+                continue;  // Already reported from another leaf
+            }
+            if (rect && !spatial_bounds_intersects_element(rect, element)) {
+                continue;
+            }
+            element->spatial_stamp = stamp;
+            if (!func(element, user_data)) {
+                return FALSE;
+            }
         }
+        remaining -= n;
     }
+    return TRUE;
 }
 
+static gboolean quadtree_node_visit_point(QuadTree *tree, gint32 index, double x, double y,
+                                          guint stamp, QuadTreeVisitFunc func, gpointer user_data) {
+    if (!spatial_bounds_contains_point(quadtree_node_bounds(tree, index), x, y)) {
+        return TRUE;
+    }
+
+    const QuadTreeNode *node = quadtree_node(tree, index);
+    if (node->first_child == QUADTREE_NONE) {
+        return quadtree_leaf_visit(tree, node, NULL, stamp, func, user_data);
+    }
+    for (int i = 0; i < 4; i++) {
+        if (!quadtree_node_visit_point(tree, node->first_child + i, x, y, stamp, func, user_data)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static gboolean quadtree_node_visit_rect(QuadTree *tree, gint32 index, const QuadTreeBounds *rect,
+                                         guint stamp, QuadTreeVisitFunc func, gpointer user_data) {
+    if (!spatial_bounds_intersects(quadtree_node_bounds(tree, index), rect)) {
+        return TRUE;
+    }
+
+    const QuadTreeNode *node = quadtree_node(tree, index);
+    if (node->first_child == QUADTREE_NONE) {
+        return quadtree_leaf_visit(tree, node, rect, stamp, func, user_data);
+    }
+    for (int i = 0; i < 4; i++) {
+        if (!quadtree_node_visit_rect(tree, node->first_child + i, rect, stamp, func, user_data)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static void quadtree_reset_pools(QuadTree *tree) {
+    g_array_set_size(tree->nodes, 1);
+    g_array_set_size(tree->node_bounds, 1);
+    g_array_set_size(tree->blocks, 0);
+    g_array_set_size(tree->free_groups, 0);
+    tree->free_block = QUADTREE_NONE;
+    tree->root = 0;
+    quadtree_node_init(tree, tree->root, &tree->initial_bounds);
+}
+
+static void quadtree_index_free(SpatialIndex *index) {
+    quadtree_free((QuadTree*)index);
+}
+
+static void quadtree_index_clear(SpatialIndex *index) {
+    quadtree_clear((QuadTree*)index);
+}
+
+static void quadtree_index_update(SpatialIndex *index, Element *element) {
+    quadtree_update((QuadTree*)index, element);
+}
+
+static void quadtree_index_remove(SpatialIndex *index, Element *element) {
+    quadtree_remove((QuadTree*)index, element);
+}
+
+static gboolean quadtree_index_contains(SpatialIndex *index, Element *element) {
+    return quadtree_contains((QuadTree*)index, element);
+}
+
+static void quadtree_index_visit_point(SpatialIndex *index, double x, double y, guint stamp,
+                                       SpatialVisitFunc func, gpointer user_data) {
+    QuadTree *tree = (QuadTree*)index;
+    quadtree_node_visit_point(tree, tree->root, x, y, stamp, func, user_data);
+}
+
+static void quadtree_index_visit_rect(SpatialIndex *index, const SpatialBounds *rect, guint stamp,
+                                      SpatialVisitFunc func, gpointer user_data) {
+    QuadTree *tree = (QuadTree*)index;
+    quadtree_node_visit_rect(tree, tree->root, rect, stamp, func, user_data);
+}
+
+// Incremental inserts already build a good tree, so no bulk loader
+static const SpatialIndexVTable quadtree_vtable = {
+    .name = "quadtree",
+    .free = quadtree_index_free,
+    .clear = quadtree_index_clear,
+    .update = quadtree_index_update,
+    .remove = quadtree_index_remove,
+    .contains = quadtree_index_contains,
+    .bulk_load = NULL,
+    .visit_point = quadtree_index_visit_point,
+    .visit_rect = quadtree_index_visit_rect,
+};
+
 QuadTree* quadtree_new(double x, double y, double width, double height) {
     QuadTree *tree = g_new0(QuadTree, 1);
-    tree->root = quadtree_node_new(x, y, width, height, 0);
+    tree->base.vtable = &quadtree_vtable;
+    tree->nodes = g_array_new(FALSE, FALSE, sizeof(QuadTreeNode));
+    tree->node_bounds = g_array_new(FALSE, FALSE, sizeof(QuadTreeBounds));
+    tree->blocks = g_array_new(FALSE, FALSE, sizeof(QuadTreeBlock));
+    tree->free_groups = g_array_new(FALSE, FALSE, sizeof(gint32));
+    tree->initial_bounds = (QuadTreeBounds){ x, y, width, height };
+    tree->indexed = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    tree->scratch = g_ptr_array_new();
+    quadtree_reset_pools(tree);
     return tree;
 }
 
 void quadtree_free(QuadTree *tree) {
     if (!tree) return;
-    quadtree_node_free(tree->root);
+    g_array_free(tree->nodes, TRUE);
+    g_array_free(tree->node_bounds, TRUE);
+    g_array_free(tree->blocks, TRUE);
+    g_array_free(tree->free_groups, TRUE);
+    g_hash_table_destroy(tree->indexed);
+    g_ptr_array_free(tree->scratch, TRUE);
     g_free(tree);
 }
 
 void quadtree_insert(QuadTree *tree, Element *element) {
+    // Inserting twice would leave duplicate leaf entries behind
+    quadtree_update(tree, element);
+}
+
+void quadtree_remove(QuadTree *tree, Element *element) {
+    if (!tree || !element) return;
+
+    QuadTreeBounds *bounds = g_hash_table_lookup(tree->indexed, element);
+    if (!bounds) return;
+
+    quadtree_node_remove(tree, tree->root, element, bounds);
+    g_hash_table_remove(tree->indexed, element);
+}
+
+void quadtree_update(QuadTree *tree, Element *element) {
     if (!tree || !element) return;
-    quadtree_node_insert(tree->root, element);
+
+    QuadTreeBounds bounds;
+    spatial_index_element_bounds(element, &bounds);
+
+    QuadTreeBounds *indexed = g_hash_table_lookup(tree->indexed, element);
+    if (indexed) {
+        if (indexed->x == bounds.x && indexed->y == bounds.y &&
+            indexed->width == bounds.width && indexed->height == bounds.height) {
+            return;
+        }
+        quadtree_node_remove(tree, tree->root, element, indexed);
+        *indexed = bounds;
+    } else {
+        indexed = g_new(QuadTreeBounds, 1);
+        *indexed = bounds;
+        g_hash_table_insert(tree->indexed, element, indexed);
+    }
+
+    quadtree_grow_to_fit(tree, indexed);
+    quadtree_node_insert(tree, tree->root, element, indexed);
+}
+
+gboolean quadtree_contains(QuadTree *tree, Element *element) {
+    return tree && element && g_hash_table_contains(tree->indexed, element);
 }
 
 void quadtree_clear(QuadTree *tree) {
-    if (!tree || !tree->root) return;
+    if (!tree) return;
+
+    // Start over from the initial extent; it grows again as content arrives
+    quadtree_reset_pools(tree);
+    g_hash_table_remove_all(tree->indexed);
+}
+
+void quadtree_visit_point(QuadTree *tree, double x, double y,
+                          QuadTreeVisitFunc func, gpointer user_data) {
+    spatial_index_visit_point((SpatialIndex*)tree, x, y, func, user_data);
+}
 
-    // Save bounds before freeing the root
-    double x = tree->root->bounds.x;
-    double y = tree->root->bounds.y;
-    double width = tree->root->bounds.width;
-    double height = tree->root->bounds.height;
+void quadtree_visit_rect(QuadTree *tree, double x, double y, double width, double height,
+                         QuadTreeVisitFunc func, gpointer user_data) {
+    spatial_index_visit_rect((SpatialIndex*)tree, x, y, width, height, func, user_data);
+}
 
-    quadtree_node_free(tree->root);
-    tree->root = quadtree_node_new(x, y, width, height, 0);
+void quadtree_query_point(QuadTree *tree, double x, double y, GPtrArray *results) {
+    spatial_index_query_point((SpatialIndex*)tree, x, y, results);
 }
 
-GList* quadtree_query_point(QuadTree *tree, double x, double y) {
-    if (!tree) return NULL;
-    GList *results = NULL;
-    quadtree_node_query_point(tree->root, x, y, &results);
-    return results;
+guint quadtree_query_rect(QuadTree *tree, double x, double y, double width, double height,
+                          GPtrArray *results) {
+    return spatial_index_query_rect((SpatialIndex*)tree, x, y, width, height, results);
 }
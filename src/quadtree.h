@@ -3,28 +3,61 @@
 
 #include <glib.h>
 #include "elements/element.h"
+#include "spatial_index.h"
 
-#define QUADTREE_MAX_ELEMENTS 64
-#define QUADTREE_MAX_DEPTH 16
+// Entries a fresh leaf holds before it tries to split. Leaves whose
+// elements would land in most children anyway double their own capacity
+// instead, so heavily overlapping content does not split without end.
+#define QUADTREE_LEAF_CAPACITY 64
+// Average child quadrants per element above which splitting is refused
+#define QUADTREE_MAX_SPLIT_FANOUT 2.0
+// Nodes never get narrower than this many canvas units
+#define QUADTREE_MIN_NODE_SIZE 16.0
+// Below this many entries a subdivided node is folded back into a leaf; kept
+// well under QUADTREE_LEAF_CAPACITY so insert/remove at the edge cannot thrash
+#define QUADTREE_MERGE_ELEMENTS (QUADTREE_LEAF_CAPACITY / 2)
+// The root doubles towards out-of-range content up to this edge length
+#define QUADTREE_MAX_EXTENT 1e15
+// Leaf entries are stored in pooled fixed-size blocks chained per leaf
+#define QUADTREE_BLOCK_SIZE 16
+// Null index for nodes and blocks
+#define QUADTREE_NONE (-1)
 
-typedef struct _QuadTreeNode QuadTreeNode;
+typedef SpatialBounds QuadTreeBounds;
 
+// Nodes live in one pool and refer to each other by index. The four
+// children of a node are consecutive (NW, NE, SW, SE from first_child).
+// Node bounds are kept in a parallel array so traversal touches less memory.
 typedef struct {
-    double x, y, width, height;
-} QuadTreeBounds;
+    gint32 first_child;  // QUADTREE_NONE for leaves
+    gint32 first_block;  // Leaf entry chain, QUADTREE_NONE when empty
+    gint32 last_block;
+    guint32 count;       // Entries stored in this leaf
+    guint32 capacity;    // Leaf split threshold, grows for overlapping content
+} QuadTreeNode;
 
-struct _QuadTreeNode {
-    QuadTreeBounds bounds;
-    GPtrArray *elements;  // Array of Element*
-    QuadTreeNode *children[4];  // NW, NE, SW, SE
-    int depth;
-};
+typedef struct {
+    Element *items[QUADTREE_BLOCK_SIZE];
+    gint32 next;
+} QuadTreeBlock;
 
 typedef struct {
-    QuadTreeNode *root;
+    SpatialIndex base;      // Must stay first; the tree is usable as a SpatialIndex
+    GArray *nodes;          // QuadTreeNode pool
+    GArray *node_bounds;    // QuadTreeBounds, parallel to nodes
+    GArray *blocks;         // QuadTreeBlock pool
+    GArray *free_groups;    // gint32 first index of released 4-node child groups
+    gint32 free_block;      // Head of the released block list
+    gint32 root;
+    QuadTreeBounds initial_bounds;  // Root extent restored by quadtree_clear
+    GHashTable *indexed;  // Element* -> QuadTreeBounds* it was inserted with
+    GPtrArray *scratch;   // Reused when folding a subtree into a leaf
 } QuadTree;
 
-// Create/destroy
+typedef SpatialVisitFunc QuadTreeVisitFunc;
+
+// Create/destroy. The bounds are only the starting extent: the root grows
+// to cover whatever is inserted, so any coordinate can be indexed.
 QuadTree* quadtree_new(double x, double y, double width, double height);
 void quadtree_free(QuadTree *tree);
 
@@ -32,7 +65,33 @@ void quadtree_free(QuadTree *tree);
 void quadtree_insert(QuadTree *tree, Element *element);
 void quadtree_clear(QuadTree *tree);
 
-// Query elements at a point (for picking)
-GList* quadtree_query_point(QuadTree *tree, double x, double y);
+// Take an element out of the index. Nodes whose subtree drops to
+// QUADTREE_MERGE_ELEMENTS or fewer entries collapse back into a leaf.
+void quadtree_remove(QuadTree *tree, Element *element);
+
+// Re-index an element after it moved, resized or rotated. Cheap no-op when
+// its bounds are unchanged; inserts elements not yet in the tree.
+void quadtree_update(QuadTree *tree, Element *element);
+
+gboolean quadtree_contains(QuadTree *tree, Element *element);
+
+// Visit every element stored in leaves containing a point (for picking).
+// Elements are visited once each; the caller does the precise hit test.
+// Neither visit allocates.
+void quadtree_visit_point(QuadTree *tree, double x, double y,
+                          QuadTreeVisitFunc func, gpointer user_data);
+
+// Visit every element whose bounds intersect a rectangle
+void quadtree_visit_rect(QuadTree *tree, double x, double y, double width, double height,
+                         QuadTreeVisitFunc func, gpointer user_data);
+
+// Append the elements at a point to a caller-owned array
+void quadtree_query_point(QuadTree *tree, double x, double y, GPtrArray *results);
+
+// Query elements whose bounds intersect a rectangle (for viewport culling).
+// Each element is appended to results once, even if it spans several leaves.
+// Returns the stamp written to Element.spatial_stamp for every reported element.
+guint quadtree_query_rect(QuadTree *tree, double x, double y, double width, double height,
+                          GPtrArray *results);
 
 #endif
@@ -0,0 +1,408 @@
+#include "rtree.h"
+#include <stdlib.h>
+#include <math.h>
+
+typedef struct {
+    SpatialBounds bounds;
+    gpointer item;
+} RTreeEntry;
+
+static SpatialBounds bounds_union(const SpatialBounds *a, const SpatialBounds *b) {
+    double min_x = fmin(a->x, b->x);
+    double min_y = fmin(a->y, b->y);
+    double max_x = fmax(a->x + a->width, b->x + b->width);
+    double max_y = fmax(a->y + a->height, b->y + b->height);
+    return (SpatialBounds){ min_x, min_y, max_x - min_x, max_y - min_y };
+}
+
+static double bounds_area(const SpatialBounds *bounds) {
+    return bounds->width * bounds->height;
+}
+
+static gboolean bounds_equal(const SpatialBounds *a, const SpatialBounds *b) {
+    return a->x == b->x && a->y == b->y && a->width == b->width && a->height == b->height;
+}
+
+static int compare_entry_x(const void *a, const void *b) {
+    const RTreeEntry *entry_a = a;
+    const RTreeEntry *entry_b = b;
+    double center_a = entry_a->bounds.x + entry_a->bounds.width / 2.0;
+    double center_b = entry_b->bounds.x + entry_b->bounds.width / 2.0;
+    return (center_a > center_b) - (center_a < center_b);
+}
+
+static int compare_entry_y(const void *a, const void *b) {
+    const RTreeEntry *entry_a = a;
+    const RTreeEntry *entry_b = b;
+    double center_a = entry_a->bounds.y + entry_a->bounds.height / 2.0;
+    double center_b = entry_b->bounds.y + entry_b->bounds.height / 2.0;
+    return (center_a > center_b) - (center_a < center_b);
+}
+
+static RTreeNode* rtree_node_new(gboolean leaf) {
+    RTreeNode *node = g_new0(RTreeNode, 1);
+    node->leaf = leaf;
+    return node;
+}
+
+static void rtree_node_free(RTreeNode *node) {
+    if (!node->leaf) {
+        for (guint i = 0; i < node->count; i++) {
+            rtree_node_free(node->entries[i]);
+        }
+    }
+    g_free(node);
+}
+
+static void rtree_node_recompute_bounds(RTreeNode *node) {
+    if (node->count == 0) {
+        node->bounds = (SpatialBounds){ 0, 0, 0, 0 };
+        return;
+    }
+    node->bounds = node->entry_bounds[0];
+    for (guint i = 1; i < node->count; i++) {
+        node->bounds = bounds_union(&node->bounds, &node->entry_bounds[i]);
+    }
+}
+
+// Store an entry in a node and record who now owns the item
+static void rtree_node_add(RTree *tree, RTreeNode *node, gpointer item, const SpatialBounds *bounds) {
+    node->entries[node->count] = item;
+    node->entry_bounds[node->count] = *bounds;
+    node->count++;
+
+    if (node->leaf) {
+        g_hash_table_insert(tree->leaves, item, node);
+    } else {
+        ((RTreeNode*)item)->parent = node;
+    }
+}
+
+static guint rtree_node_slot(RTreeNode *node, gpointer item) {
+    for (guint i = 0; i < node->count; i++) {
+        if (node->entries[i] == item) return i;
+    }
+    g_assert_not_reached();
+    return 0;
+}
+
+static void rtree_node_remove_slot(RTreeNode *node, guint slot) {
+    node->count--;
+    node->entries[slot] = node->entries[node->count];
+    node->entry_bounds[slot] = node->entry_bounds[node->count];
+}
+
+// Sort-Tile-Recursive: sort by x, cut into vertical slices of about
+// sqrt(node count) nodes each, sort each slice by y and fill nodes in order.
+// Returns one entry per packed node, in the same buffer.
+static guint rtree_pack_level(RTree *tree, RTreeEntry *entries, guint count, gboolean leaf) {
+    guint node_count = (count + RTREE_MAX_ENTRIES - 1) / RTREE_MAX_ENTRIES;
+    guint slice_count = (guint)ceil(sqrt((double)node_count));
+    guint slice_size = slice_count * RTREE_MAX_ENTRIES;
+
+    qsort(entries, count, sizeof(RTreeEntry), compare_entry_x);
+    for (guint start = 0; start < count; start += slice_size) {
+        qsort(entries + start, MIN(slice_size, count - start), sizeof(RTreeEntry), compare_entry_y);
+    }
+
+    // Each packed node is written to an index no greater than the first entry it consumed
+    guint packed = 0;
+    for (guint start = 0; start < count; start += RTREE_MAX_ENTRIES) {
+        RTreeNode *node = rtree_node_new(leaf);
+        guint end = MIN(start + RTREE_MAX_ENTRIES, count);
+        for (guint i = start; i < end; i++) {
+            rtree_node_add(tree, node, entries[i].item, &entries[i].bounds);
+        }
+        rtree_node_recompute_bounds(node);
+        entries[packed].bounds = node->bounds;
+        entries[packed].item = node;
+        packed++;
+    }
+    return packed;
+}
+
+// Move half of an overflowing node into a new sibling, cutting along the
+// longer axis of its bounds, and hang the sibling off the parent
+static void rtree_node_split(RTree *tree, RTreeNode *node) {
+    GArray *scratch = tree->scratch;
+    g_array_set_size(scratch, node->count);
+    RTreeEntry *entries = (RTreeEntry*)scratch->data;
+    for (guint i = 0; i < node->count; i++) {
+        entries[i].bounds = node->entry_bounds[i];
+        entries[i].item = node->entries[i];
+    }
+
+    rtree_node_recompute_bounds(node);
+    gboolean by_x = node->bounds.width >= node->bounds.height;
+    qsort(entries, node->count, sizeof(RTreeEntry), by_x ? compare_entry_x : compare_entry_y);
+
+    guint total = node->count;
+    guint keep = total / 2;
+    RTreeNode *sibling = rtree_node_new(node->leaf);
+    node->count = 0;
+    for (guint i = 0; i < total; i++) {
+        rtree_node_add(tree, i < keep ? node : sibling, entries[i].item, &entries[i].bounds);
+    }
+    rtree_node_recompute_bounds(sibling);
+
+    if (!node->parent) {
+        RTreeNode *root = rtree_node_new(FALSE);
+        rtree_node_add(tree, root, node, &node->bounds);
+        tree->root = root;
+    }
+    rtree_node_add(tree, node->parent, sibling, &sibling->bounds);
+}
+
+// Split overflowing nodes and tighten bounds from node up to the root
+static void rtree_adjust_upward(RTree *tree, RTreeNode *node) {
+    while (node) {
+        if (node->count > RTREE_MAX_ENTRIES) {
+            rtree_node_split(tree, node);
+        }
+        rtree_node_recompute_bounds(node);
+
+        RTreeNode *parent = node->parent;
+        if (parent) {
+            parent->entry_bounds[rtree_node_slot(parent, node)] = node->bounds;
+        }
+        node = parent;
+    }
+}
+
+// Descend along the child whose bounds grow least, preferring smaller children on ties
+static RTreeNode* rtree_choose_leaf(RTree *tree, const SpatialBounds *bounds) {
+    RTreeNode *node = tree->root;
+    while (!node->leaf) {
+        guint best = 0;
+        double best_growth = INFINITY;
+        double best_area = INFINITY;
+        for (guint i = 0; i < node->count; i++) {
+            double area = bounds_area(&node->entry_bounds[i]);
+            SpatialBounds grown = bounds_union(&node->entry_bounds[i], bounds);
+            double growth = bounds_area(&grown) - area;
+            if (growth < best_growth || (growth == best_growth && area < best_area)) {
+                best = i;
+                best_growth = growth;
+                best_area = area;
+            }
+        }
+        node = node->entries[best];
+    }
+    return node;
+}
+
+static void rtree_insert(RTree *tree, Element *element, const SpatialBounds *bounds) {
+    RTreeNode *leaf = rtree_choose_leaf(tree, bounds);
+    rtree_node_add(tree, leaf, element, bounds);
+    rtree_adjust_upward(tree, leaf);
+}
+
+// Underfull nodes are kept rather than re-inserted; the canvas bulk-loads
+// again whenever a space is loaded, which repacks everything
+static void rtree_remove_from_leaf(RTree *tree, RTreeNode *leaf, Element *element) {
+    rtree_node_remove_slot(leaf, rtree_node_slot(leaf, element));
+    g_hash_table_remove(tree->leaves, element);
+
+    RTreeNode *node = leaf;
+    while (node != tree->root && node->count == 0) {
+        RTreeNode *parent = node->parent;
+        rtree_node_remove_slot(parent, rtree_node_slot(parent, node));
+        g_free(node);
+        node = parent;
+    }
+    rtree_adjust_upward(tree, node);
+
+    // Drop root levels that only forward to a single child
+    while (!tree->root->leaf && tree->root->count <= 1) {
+        RTreeNode *old_root = tree->root;
+        if (old_root->count == 0) {
+            old_root->leaf = TRUE;
+            break;
+        }
+        tree->root = old_root->entries[0];
+        tree->root->parent = NULL;
+        g_free(old_root);
+    }
+}
+
+static gboolean rtree_node_visit_point(RTreeNode *node, double x, double y, guint stamp,
+                                       SpatialVisitFunc func, gpointer user_data) {
+    for (guint i = 0; i < node->count; i++) {
+        if (!spatial_bounds_contains_point(&node->entry_bounds[i], x, y)) {
+            continue;
+        }
+        if (!node->leaf) {
+            if (!rtree_node_visit_point(node->entries[i], x, y, stamp, func, user_data)) {
+                return FALSE;
+            }
+            continue;
+        }
+
+        Element *element = node->entries[i];
+        element->spatial_stamp = stamp;
+        if (!func(element, user_data)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static gboolean rtree_node_visit_rect(RTreeNode *node, const SpatialBounds *rect, guint stamp,
+                                      SpatialVisitFunc func, gpointer user_data) {
+    for (guint i = 0; i < node->count; i++) {
+        if (!spatial_bounds_intersects(&node->entry_bounds[i], rect)) {
+            continue;
+        }
+        if (!node->leaf) {
+            if (!rtree_node_visit_rect(node->entries[i], rect, stamp, func, user_data)) {
+                return FALSE;
+            }
+            continue;
+        }
+
+        // Same final test as the quadtree: the element's current bounds
+        Element *element = node->entries[i];
+        if (!spatial_bounds_intersects_element(rect, element)) {
+            continue;
+        }
+        element->spatial_stamp = stamp;
+        if (!func(element, user_data)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static void rtree_index_free(SpatialIndex *index) {
+    rtree_free((RTree*)index);
+}
+
+static void rtree_index_clear(SpatialIndex *index) {
+    rtree_clear((RTree*)index);
+}
+
+static void rtree_index_update(SpatialIndex *index, Element *element) {
+    rtree_update((RTree*)index, element);
+}
+
+static void rtree_index_remove(SpatialIndex *index, Element *element) {
+    rtree_remove((RTree*)index, element);
+}
+
+static gboolean rtree_index_contains(SpatialIndex *index, Element *element) {
+    return rtree_contains((RTree*)index, element);
+}
+
+static void rtree_index_bulk_load(SpatialIndex *index, Element **elements, guint count) {
+    rtree_bulk_load((RTree*)index, elements, count);
+}
+
+static void rtree_index_visit_point(SpatialIndex *index, double x, double y, guint stamp,
+                                    SpatialVisitFunc func, gpointer user_data) {
+    rtree_node_visit_point(((RTree*)index)->root, x, y, stamp, func, user_data);
+}
+
+static void rtree_index_visit_rect(SpatialIndex *index, const SpatialBounds *rect, guint stamp,
+                                   SpatialVisitFunc func, gpointer user_data) {
+    rtree_node_visit_rect(((RTree*)index)->root, rect, stamp, func, user_data);
+}
+
+static const SpatialIndexVTable rtree_vtable = {
+    .name = "rtree",
+    .free = rtree_index_free,
+    .clear = rtree_index_clear,
+    .update = rtree_index_update,
+    .remove = rtree_index_remove,
+    .contains = rtree_index_contains,
+    .bulk_load = rtree_index_bulk_load,
+    .visit_point = rtree_index_visit_point,
+    .visit_rect = rtree_index_visit_rect,
+};
+
+RTree* rtree_new(void) {
+    RTree *tree = g_new0(RTree, 1);
+    tree->base.vtable = &rtree_vtable;
+    tree->root = rtree_node_new(TRUE);
+    tree->leaves = g_hash_table_new(g_direct_hash, g_direct_equal);
+    tree->scratch = g_array_new(FALSE, FALSE, sizeof(RTreeEntry));
+    return tree;
+}
+
+void rtree_free(RTree *tree) {
+    if (!tree) return;
+    rtree_node_free(tree->root);
+    g_hash_table_destroy(tree->leaves);
+    g_array_free(tree->scratch, TRUE);
+    g_free(tree);
+}
+
+void rtree_clear(RTree *tree) {
+    if (!tree) return;
+    rtree_node_free(tree->root);
+    tree->root = rtree_node_new(TRUE);
+    g_hash_table_remove_all(tree->leaves);
+}
+
+void rtree_bulk_load(RTree *tree, Element **elements, guint count) {
+    if (!tree) return;
+    rtree_clear(tree);
+
+    GArray *scratch = tree->scratch;
+    g_array_set_size(scratch, 0);
+    for (guint i = 0; i < count; i++) {
+        // Duplicates would leave stale leaf entries behind
+        if (g_hash_table_contains(tree->leaves, elements[i])) continue;
+        g_hash_table_insert(tree->leaves, elements[i], NULL);
+
+        RTreeEntry entry;
+        spatial_index_element_bounds(elements[i], &entry.bounds);
+        entry.item = elements[i];
+        g_array_append_val(scratch, entry);
+    }
+    if (scratch->len == 0) return;
+
+    RTreeEntry *entries = (RTreeEntry*)scratch->data;
+    guint level_count = scratch->len;
+    gboolean leaf = TRUE;
+    while (level_count > RTREE_MAX_ENTRIES) {
+        level_count = rtree_pack_level(tree, entries, level_count, leaf);
+        leaf = FALSE;
+    }
+
+    RTreeNode *root = tree->root;
+    root->leaf = leaf;
+    for (guint i = 0; i < level_count; i++) {
+        rtree_node_add(tree, root, entries[i].item, &entries[i].bounds);
+    }
+    rtree_node_recompute_bounds(root);
+    g_array_set_size(scratch, 0);
+}
+
+void rtree_update(RTree *tree, Element *element) {
+    if (!tree || !element) return;
+
+    SpatialBounds bounds;
+    spatial_index_element_bounds(element, &bounds);
+
+    RTreeNode *leaf = g_hash_table_lookup(tree->leaves, element);
+    if (leaf) {
+        if (bounds_equal(&leaf->entry_bounds[rtree_node_slot(leaf, element)], &bounds)) {
+            return;
+        }
+        rtree_remove_from_leaf(tree, leaf, element);
+    }
+    rtree_insert(tree, element, &bounds);
+}
+
+void rtree_remove(RTree *tree, Element *element) {
+    if (!tree || !element) return;
+
+    RTreeNode *leaf = g_hash_table_lookup(tree->leaves, element);
+    if (leaf) {
+        rtree_remove_from_leaf(tree, leaf, element);
+    }
+}
+
+gboolean rtree_contains(RTree *tree, Element *element) {
+    return tree && element && g_hash_table_contains(tree->leaves, element);
+}
@@ -0,0 +1,46 @@
+#ifndef RTREE_H
+#define RTREE_H
+
+#include <glib.h>
+#include "elements/element.h"
+#include "spatial_index.h"
+
+// Entries per node. Nodes hold one spare slot so an insert can overflow
+// before the node is split.
+#define RTREE_MAX_ENTRIES 16
+
+typedef struct RTreeNode RTreeNode;
+
+struct RTreeNode {
+    SpatialBounds bounds;     // Union of entry_bounds
+    RTreeNode *parent;        // NULL for the root
+    gboolean leaf;
+    guint count;
+    SpatialBounds entry_bounds[RTREE_MAX_ENTRIES + 1];
+    gpointer entries[RTREE_MAX_ENTRIES + 1];  // Element* in leaves, RTreeNode* above
+};
+
+// R-tree packed with Sort-Tile-Recursive bulk loading. Bulk-loaded trees
+// have full, barely overlapping nodes, so queries touch few of them; later
+// edits insert along least enlargement and split on the longer axis, which
+// keeps the tree usable until the next bulk load repacks it.
+typedef struct {
+    SpatialIndex base;    // Must stay first; the tree is usable as a SpatialIndex
+    RTreeNode *root;
+    GHashTable *leaves;   // Element* -> RTreeNode* leaf holding it
+    GArray *scratch;      // Reused entry buffer for packing and splitting
+} RTree;
+
+RTree* rtree_new(void);
+void rtree_free(RTree *tree);
+void rtree_clear(RTree *tree);
+
+// Replace the content with these elements, packed level by level
+void rtree_bulk_load(RTree *tree, Element **elements, guint count);
+
+// Insert an element or re-index it after it changed bounds
+void rtree_update(RTree *tree, Element *element);
+void rtree_remove(RTree *tree, Element *element);
+gboolean rtree_contains(RTree *tree, Element *element);
+
+#endif
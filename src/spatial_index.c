@@ -0,0 +1,165 @@
+#include "spatial_index.h"
+#include "quadtree.h"
+#include "rtree.h"
+#include <math.h>
+#include <string.h>
+
+// Padding around connection endpoints so arrowheads and stroke stay inside the indexed bounds
+#define SPATIAL_INDEX_CONNECTION_PADDING 12.0
+
+void spatial_index_element_bounds(Element *element, SpatialBounds *bounds) {
+    double elem_x = element->x;
+    double elem_y = element->y;
+    double elem_width = element->width;
+    double elem_height = element->height;
+
+    if (element->type == ELEMENT_CONNECTION) {
+        // Connection bounds span its endpoints; the path never leaves that box
+        // but arrowheads extend past it
+        bounds->x = elem_x - SPATIAL_INDEX_CONNECTION_PADDING;
+        bounds->y = elem_y - SPATIAL_INDEX_CONNECTION_PADDING;
+        bounds->width = elem_width + 2 * SPATIAL_INDEX_CONNECTION_PADDING;
+        bounds->height = elem_height + 2 * SPATIAL_INDEX_CONNECTION_PADDING;
+        return;
+    }
+
+    // Strokes and shadows paint past the box; tiles and culling must see them
+    double margin = element_get_draw_margin(element);
+
+    // Fast path for non-rotated elements (most common case)
+    if (element->rotation_degrees == 0.0) {
+        bounds->x = elem_x - margin;
+        bounds->y = elem_y - margin;
+        bounds->width = elem_width + 2 * margin;
+        bounds->height = elem_height + 2 * margin;
+        return;
+    }
+
+    // Slow path for rotated elements - calculate axis-aligned bounding box
+    double cx = elem_x + elem_width / 2.0;
+    double cy = elem_y + elem_height / 2.0;
+    double angle = element->rotation_degrees * M_PI / 180.0;
+    double cos_a = cos(angle);
+    double sin_a = sin(angle);
+    double half_w = elem_width / 2.0;
+    double half_h = elem_height / 2.0;
+
+    // Calculate four corners
+    double dx1 = -half_w * cos_a + half_h * sin_a;
+    double dy1 = -half_w * sin_a - half_h * cos_a;
+    double dx2 = half_w * cos_a + half_h * sin_a;
+    double dy2 = half_w * sin_a - half_h * cos_a;
+
+    // Find min/max efficiently
+    double min_x = cx + fmin(fmin(dx1, -dx1), fmin(dx2, -dx2));
+    double max_x = cx + fmax(fmax(dx1, -dx1), fmax(dx2, -dx2));
+    double min_y = cy + fmin(fmin(dy1, -dy1), fmin(dy2, -dy2));
+    double max_y = cy + fmax(fmax(dy1, -dy1), fmax(dy2, -dy2));
+
+    bounds->x = min_x - margin;
+    bounds->y = min_y - margin;
+    bounds->width = max_x - min_x + 2 * margin;
+    bounds->height = max_y - min_y + 2 * margin;
+}
+
+gboolean spatial_bounds_intersects_element(const SpatialBounds *bounds, Element *element) {
+    SpatialBounds elem_bounds;
+    spatial_index_element_bounds(element, &elem_bounds);
+    return spatial_bounds_intersects(bounds, &elem_bounds);
+}
+
+SpatialIndex* spatial_index_new(SpatialIndexKind kind) {
+    double half = SPATIAL_INDEX_INITIAL_EXTENT / 2.0;
+    switch (kind) {
+    case SPATIAL_INDEX_RTREE:
+        return (SpatialIndex*)rtree_new();
+    case SPATIAL_INDEX_QUADTREE:
+    default:
+        return (SpatialIndex*)quadtree_new(-half, -half, SPATIAL_INDEX_INITIAL_EXTENT, SPATIAL_INDEX_INITIAL_EXTENT);
+    }
+}
+
+void spatial_index_free(SpatialIndex *index) {
+    if (!index) return;
+    index->vtable->free(index);
+}
+
+const char* spatial_index_name(SpatialIndex *index) {
+    return index ? index->vtable->name : NULL;
+}
+
+SpatialIndexKind spatial_index_kind_from_string(const char *name, SpatialIndexKind fallback) {
+    if (g_strcmp0(name, "quadtree") == 0) return SPATIAL_INDEX_QUADTREE;
+    if (g_strcmp0(name, "rtree") == 0) return SPATIAL_INDEX_RTREE;
+    return fallback;
+}
+
+void spatial_index_clear(SpatialIndex *index) {
+    if (!index) return;
+    index->vtable->clear(index);
+}
+
+void spatial_index_update(SpatialIndex *index, Element *element) {
+    if (!index || !element) return;
+    index->vtable->update(index, element);
+}
+
+void spatial_index_remove(SpatialIndex *index, Element *element) {
+    if (!index || !element) return;
+    index->vtable->remove(index, element);
+}
+
+gboolean spatial_index_contains(SpatialIndex *index, Element *element) {
+    return index && element && index->vtable->contains(index, element);
+}
+
+void spatial_index_bulk_load(SpatialIndex *index, Element **elements, guint count) {
+    if (!index) return;
+    if (index->vtable->bulk_load) {
+        index->vtable->bulk_load(index, elements, count);
+        return;
+    }
+
+    index->vtable->clear(index);
+    for (guint i = 0; i < count; i++) {
+        index->vtable->update(index, elements[i]);
+    }
+}
+
+static guint spatial_index_next_stamp(SpatialIndex *index) {
+    // Stamp 0 is what fresh elements carry, so never hand it out
+    if (++index->query_stamp == 0) {
+        index->query_stamp = 1;
+    }
+    return index->query_stamp;
+}
+
+void spatial_index_visit_point(SpatialIndex *index, double x, double y,
+                               SpatialVisitFunc func, gpointer user_data) {
+    if (!index || !func) return;
+    index->vtable->visit_point(index, x, y, spatial_index_next_stamp(index), func, user_data);
+}
+
+void spatial_index_visit_rect(SpatialIndex *index, double x, double y, double width, double height,
+                              SpatialVisitFunc func, gpointer user_data) {
+    if (!index || !func) return;
+    SpatialBounds rect = { x, y, width, height };
+    index->vtable->visit_rect(index, &rect, spatial_index_next_stamp(index), func, user_data);
+}
+
+static gboolean spatial_index_collect_visitor(Element *element, gpointer user_data) {
+    g_ptr_array_add((GPtrArray*)user_data, element);
+    return TRUE;
+}
+
+void spatial_index_query_point(SpatialIndex *index, double x, double y, GPtrArray *results) {
+    if (!results) return;
+    spatial_index_visit_point(index, x, y, spatial_index_collect_visitor, results);
+}
+
+guint spatial_index_query_rect(SpatialIndex *index, double x, double y, double width, double height,
+                               GPtrArray *results) {
+    if (!index || !results) return 0;
+    spatial_index_visit_rect(index, x, y, width, height, spatial_index_collect_visitor, results);
+    return index->query_stamp;
+}
@@ -0,0 +1,99 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <glib.h>
+#include "elements/element.h"
+
+typedef struct {
+    double x, y, width, height;
+} SpatialBounds;
+
+// Called once per element found by a visit; return FALSE to stop early
+typedef gboolean (*SpatialVisitFunc)(Element *element, gpointer user_data);
+
+typedef enum {
+    SPATIAL_INDEX_QUADTREE,  // Dynamic; cheap incremental edits
+    SPATIAL_INDEX_RTREE,     // STR bulk-loaded; tightest for mostly static spaces
+} SpatialIndexKind;
+
+typedef struct SpatialIndex SpatialIndex;
+
+// Backend operations. Every backend indexes elements by the bounds they had
+// when last inserted or updated, so remove works after the element moved.
+typedef struct {
+    const char *name;
+    void (*free)(SpatialIndex *index);
+    void (*clear)(SpatialIndex *index);
+    void (*update)(SpatialIndex *index, Element *element);
+    void (*remove)(SpatialIndex *index, Element *element);
+    gboolean (*contains)(SpatialIndex *index, Element *element);
+    // Replace the whole content; NULL falls back to clear plus updates
+    void (*bulk_load)(SpatialIndex *index, Element **elements, guint count);
+    void (*visit_point)(SpatialIndex *index, double x, double y, guint stamp,
+                        SpatialVisitFunc func, gpointer user_data);
+    void (*visit_rect)(SpatialIndex *index, const SpatialBounds *rect, guint stamp,
+                       SpatialVisitFunc func, gpointer user_data);
+} SpatialIndexVTable;
+
+struct SpatialIndex {
+    const SpatialIndexVTable *vtable;
+    guint query_stamp;  // Bumped per query to de-duplicate elements seen twice
+};
+
+// Starting extent for backends that need one; content outside it is still indexed
+#define SPATIAL_INDEX_INITIAL_EXTENT 100000.0
+
+SpatialIndex* spatial_index_new(SpatialIndexKind kind);
+void spatial_index_free(SpatialIndex *index);
+const char* spatial_index_name(SpatialIndex *index);
+
+// Parse a backend name ("quadtree", "rtree"); unknown names give the fallback
+SpatialIndexKind spatial_index_kind_from_string(const char *name, SpatialIndexKind fallback);
+
+void spatial_index_clear(SpatialIndex *index);
+
+// Add an element, or re-index it after it moved, resized or rotated. Cheap
+// when its bounds are unchanged.
+void spatial_index_update(SpatialIndex *index, Element *element);
+void spatial_index_remove(SpatialIndex *index, Element *element);
+gboolean spatial_index_contains(SpatialIndex *index, Element *element);
+
+// Rebuild from scratch with exactly these elements
+void spatial_index_bulk_load(SpatialIndex *index, Element **elements, guint count);
+
+// Visit elements whose indexed area contains a point (picking candidates;
+// the caller does the precise hit test). Each element is visited once.
+void spatial_index_visit_point(SpatialIndex *index, double x, double y,
+                               SpatialVisitFunc func, gpointer user_data);
+
+// Visit every element whose bounds intersect a rectangle, once each
+void spatial_index_visit_rect(SpatialIndex *index, double x, double y, double width, double height,
+                              SpatialVisitFunc func, gpointer user_data);
+
+// Append the picking candidates at a point to a caller-owned array
+void spatial_index_query_point(SpatialIndex *index, double x, double y, GPtrArray *results);
+
+// Query elements whose bounds intersect a rectangle (for viewport culling).
+// Each element is appended to results once. Returns the stamp written to
+// Element.spatial_stamp for every reported element.
+guint spatial_index_query_rect(SpatialIndex *index, double x, double y, double width, double height,
+                               GPtrArray *results);
+
+// Axis-aligned bounds an element is indexed with (rotation, stroke, shadow and
+// connection arrowheads included)
+void spatial_index_element_bounds(Element *element, SpatialBounds *bounds);
+
+// Inline because every backend calls these once per visited node
+static inline gboolean spatial_bounds_intersects(const SpatialBounds *a, const SpatialBounds *b) {
+    return !(a->x > b->x + b->width || a->x + a->width < b->x ||
+             a->y > b->y + b->height || a->y + a->height < b->y);
+}
+
+static inline gboolean spatial_bounds_contains_point(const SpatialBounds *bounds, double x, double y) {
+    return x >= bounds->x && x <= bounds->x + bounds->width &&
+           y >= bounds->y && y <= bounds->y + bounds->height;
+}
+
+gboolean spatial_bounds_intersects_element(const SpatialBounds *bounds, Element *element);
+
+#endif
@@ -397,17 +397,18 @@ void undo_manager_undo(UndoManager *manager) {
 
     // Make sure it's in the elements hash table if it should be
     if (delete_data->previous_state == MODEL_STATE_SAVED &&
-        !g_hash_table_contains(manager->model->elements, delete_data->element->uuid)) {
-      g_hash_table_insert(manager->model->elements,
-                          g_strdup(delete_data->element->uuid),
-                          delete_data->element);
+        !model_get_element(manager->model, model_element_handle(delete_data->element))) {
+      model_insert_element(manager->model, delete_data->element);
     }
+    model_index_element(manager->model, delete_data->element);
+    model_mark_dirty(manager->model, delete_data->element);
     break;
   }
   case ACTION_CREATE_ELEMENT: {
     CreateData *create_data = (CreateData*)action->data;
     // For creation undo, mark as deleted
     create_data->element->state = MODEL_STATE_DELETED;
+    model_mark_dirty(manager->model, create_data->element);
     break;
   }
   case ACTION_CREATE_ELEMENT_BATCH: {
@@ -415,6 +416,7 @@ void undo_manager_undo(UndoManager *manager) {
     for (GList *l = batch_data->elements; l != NULL; l = l->next) {
       ModelElement *element = (ModelElement*)l->data;
       element->state = MODEL_STATE_DELETED;
+      model_mark_dirty(manager->model, element);
     }
     break;
   }
@@ -480,12 +482,15 @@ void undo_manager_redo(UndoManager *manager) {
     DeleteData *delete_data = (DeleteData*)action->data;
     // Delete element again
     delete_data->element->state = MODEL_STATE_DELETED;
+    model_mark_dirty(manager->model, delete_data->element);
     break;
   }
   case ACTION_CREATE_ELEMENT: {
     CreateData *create_data = (CreateData*)action->data;
     // For creation redo, restore the initial state
     create_data->element->state = create_data->initial_state;
+    model_index_element(manager->model, create_data->element);
+    model_mark_dirty(manager->model, create_data->element);
     break;
   }
   case ACTION_CREATE_ELEMENT_BATCH: {
@@ -493,6 +498,8 @@ void undo_manager_redo(UndoManager *manager) {
     for (GList *l = batch_data->elements; l != NULL; l = l->next) {
       ModelElement *element = (ModelElement*)l->data;
       element->state = MODEL_STATE_NEW; // Or some other appropriate state
+      model_index_element(manager->model, element);
+      model_mark_dirty(manager->model, element);
     }
     break;
   }
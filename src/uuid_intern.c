@@ -0,0 +1,129 @@
+#include "uuid_intern.h"
+#include <string.h>
+#include <uuid/uuid.h>
+
+typedef struct {
+  uuid_t bytes;    // Binary UUID; zero for verbatim ids
+  char *text;      // Verbatim id when the string is not a canonical UUID
+  UuidHandle handle;
+} UuidEntry;
+
+// Process-wide table. Entries are allocated one by one and never freed, so
+// pointers into them stay valid while the handle array grows.
+static GMutex uuid_lock;
+static GHashTable *uuid_by_key = NULL;   // UuidEntry* (as key) -> same entry
+static GPtrArray *uuid_entries = NULL;   // Index = handle; slot 0 unused
+
+static guint uuid_entry_hash(gconstpointer key) {
+  const UuidEntry *entry = key;
+  if (entry->text) {
+    return g_str_hash(entry->text);
+  }
+  // Random UUIDs are uniformly distributed; any four bytes hash well
+  guint32 hash;
+  memcpy(&hash, entry->bytes + 12, sizeof(hash));
+  return hash;
+}
+
+static gboolean uuid_entry_equal(gconstpointer a, gconstpointer b) {
+  const UuidEntry *left = a;
+  const UuidEntry *right = b;
+  if (left->text || right->text) {
+    return left->text && right->text && strcmp(left->text, right->text) == 0;
+  }
+  return uuid_compare(left->bytes, right->bytes) == 0;
+}
+
+static void uuid_table_ensure(void) {
+  if (!uuid_by_key) {
+    uuid_by_key = g_hash_table_new(uuid_entry_hash, uuid_entry_equal);
+    uuid_entries = g_ptr_array_new();
+    g_ptr_array_add(uuid_entries, NULL);
+  }
+}
+
+// Fill a probe key for a string. Verbatim ids borrow the caller's string.
+// Only strings that format back identically are stored binary, so
+// uuid_intern_string() gives back exactly the string that was interned.
+static void uuid_probe_init(UuidEntry *probe, const char *uuid) {
+  memset(probe, 0, sizeof(*probe));
+  char canonical[UUID_STRING_LENGTH];
+  gboolean binary = uuid_parse(uuid, probe->bytes) == 0;
+  if (binary) {
+    uuid_unparse(probe->bytes, canonical);
+    binary = strcmp(canonical, uuid) == 0;
+  }
+  if (!binary) {
+    uuid_clear(probe->bytes);
+    probe->text = (char*)uuid;
+  }
+}
+
+UuidHandle uuid_intern(const char *uuid) {
+  if (!uuid) return UUID_HANDLE_NONE;
+
+  UuidEntry probe;
+  uuid_probe_init(&probe, uuid);
+
+  g_mutex_lock(&uuid_lock);
+  uuid_table_ensure();
+
+  UuidEntry *entry = g_hash_table_lookup(uuid_by_key, &probe);
+  if (!entry) {
+    entry = g_new0(UuidEntry, 1);
+    uuid_copy(entry->bytes, probe.bytes);
+    entry->text = g_strdup(probe.text);
+    entry->handle = uuid_entries->len;
+    g_ptr_array_add(uuid_entries, entry);
+    g_hash_table_add(uuid_by_key, entry);
+  }
+  UuidHandle handle = entry->handle;
+
+  g_mutex_unlock(&uuid_lock);
+  return handle;
+}
+
+UuidHandle uuid_intern_lookup(const char *uuid) {
+  if (!uuid) return UUID_HANDLE_NONE;
+
+  UuidEntry probe;
+  uuid_probe_init(&probe, uuid);
+
+  g_mutex_lock(&uuid_lock);
+  UuidEntry *entry = uuid_by_key ? g_hash_table_lookup(uuid_by_key, &probe) : NULL;
+  UuidHandle handle = entry ? entry->handle : UUID_HANDLE_NONE;
+  g_mutex_unlock(&uuid_lock);
+  return handle;
+}
+
+static UuidEntry* uuid_entry_get(UuidHandle handle) {
+  g_mutex_lock(&uuid_lock);
+  UuidEntry *entry = NULL;
+  if (uuid_entries && handle != UUID_HANDLE_NONE && handle < uuid_entries->len) {
+    entry = g_ptr_array_index(uuid_entries, handle);
+  }
+  g_mutex_unlock(&uuid_lock);
+  return entry;
+}
+
+const char* uuid_intern_string(UuidHandle handle, char buffer[UUID_STRING_LENGTH]) {
+  UuidEntry *entry = uuid_entry_get(handle);
+  if (!entry) return NULL;
+  if (entry->text) return entry->text;
+
+  uuid_unparse(entry->bytes, buffer);
+  return buffer;
+}
+
+const guint8* uuid_intern_bytes(UuidHandle handle) {
+  UuidEntry *entry = uuid_entry_get(handle);
+  if (!entry || entry->text) return NULL;
+  return entry->bytes;
+}
+
+guint uuid_intern_count(void) {
+  g_mutex_lock(&uuid_lock);
+  guint count = uuid_entries ? uuid_entries->len - 1 : 0;
+  g_mutex_unlock(&uuid_lock);
+  return count;
+}
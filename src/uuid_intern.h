@@ -0,0 +1,35 @@
+#ifndef UUID_INTERN_H
+#define UUID_INTERN_H
+
+#include <glib.h>
+
+// Dense integer handle for an interned UUID. Handles start at 1 and are
+// never reused, so they can key direct hash tables and be compared with ==
+// on paths that run per element per frame. Strings are only needed at the
+// database and DSL boundaries.
+typedef guint32 UuidHandle;
+
+#define UUID_HANDLE_NONE 0
+#define UUID_STRING_LENGTH 37  // 36 characters + NUL
+
+#define UUID_HANDLE_TO_POINTER(handle) GUINT_TO_POINTER(handle)
+#define UUID_POINTER_TO_HANDLE(pointer) ((UuidHandle)GPOINTER_TO_UINT(pointer))
+
+// Return the handle for a UUID string, interning it on first sight.
+// Canonical UUIDs are stored as 16 binary bytes; anything else (ids made up
+// by tests or older files) is kept verbatim. NULL gives UUID_HANDLE_NONE.
+UuidHandle uuid_intern(const char *uuid);
+
+// Like uuid_intern() but never adds; UUID_HANDLE_NONE when unknown
+UuidHandle uuid_intern_lookup(const char *uuid);
+
+// String form of a handle. Canonical UUIDs are formatted into buffer;
+// verbatim ids are returned directly. NULL for an unknown handle.
+const char* uuid_intern_string(UuidHandle handle, char buffer[UUID_STRING_LENGTH]);
+
+// Binary form, or NULL for unknown handles and verbatim ids
+const guint8* uuid_intern_bytes(UuidHandle handle);
+
+guint uuid_intern_count(void);
+
+#endif
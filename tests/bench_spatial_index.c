@@ -0,0 +1,120 @@
+#include <glib.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "spatial_index.h"
+
+// Compares the spatial index backends on synthetic content: notes scattered
+// over a square whose area grows with the element count, so density stays
+// close to a real board. Run with `make bench-spatial-index`.
+
+#define BENCH_POINT_QUERIES 100000
+#define BENCH_RECT_QUERIES 2000
+#define BENCH_VIEWPORT_WIDTH 1920.0
+#define BENCH_VIEWPORT_HEIGHT 1080.0
+// Average canvas area per element, roughly one 150x100 note per 400x400 cell
+#define BENCH_AREA_PER_ELEMENT (400.0 * 400.0)
+
+static const guint bench_sizes[] = { 10000, 100000, 1000000 };
+
+typedef struct {
+  guint found;
+} BenchCount;
+
+static gboolean bench_count_visit(Element *element, gpointer user_data) {
+  (void)element;
+  ((BenchCount*)user_data)->found++;
+  return TRUE;
+}
+
+static Element* bench_make_elements(guint count, double extent, GRand *rand) {
+  Element *elements = g_new0(Element, count);
+  for (guint i = 0; i < count; i++) {
+    Element *element = &elements[i];
+    element->type = ELEMENT_NOTE;
+    element->x = g_rand_double_range(rand, 0.0, extent);
+    element->y = g_rand_double_range(rand, 0.0, extent);
+    element->width = g_rand_double_range(rand, 50.0, 300.0);
+    element->height = g_rand_double_range(rand, 40.0, 200.0);
+    element->rotation_degrees = g_rand_int_range(rand, 0, 20) == 0 ? 15.0 : 0.0;
+  }
+  return elements;
+}
+
+static double bench_elapsed_ms(gint64 start) {
+  return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+static void bench_backend(SpatialIndexKind kind, Element *elements, Element **pointers,
+                          guint count, double extent, guint32 seed) {
+  SpatialIndex *index = spatial_index_new(kind);
+
+  gint64 start = g_get_monotonic_time();
+  spatial_index_bulk_load(index, pointers, count);
+  double build_ms = bench_elapsed_ms(start);
+
+  // Incremental build, the path taken by edits after a space is loaded
+  SpatialIndex *incremental = spatial_index_new(kind);
+  start = g_get_monotonic_time();
+  for (guint i = 0; i < count; i++) {
+    spatial_index_update(incremental, &elements[i]);
+  }
+  double insert_ms = bench_elapsed_ms(start);
+  spatial_index_free(incremental);
+
+  // Same query positions for every backend
+  GRand *rand = g_rand_new_with_seed(seed);
+  BenchCount points = { 0 };
+  start = g_get_monotonic_time();
+  for (guint i = 0; i < BENCH_POINT_QUERIES; i++) {
+    double x = g_rand_double_range(rand, 0.0, extent);
+    double y = g_rand_double_range(rand, 0.0, extent);
+    spatial_index_visit_point(index, x, y, bench_count_visit, &points);
+  }
+  double point_us = bench_elapsed_ms(start) * 1000.0 / BENCH_POINT_QUERIES;
+
+  BenchCount rects = { 0 };
+  start = g_get_monotonic_time();
+  for (guint i = 0; i < BENCH_RECT_QUERIES; i++) {
+    double x = g_rand_double_range(rand, 0.0, extent - BENCH_VIEWPORT_WIDTH);
+    double y = g_rand_double_range(rand, 0.0, extent - BENCH_VIEWPORT_HEIGHT);
+    spatial_index_visit_rect(index, x, y, BENCH_VIEWPORT_WIDTH, BENCH_VIEWPORT_HEIGHT,
+                             bench_count_visit, &rects);
+  }
+  double rect_us = bench_elapsed_ms(start) * 1000.0 / BENCH_RECT_QUERIES;
+  g_rand_free(rand);
+
+  printf("%-9s %9u %11.1f %12.1f %11.3f %10.1f %12.2f %9.1f\n",
+         spatial_index_name(index), count, build_ms, insert_ms,
+         point_us, (double)points.found / BENCH_POINT_QUERIES,
+         rect_us, (double)rects.found / BENCH_RECT_QUERIES);
+
+  spatial_index_free(index);
+}
+
+int main(void) {
+  printf("%-9s %9s %11s %12s %11s %10s %12s %9s\n",
+         "backend", "elements", "bulk ms", "insert ms",
+         "point us", "point hits", "viewport us", "vp hits");
+
+  for (guint s = 0; s < G_N_ELEMENTS(bench_sizes); s++) {
+    guint count = bench_sizes[s];
+    double extent = sqrt(count * BENCH_AREA_PER_ELEMENT);
+
+    GRand *rand = g_rand_new_with_seed(42 + s);
+    Element *elements = bench_make_elements(count, extent, rand);
+    g_rand_free(rand);
+
+    Element **pointers = g_new(Element*, count);
+    for (guint i = 0; i < count; i++) {
+      pointers[i] = &elements[i];
+    }
+
+    bench_backend(SPATIAL_INDEX_QUADTREE, elements, pointers, count, extent, 7 + s);
+    bench_backend(SPATIAL_INDEX_RTREE, elements, pointers, count, extent, 7 + s);
+
+    g_free(pointers);
+    g_free(elements);
+  }
+  return 0;
+}
@@ -95,7 +95,7 @@ static ModelElement* add_note(CanvasData *canvas, int x, int y) {
   model_element->visual_element = create_visual_element(model_element, canvas);
   g_assert_nonnull(model_element->visual_element);
 
-  canvas_rebuild_quadtree(canvas);
+  canvas_rebuild_spatial_index(canvas);
 
   return model_element;
 }
@@ -31,8 +31,8 @@ static void test_setup(TestFixture *fixture, gconstpointer user_data) {
   // Create minimal canvas data structure for tree view
   fixture->canvas_data = g_new0(CanvasData, 1);
   fixture->canvas_data->model = fixture->model;
-  fixture->canvas_data->hidden_elements = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-  fixture->canvas_data->hidden_children_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  fixture->canvas_data->hidden_elements = g_hash_table_new(g_direct_hash, g_direct_equal);
+  fixture->canvas_data->hidden_children_cache = g_hash_table_new(g_direct_hash, g_direct_equal);
 
   // Initialize tree view (we'll create it in individual tests if needed)
   fixture->tree_view = NULL;
@@ -23,7 +23,7 @@ static ElementConfig make_note_config(void) {
 static void test_animate_move_accepts_uuid(void) {
   CanvasData *data = g_new0(CanvasData, 1);
   data->next_z_index = 1;
-  data->dsl_aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  data->dsl_aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 
   const char *db_path = "test_dsl_uuid.db";
   remove(db_path);
@@ -66,7 +66,7 @@ static void test_animate_move_accepts_uuid(void) {
 static void test_animate_color_updates_model(void) {
   CanvasData *data = g_new0(CanvasData, 1);
   data->next_z_index = 1;
-  data->dsl_aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  data->dsl_aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 
   const char *db_path = "test_dsl_color.db";
   remove(db_path);
@@ -79,9 +79,9 @@ static void test_animate_color_updates_model(void) {
   const char *color_script = "animate_color circle_B color(0.5,0.5,0.5,1) color(1,0,0,1) 0 0\n";
   canvas_execute_script_internal(data, color_script, "color_test_update.dsl", FALSE);
 
-  const gchar *uuid = g_hash_table_lookup(data->dsl_aliases, "circle_B");
-  g_assert_nonnull(uuid);
-  ModelElement *element = g_hash_table_lookup(data->model->elements, uuid);
+  UuidHandle handle = UUID_POINTER_TO_HANDLE(g_hash_table_lookup(data->dsl_aliases, "circle_B"));
+  g_assert_cmpuint(handle, !=, UUID_HANDLE_NONE);
+  ModelElement *element = model_get_element(data->model, handle);
   g_assert_nonnull(element);
   g_assert_nonnull(element->bg_color);
   g_assert_cmpfloat_with_epsilon(element->bg_color->r, 1.0, 1e-6);
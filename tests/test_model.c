@@ -1,5 +1,6 @@
 #include "model.h"
 #include "database.h"
+#include "elements/shape.h"
 #include <glib.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,7 +31,7 @@ static void test_teardown(TestFixture *fixture, gconstpointer user_data) {
     model_free(fixture->model);
   }
   if (fixture->db) {
-    sqlite3_close(fixture->db);
+    database_close(fixture->db);
   }
   remove(TEST_DB_FILE);
 }
@@ -54,7 +55,7 @@ static void test_model_creation(TestFixture *fixture, gconstpointer user_data) {
   g_assert_nonnull(fixture->model);
   g_assert_nonnull(fixture->model->current_space_uuid);
   g_assert_nonnull(fixture->model->elements);
-  g_assert_nonnull(fixture->model->types);
+  g_assert_true(model_type_get(ELEMENT_NOTE) == model_type_get(ELEMENT_NOTE));
   g_assert_nonnull(fixture->model->texts);
   g_assert_nonnull(fixture->model->positions);
   g_assert_nonnull(fixture->model->sizes);
@@ -191,7 +192,7 @@ static void test_delete_element(TestFixture *fixture, gconstpointer user_data) {
   model_save_elements(fixture->model);
 
   // Verify element is gone
-  g_assert_null(g_hash_table_lookup(fixture->model->elements, uuid));
+  g_assert_null(model_lookup_element(fixture->model, uuid));
   g_free(uuid);
 
   // Cleanup
@@ -348,6 +349,574 @@ static void test_cyclic_connection_space_movement(TestFixture *fixture, gconstpo
   g_free(conn_config.connection.to_element_uuid);
 }
 
+// Test: Graph walks follow connections through the adjacency index, including
+// after a connection is re-pointed or its source deleted
+static void test_connection_adjacency(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig note_config = create_basic_config(ELEMENT_NOTE, "Note");
+  ElementConfig conn_config = create_basic_config(ELEMENT_CONNECTION, NULL);
+
+  ModelElement *parent = model_create_element(fixture->model, note_config);
+  ModelElement *child = model_create_element(fixture->model, note_config);
+  ModelElement *other = model_create_element(fixture->model, note_config);
+
+  conn_config.connection.from_element_uuid = parent->uuid;
+  conn_config.connection.to_element_uuid = child->uuid;
+  ModelElement *conn = model_create_element(fixture->model, conn_config);
+
+  GList *children = find_children_bfs(fixture->model, parent->uuid);
+  g_assert_cmpuint(g_list_length(children), ==, 2);
+  g_assert_nonnull(g_list_find(children, child));
+  g_assert_nonnull(g_list_find(children, conn));
+  g_list_free(children);
+
+  // Walks in both directions from the child reach the whole component
+  GList *connected = find_connected_elements_bfs(fixture->model, child->uuid);
+  g_assert_cmpuint(g_list_length(connected), ==, 3);
+  g_list_free(connected);
+
+  // Re-point the connection at another note
+  model_element_set_string(conn, &conn->to_element_uuid, other->uuid);
+  model_index_connection(fixture->model, conn);
+
+  children = find_children_bfs(fixture->model, parent->uuid);
+  g_assert_null(g_list_find(children, child));
+  g_assert_nonnull(g_list_find(children, other));
+  g_list_free(children);
+
+  connected = find_connected_elements_bfs(fixture->model, child->uuid);
+  g_assert_cmpuint(g_list_length(connected), ==, 1);
+  g_list_free(connected);
+
+  // Deleting an endpoint deletes the connection with it
+  model_delete_element(fixture->model, parent);
+  g_assert_cmpint(conn->state, ==, MODEL_STATE_DELETED);
+
+  g_free(note_config.text.text);
+  g_free(note_config.text.font_description);
+  g_free(conn_config.text.font_description);
+}
+
+static void test_uuid_handles(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *first = model_create_element(fixture->model, config);
+  ModelElement *second = model_create_element(fixture->model, config);
+
+  UuidHandle handle = model_element_handle(first);
+  g_assert_cmpuint(handle, !=, UUID_HANDLE_NONE);
+  g_assert_cmpuint(handle, !=, model_element_handle(second));
+  g_assert_cmpuint(uuid_intern(first->uuid), ==, handle);
+  g_assert_cmpuint(uuid_intern_lookup(first->uuid), ==, handle);
+  g_assert_nonnull(uuid_intern_bytes(handle));
+
+  char buffer[UUID_STRING_LENGTH];
+  g_assert_cmpstr(uuid_intern_string(handle, buffer), ==, first->uuid);
+
+  // Ids that are not canonical UUIDs round-trip verbatim
+  UuidHandle custom = uuid_intern("test-element");
+  g_assert_cmpuint(custom, ==, uuid_intern("test-element"));
+  g_assert_cmpstr(uuid_intern_string(custom, buffer), ==, "test-element");
+  g_assert_null(uuid_intern_bytes(custom));
+  g_assert_cmpuint(uuid_intern_lookup("never-interned"), ==, UUID_HANDLE_NONE);
+
+  // model->elements is keyed by handle; strings resolve through the table
+  g_assert_true(model_get_element(fixture->model, handle) == first);
+  g_assert_true(model_lookup_element(fixture->model, second->uuid) == second);
+  g_assert_null(model_lookup_element(fixture->model, "never-interned"));
+
+  // Connection endpoints are interned when the connection is indexed
+  ElementConfig connection_config = create_basic_config(ELEMENT_CONNECTION, NULL);
+  connection_config.connection.from_element_uuid = first->uuid;
+  connection_config.connection.to_element_uuid = second->uuid;
+  ModelElement *connection = model_create_element(fixture->model, connection_config);
+  g_assert_cmpuint(model_connection_from(connection), ==, handle);
+  g_assert_cmpuint(model_connection_to(connection), ==, model_element_handle(second));
+
+  g_free(connection_config.text.text);
+  g_free(connection_config.text.font_description);
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: Saves only visit elements changed since the last save, and only
+// write the fields that changed
+static void test_dirty_queue(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *moved = model_create_element(fixture->model, config);
+  model_create_element(fixture->model, config);
+  model_create_element(fixture->model, config);
+  g_assert_cmpuint(g_hash_table_size(fixture->model->dirty), ==, 3);
+
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 3);
+  g_assert_cmpuint(g_hash_table_size(fixture->model->dirty), ==, 0);
+
+  model_update_position(fixture->model, moved, 500, 600, 1);
+  model_update_rotation(fixture->model, moved, 45.0);
+  g_assert_cmpint(moved->state, ==, MODEL_STATE_UPDATED);
+  g_assert_cmpuint(moved->changed_fields, ==, MODEL_FIELD_POSITION | MODEL_FIELD_ROTATION);
+  g_assert_cmpuint(g_hash_table_size(fixture->model->dirty), ==, 1);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 1);
+  g_assert_cmpint(moved->state, ==, MODEL_STATE_SAVED);
+  g_assert_cmpuint(moved->changed_fields, ==, 0);
+
+  // Nothing changed since
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 0);
+
+  // The narrow update reached the database
+  char *uuid = g_strdup(moved->uuid);
+  model_load_space(fixture->model);
+  ModelElement *loaded = model_lookup_element(fixture->model, uuid);
+  g_assert_nonnull(loaded);
+  g_assert_cmpint(loaded->position->x, ==, 500);
+  g_assert_cmpint(loaded->position->y, ==, 600);
+  g_assert_cmpfloat(loaded->rotation_degrees, ==, 45.0);
+  g_assert_nonnull(loaded->text);
+  g_assert_cmpstr(loaded->text->text, ==, "Note");
+  g_free(uuid);
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: A batch that rolls back stays queued with its states untouched
+static void test_failed_save_requeues(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *updated = model_create_element(fixture->model, config);
+  ModelElement *deleted = model_create_element(fixture->model, config);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 2);
+
+  model_update_position(fixture->model, updated, 300, 400, 1);
+  model_delete_element(fixture->model, deleted);
+  ModelElement *created = model_create_element(fixture->model, config);
+  char *deleted_uuid = g_strdup(deleted->uuid);
+  char *created_uuid = g_strdup(created->uuid);
+
+  // Fail the insert after the delete and update already ran
+  g_assert_cmpint(sqlite3_exec(fixture->db,
+                               "CREATE TEMP TRIGGER test_fail_insert BEFORE INSERT ON main.elements "
+                               "BEGIN SELECT RAISE(ABORT, 'forced failure'); END;",
+                               NULL, NULL, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 0);
+
+  g_assert_cmpuint(g_hash_table_size(fixture->model->dirty), ==, 3);
+  g_assert_cmpint(updated->state, ==, MODEL_STATE_UPDATED);
+  g_assert_cmpuint(updated->changed_fields, ==, MODEL_FIELD_POSITION);
+  g_assert_cmpint(created->state, ==, MODEL_STATE_NEW);
+  g_assert_cmpint(created->position->id, ==, -1);
+  g_assert_true(model_lookup_element(fixture->model, deleted_uuid) == deleted);
+  g_assert_cmpint(deleted->state, ==, MODEL_STATE_DELETED);
+
+  // Nothing from the batch reached the database
+  ModelElement *db_element = NULL;
+  g_assert_cmpint(database_read_element(fixture->db, deleted_uuid, &db_element), ==, 1);
+  g_assert_nonnull(db_element);
+  g_free(db_element->uuid);
+  g_free(db_element);
+  ModelPosition *position = NULL;
+  g_assert_cmpint(database_read_position_ref(fixture->db, updated->position->id, &position), ==, 1);
+  g_assert_nonnull(position);
+  g_assert_cmpint(position->x, ==, 100);
+  g_free(position);
+
+  // The retry saves the whole batch
+  g_assert_cmpint(sqlite3_exec(fixture->db, "DROP TRIGGER test_fail_insert;", NULL, NULL, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 3);
+  g_assert_cmpuint(g_hash_table_size(fixture->model->dirty), ==, 0);
+  g_assert_cmpint(updated->state, ==, MODEL_STATE_SAVED);
+  g_assert_cmpint(created->state, ==, MODEL_STATE_SAVED);
+  g_assert_null(model_lookup_element(fixture->model, deleted_uuid));
+
+  char *updated_uuid = g_strdup(updated->uuid);
+  model_load_space(fixture->model);
+  ModelElement *loaded = model_lookup_element(fixture->model, updated_uuid);
+  g_assert_nonnull(loaded);
+  g_assert_cmpint(loaded->position->x, ==, 300);
+  g_assert_cmpint(loaded->position->y, ==, 400);
+  g_assert_nonnull(model_lookup_element(fixture->model, created_uuid));
+  g_assert_null(model_lookup_element(fixture->model, deleted_uuid));
+
+  g_free(updated_uuid);
+  g_free(created_uuid);
+  g_free(deleted_uuid);
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: Editing a ref shared by clones queues every clone for the canvas
+static void test_clone_shared_ref_changed(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *original = model_create_element(fixture->model, config);
+  ModelElement *other = model_create_element(fixture->model, config);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 2);
+
+  ModelElement *clone = model_element_clone(fixture->model, original, CLONE_FLAG_TEXT);
+  g_assert_nonnull(clone);
+  g_assert_true(clone->text == original->text);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 1);
+  g_list_free(model_take_changed(fixture->model, NULL));
+
+  g_assert_cmpint(model_update_text(fixture->model, clone, "Edited"), ==, 1);
+
+  GList *changed = model_take_changed(fixture->model, NULL);
+  g_assert_cmpuint(g_list_length(changed), ==, 2);
+  g_assert_nonnull(g_list_find(changed, original));
+  g_assert_nonnull(g_list_find(changed, clone));
+  g_assert_null(g_list_find(changed, other));
+  g_list_free(changed);
+
+  // Only the edited clone writes the shared row
+  g_assert_cmpuint(g_hash_table_size(fixture->model->dirty), ==, 1);
+  g_assert_cmpint(original->state, ==, MODEL_STATE_SAVED);
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: The canvas change queue survives saves and lists connections last
+static void test_changed_queue(TestFixture *fixture, gconstpointer user_data) {
+  gboolean reloaded = FALSE;
+  GList *changed = model_take_changed(fixture->model, &reloaded);
+  g_assert_true(reloaded);
+  g_list_free(changed);
+
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *a = model_create_element(fixture->model, config);
+  ModelElement *b = model_create_element(fixture->model, config);
+  ElementConfig connection_config = create_basic_config(ELEMENT_CONNECTION, NULL);
+  connection_config.connection.from_element_uuid = a->uuid;
+  connection_config.connection.to_element_uuid = b->uuid;
+  ModelElement *connection = model_create_element(fixture->model, connection_config);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 3);
+
+  changed = model_take_changed(fixture->model, &reloaded);
+  g_assert_false(reloaded);
+  g_assert_cmpuint(g_list_length(changed), ==, 3);
+  g_assert_true(g_list_last(changed)->data == connection);
+  g_list_free(changed);
+
+  // Only what changed since the last take
+  model_update_position(fixture->model, b, 300, 300, 1);
+  changed = model_take_changed(fixture->model, &reloaded);
+  g_assert_cmpuint(g_list_length(changed), ==, 1);
+  g_assert_true(changed->data == b);
+  g_list_free(changed);
+  g_assert_null(model_take_changed(fixture->model, &reloaded));
+
+  GPtrArray *connections = g_ptr_array_new();
+  model_collect_element_connections(fixture->model, b, connections);
+  g_assert_cmpuint(connections->len, ==, 1);
+  g_assert_true(g_ptr_array_index(connections, 0) == connection);
+  g_ptr_array_free(connections, TRUE);
+
+  // Deleted elements are reported until the save drops them
+  model_delete_element(fixture->model, a);
+  model_save_elements(fixture->model);
+  g_assert_null(model_take_changed(fixture->model, &reloaded));
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+  g_free(connection_config.text.text);
+  g_free(connection_config.text.font_description);
+}
+
+// Test: Cached statements are reset between uses and stay valid across saves
+static void test_statement_reuse(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *element = model_create_element(fixture->model, config);
+  model_save_elements(fixture->model);
+
+  for (int i = 1; i <= 3; i++) {
+    model_update_position(fixture->model, element, 100 * i, 50 * i, 1);
+    g_assert_cmpint(model_save_elements(fixture->model), ==, 1);
+
+    ModelPosition *position = NULL;
+    g_assert_cmpint(database_read_position_ref(fixture->db, element->position->id, &position), ==, 1);
+    g_assert_nonnull(position);
+    g_assert_cmpint(position->x, ==, 100 * i);
+    g_assert_cmpint(position->y, ==, 50 * i);
+    g_free(position);
+  }
+
+  // Alternate column groups on the same element; each save must leave the
+  // other group's column as last written
+  sqlite3_stmt *stmt = NULL;
+  g_assert_cmpint(sqlite3_prepare_v2(fixture->db, "SELECT stroke_width, description FROM elements WHERE uuid = ?",
+                                     -1, &stmt, NULL), ==, SQLITE_OK);
+  int expected_stroke_width = element->stroke_width;
+  char *expected_description = NULL;
+  for (int i = 1; i <= 4; i++) {
+    if (i % 2) {
+      element->stroke_width = expected_stroke_width = i + 1;
+      model_mark_updated(fixture->model, element, MODEL_FIELD_SHAPE);
+    } else {
+      g_free(expected_description);
+      expected_description = g_strdup_printf("Description %d", i);
+      model_element_set_string(element, &element->description, expected_description);
+      model_mark_updated(fixture->model, element, MODEL_FIELD_DESCRIPTION);
+    }
+    g_assert_cmpint(model_save_elements(fixture->model), ==, 1);
+
+    sqlite3_reset(stmt);
+    sqlite3_bind_text(stmt, 1, element->uuid, -1, SQLITE_STATIC);
+    g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+    g_assert_cmpint(sqlite3_column_int(stmt, 0), ==, expected_stroke_width);
+    g_assert_cmpstr((const char *)sqlite3_column_text(stmt, 1), ==, expected_description);
+  }
+  sqlite3_finalize(stmt);
+  g_free(expected_description);
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: Editing drawing points of a saved shape reaches the database
+static void test_drawing_points_update(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_SHAPE, "");
+  config.shape.shape_type = SHAPE_BEZIER;
+  GArray *points = g_array_new(FALSE, FALSE, sizeof(DrawingPoint));
+  for (int i = 0; i < 4; i++) {
+    DrawingPoint point;
+    graphene_point_init(&point, i * 0.25f, 0.0f);
+    g_array_append_val(points, point);
+  }
+  config.drawing.drawing_points = points;
+  ModelElement *element = model_create_element(fixture->model, config);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 1);
+
+  // Same edit as releasing a bezier control point on the canvas
+  DrawingPoint edited[4];
+  memcpy(edited, element->drawing_points->data, sizeof(edited));
+  edited[1].y = 0.75f;
+  edited[2].y = -0.5f;
+  g_assert_cmpint(model_update_drawing_points(fixture->model, element, edited, G_N_ELEMENTS(edited)), ==, 1);
+  g_assert_cmpuint(element->changed_fields, ==, MODEL_FIELD_SHAPE);
+  g_assert_cmpint(model_save_elements(fixture->model), ==, 1);
+
+  char *uuid = g_strdup(element->uuid);
+  model_load_space(fixture->model);
+  ModelElement *loaded = model_lookup_element(fixture->model, uuid);
+  g_assert_nonnull(loaded);
+  g_assert_nonnull(loaded->drawing_points);
+  g_assert_cmpuint(loaded->drawing_points->len, ==, 4);
+  g_assert_cmpfloat(g_array_index(loaded->drawing_points, DrawingPoint, 1).y, ==, 0.75f);
+  g_assert_cmpfloat(g_array_index(loaded->drawing_points, DrawingPoint, 2).y, ==, -0.5f);
+  g_assert_cmpfloat(g_array_index(loaded->drawing_points, DrawingPoint, 3).x, ==, 0.75f);
+  g_free(uuid);
+
+  g_array_free(points, TRUE);
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: Ref counts follow element rows; orphans wait for collection
+static void test_ref_counts(TestFixture *fixture, gconstpointer user_data) {
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *element = model_create_element(fixture->model, config);
+  model_save_elements(fixture->model);
+  int position_id = element->position->id;
+
+  ModelPosition *position = NULL;
+  g_assert_cmpint(database_read_position_ref(fixture->db, position_id, &position), ==, 1);
+  g_assert_nonnull(position);
+  g_assert_cmpint(position->ref_count, ==, 1);
+  g_free(position);
+
+  model_delete_element(fixture->model, element);
+  model_save_elements(fixture->model);
+
+  g_assert_cmpint(database_read_position_ref(fixture->db, position_id, &position), ==, 1);
+  g_assert_nonnull(position);
+  g_assert_cmpint(position->ref_count, ==, 0);
+  g_free(position);
+
+  g_assert_cmpint(database_collect_orphaned_refs(fixture->db, 1), >=, 1);
+  g_assert_cmpint(database_read_position_ref(fixture->db, position_id, &position), ==, 1);
+  g_assert_null(position);
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: Orphans left by a save are collected in the background
+static void test_ref_collector(TestFixture *fixture, gconstpointer user_data) {
+  g_assert_nonnull(fixture->model->ref_collector);
+
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Note");
+  ModelElement *element = model_create_element(fixture->model, config);
+  model_save_elements(fixture->model);
+  int position_id = element->position->id;
+
+  model_delete_element(fixture->model, element);
+  model_save_elements(fixture->model);
+
+  // The collector waits a moment after the request, then deletes in batches
+  ModelPosition *position = NULL;
+  gint64 deadline = g_get_monotonic_time() + 10 * G_TIME_SPAN_SECOND;
+  do {
+    g_free(position);
+    position = NULL;
+    g_usleep(50 * 1000);
+    g_assert_cmpint(database_read_position_ref(fixture->db, position_id, &position), ==, 1);
+  } while (position && g_get_monotonic_time() < deadline);
+  g_assert_null(position);
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
+// Test: New databases are brought to the latest schema version
+static void test_schema_migrations(TestFixture *fixture, gconstpointer user_data) {
+  sqlite3_stmt *stmt;
+  g_assert_cmpint(sqlite3_prepare_v2(fixture->db, "PRAGMA user_version", -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+  g_assert_cmpint(sqlite3_column_int(stmt, 0), >=, 4);
+  sqlite3_finalize(stmt);
+
+  // Loading a space looks elements up by index
+  const char *sql = "EXPLAIN QUERY PLAN SELECT uuid FROM elements WHERE space_uuid = ?";
+  g_assert_cmpint(sqlite3_prepare_v2(fixture->db, sql, -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+  g_assert_nonnull(strstr((const char*)sqlite3_column_text(stmt, 3), "elements_space_uuid"));
+  sqlite3_finalize(stmt);
+}
+
+// Test: A database from before inline types is migrated on open
+static void test_legacy_schema_migration(void) {
+  const char *path = "test_model_legacy.db";
+  remove(path);
+
+  sqlite3 *legacy = NULL;
+  g_assert_cmpint(sqlite3_open(path, &legacy), ==, SQLITE_OK);
+  char *sql = g_strdup_printf(
+    "CREATE TABLE spaces (uuid TEXT PRIMARY KEY, name TEXT NOT NULL, parent_uuid TEXT,"
+    "  is_current BOOLEAN DEFAULT 0, background_color TEXT DEFAULT '#181818',"
+    "  grid_enabled BOOLEAN DEFAULT 1, grid_color TEXT DEFAULT '#26262666',"
+    "  created_at DATETIME DEFAULT CURRENT_TIMESTAMP, FOREIGN KEY (parent_uuid) REFERENCES spaces(uuid));"
+    "CREATE TABLE element_type_refs (id INTEGER PRIMARY KEY AUTOINCREMENT, type INTEGER NOT NULL,"
+    "  ref_count INTEGER DEFAULT 1, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+    "CREATE TABLE position_refs (id INTEGER PRIMARY KEY AUTOINCREMENT, x INTEGER NOT NULL, y INTEGER NOT NULL,"
+    "  z INTEGER NOT NULL, ref_count INTEGER DEFAULT 1, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+    "CREATE TABLE size_refs (id INTEGER PRIMARY KEY AUTOINCREMENT, width INTEGER NOT NULL, height INTEGER NOT NULL,"
+    "  ref_count INTEGER DEFAULT 1, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+    "CREATE TABLE text_refs (id INTEGER PRIMARY KEY AUTOINCREMENT, text TEXT NOT NULL,"
+    "  text_r REAL NOT NULL DEFAULT 0.1, text_g REAL NOT NULL DEFAULT 0.1, text_b REAL NOT NULL DEFAULT 0.1,"
+    "  text_a REAL NOT NULL DEFAULT 1.0, font_description TEXT DEFAULT 'Ubuntu Mono Bold 16',"
+    "  strikethrough BOOLEAN DEFAULT 0, alignment TEXT DEFAULT 'center',"
+    "  ref_count INTEGER DEFAULT 1, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+    "CREATE TABLE color_refs (id INTEGER PRIMARY KEY AUTOINCREMENT, r REAL NOT NULL, g REAL NOT NULL,"
+    "  b REAL NOT NULL, a REAL NOT NULL, ref_count INTEGER DEFAULT 1, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+    "CREATE TABLE elements (uuid TEXT PRIMARY KEY, space_uuid TEXT NOT NULL, type_id INTEGER NOT NULL,"
+    "  position_id INTEGER NOT NULL, size_id INTEGER NOT NULL, text_id INTEGER, bg_color_id INTEGER,"
+    "  from_element_uuid TEXT, to_element_uuid TEXT, from_point INTEGER, to_point INTEGER,"
+    "  target_space_uuid TEXT, image_id INTEGER, video_id INTEGER, audio_id INTEGER, drawing_points BLOB,"
+    "  stroke_width INTEGER, shape_type INTEGER, filled INTEGER, stroke_style INTEGER DEFAULT 0,"
+    "  fill_style INTEGER DEFAULT 0, stroke_color TEXT, connection_type INTEGER, arrowhead_type INTEGER,"
+    "  rotation_degrees REAL DEFAULT 0.0, description TEXT, locked INTEGER NOT NULL DEFAULT 0,"
+    "  created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+    "  FOREIGN KEY (space_uuid) REFERENCES spaces(uuid),"
+    "  FOREIGN KEY (type_id) REFERENCES element_type_refs(id),"
+    "  FOREIGN KEY (position_id) REFERENCES position_refs(id),"
+    "  FOREIGN KEY (size_id) REFERENCES size_refs(id),"
+    "  FOREIGN KEY (text_id) REFERENCES text_refs(id),"
+    "  FOREIGN KEY (bg_color_id) REFERENCES color_refs(id),"
+    "  FOREIGN KEY (from_element_uuid) REFERENCES elements(uuid),"
+    "  FOREIGN KEY (to_element_uuid) REFERENCES elements(uuid),"
+    "  FOREIGN KEY (target_space_uuid) REFERENCES spaces(uuid));"
+    "INSERT INTO spaces (uuid, name, is_current) VALUES ('legacy-space', 'Legacy', 1);"
+    "INSERT INTO element_type_refs (id, type) VALUES (1, %d), (2, %d), (3, 999);"
+    "INSERT INTO position_refs (id, x, y, z) VALUES (1, 10, 20, 1), (2, 300, 20, 1);"
+    "INSERT INTO size_refs (id, width, height) VALUES (1, 100, 80);"
+    "INSERT INTO text_refs (id, text) VALUES (1, 'Legacy note');"
+    "INSERT INTO color_refs (id, r, g, b, a) VALUES (1, 0.5, 0.5, 0.5, 1.0);"
+    "INSERT INTO elements (uuid, space_uuid, type_id, position_id, size_id, text_id, bg_color_id) VALUES"
+    "  ('legacy-a', 'legacy-space', 1, 1, 1, 1, 1),"
+    "  ('legacy-b', 'legacy-space', 1, 2, 1, 1, 1),"
+    "  ('legacy-bad', 'legacy-space', 3, 1, 1, NULL, 1);"
+    "INSERT INTO elements (uuid, space_uuid, type_id, position_id, size_id, bg_color_id,"
+    "  from_element_uuid, to_element_uuid, from_point, to_point, connection_type, arrowhead_type) VALUES"
+    "  ('legacy-link', 'legacy-space', 2, 1, 1, 1, 'legacy-a', 'legacy-b', 1, 3, 0, 1);",
+    ELEMENT_NOTE, ELEMENT_CONNECTION);
+  g_assert_cmpint(sqlite3_exec(legacy, sql, NULL, NULL, NULL), ==, SQLITE_OK);
+  g_free(sql);
+  sqlite3_close(legacy);
+
+  Model *model = model_new_with_file(path);
+  g_assert_nonnull(model);
+  g_assert_cmpstr(model->current_space_uuid, ==, "legacy-space");
+
+  sqlite3_stmt *stmt;
+  g_assert_cmpint(sqlite3_prepare_v2(model->db, "PRAGMA user_version", -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+  g_assert_cmpint(sqlite3_column_int(stmt, 0), >=, 4);
+  sqlite3_finalize(stmt);
+
+  // Types are inline and the lookup table is gone
+  g_assert_cmpint(sqlite3_prepare_v2(model->db, "SELECT type FROM elements WHERE uuid = 'legacy-link'", -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+  g_assert_cmpint(sqlite3_column_int(stmt, 0), ==, ELEMENT_CONNECTION);
+  sqlite3_finalize(stmt);
+  g_assert_cmpint(sqlite3_prepare_v2(model->db, "SELECT type_id FROM elements", -1, &stmt, NULL), !=, SQLITE_OK);
+  g_assert_cmpint(sqlite3_prepare_v2(model->db,
+                  "SELECT 1 FROM sqlite_master WHERE name = 'element_type_refs'", -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_DONE);
+  sqlite3_finalize(stmt);
+
+  // The rebuilt table has its indexes and no dangling references
+  const char *indexes[] = { "elements_space_uuid", "elements_from_element_uuid", "elements_to_element_uuid",
+                            "elements_position_id", "elements_text_id", "spaces_parent_uuid" };
+  for (guint i = 0; i < G_N_ELEMENTS(indexes); i++) {
+    g_assert_cmpint(sqlite3_prepare_v2(model->db,
+                    "SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = ?", -1, &stmt, NULL), ==, SQLITE_OK);
+    sqlite3_bind_text(stmt, 1, indexes[i], -1, SQLITE_STATIC);
+    g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+    sqlite3_finalize(stmt);
+  }
+  g_assert_cmpint(sqlite3_prepare_v2(model->db, "PRAGMA foreign_key_check", -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_DONE);
+  sqlite3_finalize(stmt);
+
+  // Loaded elements carry their migrated types; the unknown type is skipped
+  ModelElement *note = model_lookup_element(model, "legacy-a");
+  ModelElement *link = model_lookup_element(model, "legacy-link");
+  g_assert_nonnull(note);
+  g_assert_nonnull(link);
+  g_assert_cmpint(note->type->type, ==, ELEMENT_NOTE);
+  g_assert_cmpstr(note->text->text, ==, "Legacy note");
+  g_assert_cmpint(link->type->type, ==, ELEMENT_CONNECTION);
+  g_assert_true(model_get_element(model, model_connection_from(link)) == note);
+  g_assert_cmpint(link->to_point, ==, 3);
+  g_assert_null(model_lookup_element(model, "legacy-bad"));
+
+  sqlite3 *db = model->db;
+  model_free(model);
+  database_close(db);
+  remove(path);
+}
+
+// Test: Loads and search use a separate connection that sees each commit
+static void test_read_connection(TestFixture *fixture, gconstpointer user_data) {
+  g_assert_nonnull(fixture->model->read_db);
+  g_assert_true(fixture->model->read_db != fixture->db);
+
+  sqlite3_stmt *stmt;
+  g_assert_cmpint(sqlite3_prepare_v2(fixture->db, "PRAGMA journal_mode", -1, &stmt, NULL), ==, SQLITE_OK);
+  g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+  g_assert_cmpstr((const char*)sqlite3_column_text(stmt, 0), ==, "wal");
+  sqlite3_finalize(stmt);
+
+  ElementConfig config = create_basic_config(ELEMENT_NOTE, "Committed");
+  ModelElement *element = model_create_element(fixture->model, config);
+  model_save_elements(fixture->model);
+
+  ModelElement *read = NULL;
+  g_assert_cmpint(database_read_element(fixture->model->read_db, element->uuid, &read), ==, 1);
+  g_assert_nonnull(read);
+  g_assert_cmpstr(read->text->text, ==, "Committed");
+  model_element_free(read);
+
+  g_free(config.text.text);
+  g_free(config.text.font_description);
+}
+
 static void test_model_get_all_spaces(TestFixture *fixture, gconstpointer user_data) {
   // Create a test space
   char *test_space_uuid = NULL;
@@ -395,6 +964,19 @@ int main(int argc, char *argv[]) {
   g_test_add("/model/delete-element", TestFixture, NULL, test_setup, test_delete_element, test_teardown);
   g_test_add("/model/search", TestFixture, NULL, test_setup, test_search_multiple_spaces, test_teardown);
   g_test_add("/model/cyclic-connection-space-movement", TestFixture, NULL, test_setup, test_cyclic_connection_space_movement, test_teardown);
+  g_test_add("/model/connection-adjacency", TestFixture, NULL, test_setup, test_connection_adjacency, test_teardown);
+  g_test_add("/model/uuid-handles", TestFixture, NULL, test_setup, test_uuid_handles, test_teardown);
+  g_test_add("/model/dirty-queue", TestFixture, NULL, test_setup, test_dirty_queue, test_teardown);
+  g_test_add("/model/changed-queue", TestFixture, NULL, test_setup, test_changed_queue, test_teardown);
+  g_test_add("/model/clone-shared-ref-changed", TestFixture, NULL, test_setup, test_clone_shared_ref_changed, test_teardown);
+  g_test_add("/model/failed-save-requeues", TestFixture, NULL, test_setup, test_failed_save_requeues, test_teardown);
+  g_test_add("/model/drawing-points-update", TestFixture, NULL, test_setup, test_drawing_points_update, test_teardown);
+  g_test_add("/model/statement-reuse", TestFixture, NULL, test_setup, test_statement_reuse, test_teardown);
+  g_test_add("/model/ref-counts", TestFixture, NULL, test_setup, test_ref_counts, test_teardown);
+  g_test_add("/model/ref-collector", TestFixture, NULL, test_setup, test_ref_collector, test_teardown);
+  g_test_add("/model/schema-migrations", TestFixture, NULL, test_setup, test_schema_migrations, test_teardown);
+  g_test_add_func("/model/legacy-schema-migration", test_legacy_schema_migration);
+  g_test_add("/model/read-connection", TestFixture, NULL, test_setup, test_read_connection, test_teardown);
   g_test_add("/model/get-all-spaces", TestFixture, NULL, test_setup, test_model_get_all_spaces, test_teardown);
 
   return g_test_run();
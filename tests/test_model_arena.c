@@ -0,0 +1,218 @@
+#include "model_arena.h"
+#include <glib.h>
+#include <string.h>
+
+typedef struct {
+  gpointer link;
+  double value;
+  int id;
+} TestObject;
+
+static void count_object(gpointer object, gpointer user_data) {
+  (void)object;
+  (*(guint*)user_data)++;
+}
+
+// Test: Blocks double in size until the slab has room for every object
+static void test_slab_growth(void) {
+  ModelSlab slab = {0};
+  GPtrArray *objects = g_ptr_array_new();
+
+  for (int i = 0; i < 256; i++) {
+    g_ptr_array_add(objects, model_slab_new0(&slab, TestObject));
+  }
+  g_assert_cmpuint(slab.blocks->len, ==, 1);
+  g_assert_cmpuint(slab.live, ==, 256);
+
+  g_ptr_array_add(objects, model_slab_new0(&slab, TestObject));
+  g_assert_cmpuint(slab.blocks->len, ==, 2);
+
+  // Second block holds 512 objects, the third is started by the next one
+  for (int i = 0; i < 511; i++) {
+    g_ptr_array_add(objects, model_slab_new0(&slab, TestObject));
+  }
+  g_assert_cmpuint(slab.blocks->len, ==, 2);
+  g_ptr_array_add(objects, model_slab_new0(&slab, TestObject));
+  g_assert_cmpuint(slab.blocks->len, ==, 3);
+  g_assert_cmpuint(slab.live, ==, objects->len);
+
+  // Objects come back zeroed, aligned and never overlap
+  for (guint i = 0; i < objects->len; i++) {
+    TestObject *object = g_ptr_array_index(objects, i);
+    g_assert_cmpuint((guintptr)object % sizeof(gpointer), ==, 0);
+    g_assert_null(object->link);
+    g_assert_cmpint(object->id, ==, 0);
+    object->id = i + 1;
+  }
+  for (guint i = 0; i < objects->len; i++) {
+    TestObject *object = g_ptr_array_index(objects, i);
+    g_assert_cmpint(object->id, ==, i + 1);
+  }
+
+  g_ptr_array_free(objects, TRUE);
+  model_slab_clear(&slab);
+  g_assert_null(slab.blocks);
+  g_assert_cmpuint(slab.live, ==, 0);
+}
+
+// Test: Freed objects are handed out again, most recent first and zeroed
+static void test_slab_free_list(void) {
+  ModelSlab slab = {0};
+
+  TestObject *a = model_slab_new0(&slab, TestObject);
+  TestObject *b = model_slab_new0(&slab, TestObject);
+  TestObject *c = model_slab_new0(&slab, TestObject);
+  a->id = 1;
+  b->id = 2;
+  b->value = 4.5;
+  c->id = 3;
+
+  model_slab_free(&slab, b);
+  model_slab_free(&slab, a);
+  model_slab_free(&slab, NULL);
+  g_assert_cmpuint(slab.live, ==, 1);
+
+  TestObject *reused = model_slab_new0(&slab, TestObject);
+  g_assert_true(reused == a);
+  g_assert_null(reused->link);
+  g_assert_cmpint(reused->id, ==, 0);
+
+  reused = model_slab_new0(&slab, TestObject);
+  g_assert_true(reused == b);
+  g_assert_null(reused->link);
+  g_assert_cmpfloat(reused->value, ==, 0.0);
+
+  // Free list is empty again, so the next object is a fresh slot
+  TestObject *fresh = model_slab_new0(&slab, TestObject);
+  g_assert_true(fresh != a && fresh != b && fresh != c);
+  g_assert_cmpint(c->id, ==, 3);
+  g_assert_cmpuint(slab.live, ==, 4);
+
+  // Freed slots are visited by foreach along with the live ones
+  model_slab_free(&slab, c);
+  guint visited = 0;
+  model_slab_foreach(&slab, count_object, &visited);
+  g_assert_cmpuint(visited, ==, 4);
+  g_assert_cmpuint(slab.live, ==, 3);
+
+  model_slab_clear(&slab);
+}
+
+// Test: Reset forgets every object but keeps the largest block
+static void test_slab_reset(void) {
+  ModelSlab slab = {0};
+
+  for (int i = 0; i < 1000; i++) {
+    TestObject *object = model_slab_new0(&slab, TestObject);
+    object->id = i + 1;
+  }
+  g_assert_cmpuint(slab.blocks->len, ==, 3);
+  TestObject *freed = model_slab_new0(&slab, TestObject);
+  model_slab_free(&slab, freed);
+
+  model_slab_reset(&slab);
+  g_assert_cmpuint(slab.blocks->len, ==, 1);
+  g_assert_cmpuint(slab.live, ==, 0);
+  g_assert_null(slab.free_list);
+
+  guint count = 0;
+  model_slab_foreach(&slab, count_object, &count);
+  g_assert_cmpuint(count, ==, 0);
+
+  // The kept 1024-object block takes a space of similar size without growing
+  for (int i = 0; i < 1024; i++) {
+    TestObject *object = model_slab_new0(&slab, TestObject);
+    g_assert_cmpint(object->id, ==, 0);
+    g_assert_null(object->link);
+  }
+  g_assert_cmpuint(slab.blocks->len, ==, 1);
+  count = 0;
+  model_slab_foreach(&slab, count_object, &count);
+  g_assert_cmpuint(count, ==, 1024);
+
+  model_slab_new0(&slab, TestObject);
+  g_assert_cmpuint(slab.blocks->len, ==, 2);
+
+  model_slab_clear(&slab);
+
+  // Resetting an unused slab is a no-op
+  model_slab_reset(&slab);
+  g_assert_null(slab.blocks);
+}
+
+// Test: Arena strings and arrays live until the arena is reset
+static void test_arena_strings_and_arrays(void) {
+  ModelArena arena = {0};
+
+  g_assert_null(model_arena_strdup(&arena, NULL));
+  char source[] = "9c1e1a42-0000-4000-8000-000000000001";
+  gchar *copy = model_arena_strdup(&arena, source);
+  g_assert_true(copy != source);
+  g_assert_cmpstr(copy, ==, source);
+  source[0] = 'x';
+  g_assert_cmpstr(copy, ==, "9c1e1a42-0000-4000-8000-000000000001");
+
+  GArray *array = g_array_new(FALSE, FALSE, sizeof(int));
+  g_assert_true(model_arena_adopt_array(&arena, array) == array);
+  g_assert_null(model_arena_adopt_array(&arena, NULL));
+  g_assert_cmpuint(arena.arrays->len, ==, 1);
+
+  model_slab_new0(&arena.elements, TestObject);
+  model_arena_reset(&arena);
+  g_assert_cmpuint(arena.arrays->len, ==, 0);
+  g_assert_cmpuint(arena.elements.live, ==, 0);
+  g_assert_cmpstr(model_arena_strdup(&arena, "after reset"), ==, "after reset");
+
+  model_arena_clear(&arena);
+  g_assert_null(arena.strings);
+  g_assert_null(arena.arrays);
+  g_assert_null(arena.elements.blocks);
+}
+
+// Test: Edited strings replace each other on the heap, not in the chunk
+static void test_arena_set_string(void) {
+  ModelArena arena = {0};
+  gchar *field = model_arena_strdup(&arena, "loaded");
+
+  // A chunk string is left in place and the edit is tracked
+  model_arena_set_string(&arena, &field, "edit 0");
+  g_assert_cmpstr(field, ==, "edit 0");
+  g_assert_cmpuint(g_hash_table_size(arena.edited), ==, 1);
+
+  // Repeated edits keep one live copy
+  for (int i = 1; i <= 100; i++) {
+    gchar *value = g_strdup_printf("edit %d", i);
+    model_arena_set_string(&arena, &field, value);
+    g_free(value);
+  }
+  g_assert_cmpstr(field, ==, "edit 100");
+  g_assert_cmpuint(g_hash_table_size(arena.edited), ==, 1);
+  g_assert_true(g_hash_table_contains(arena.edited, field));
+
+  // Setting a field from its own value is safe
+  model_arena_set_string(&arena, &field, field + 5);
+  g_assert_cmpstr(field, ==, "100");
+
+  model_arena_set_string(&arena, &field, NULL);
+  g_assert_null(field);
+  g_assert_cmpuint(g_hash_table_size(arena.edited), ==, 0);
+
+  model_arena_set_string(&arena, &field, "kept until reset");
+  model_arena_reset(&arena);
+  g_assert_cmpuint(g_hash_table_size(arena.edited), ==, 0);
+
+  model_arena_clear(&arena);
+  g_assert_null(arena.edited);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_func("/model_arena/slab-growth", test_slab_growth);
+  g_test_add_func("/model_arena/slab-free-list", test_slab_free_list);
+  g_test_add_func("/model_arena/slab-reset", test_slab_reset);
+  g_test_add_func("/model_arena/strings-and-arrays", test_arena_strings_and_arrays);
+  g_test_add_func("/model_arena/set-string", test_arena_set_string);
+
+  return g_test_run();
+}
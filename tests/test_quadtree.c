@@ -0,0 +1,149 @@
+#include "quadtree.h"
+#include <glib.h>
+#include <math.h>
+
+#define TEST_EXTENT 1024.0
+
+static QuadTreeNode* test_root(QuadTree *tree) {
+  return &g_array_index(tree->nodes, QuadTreeNode, tree->root);
+}
+
+static Element* test_make_grid(guint count, double spacing) {
+  Element *elements = g_new0(Element, count);
+  guint columns = (guint)ceil(sqrt(count));
+  for (guint i = 0; i < count; i++) {
+    elements[i].type = ELEMENT_NOTE;
+    elements[i].x = (i % columns) * spacing + 2.0;
+    elements[i].y = (i / columns) * spacing + 2.0;
+    elements[i].width = 10.0;
+    elements[i].height = 10.0;
+  }
+  return elements;
+}
+
+static gboolean test_rect_finds(QuadTree *tree, Element *element,
+                                double x, double y, double width, double height) {
+  GPtrArray *results = g_ptr_array_new();
+  quadtree_query_rect(tree, x, y, width, height, results);
+  gboolean found = g_ptr_array_find(results, element, NULL);
+  g_ptr_array_free(results, TRUE);
+  return found;
+}
+
+// Test: Removed elements are no longer found and removing twice is harmless
+static void test_quadtree_remove(void) {
+  QuadTree *tree = quadtree_new(0, 0, TEST_EXTENT, TEST_EXTENT);
+  Element *elements = test_make_grid(200, 60.0);
+  for (guint i = 0; i < 200; i++) {
+    quadtree_insert(tree, &elements[i]);
+  }
+
+  Element *gone = &elements[57];
+  g_assert_true(test_rect_finds(tree, gone, gone->x, gone->y, 1, 1));
+  quadtree_remove(tree, gone);
+  g_assert_false(quadtree_contains(tree, gone));
+  g_assert_false(test_rect_finds(tree, gone, gone->x, gone->y, 1, 1));
+  quadtree_remove(tree, gone);
+
+  GPtrArray *results = g_ptr_array_new();
+  quadtree_query_rect(tree, -TEST_EXTENT, -TEST_EXTENT, 4 * TEST_EXTENT, 4 * TEST_EXTENT, results);
+  g_assert_cmpuint(results->len, ==, 199);
+  g_ptr_array_free(results, TRUE);
+
+  // Removing an element never inserted leaves the tree alone
+  Element stranger = { .type = ELEMENT_NOTE, .x = 5, .y = 5, .width = 10, .height = 10 };
+  quadtree_remove(tree, &stranger);
+  g_assert_true(test_rect_finds(tree, &elements[0], 0, 0, 20, 20));
+
+  quadtree_free(tree);
+  g_free(elements);
+}
+
+// Test: Updates move an element's entries and inserts unknown elements
+static void test_quadtree_update(void) {
+  QuadTree *tree = quadtree_new(0, 0, TEST_EXTENT, TEST_EXTENT);
+  Element *elements = test_make_grid(150, 70.0);
+  for (guint i = 0; i < 150; i++) {
+    quadtree_insert(tree, &elements[i]);
+  }
+
+  Element *moved = &elements[3];
+  double old_x = moved->x, old_y = moved->y;
+  moved->x = 900.0;
+  moved->y = 40.0;
+  quadtree_update(tree, moved);
+  g_assert_false(test_rect_finds(tree, moved, old_x, old_y, 1, 1));
+  g_assert_true(test_rect_finds(tree, moved, 905.0, 45.0, 1, 1));
+
+  // Resizing across a node boundary is found from both sides
+  moved->width = 300.0;
+  quadtree_update(tree, moved);
+  g_assert_true(test_rect_finds(tree, moved, 1150.0, 45.0, 1, 1));
+  g_assert_true(test_rect_finds(tree, moved, 905.0, 45.0, 1, 1));
+
+  // Content outside the initial extent grows the root
+  moved->x = -5000.0;
+  moved->y = 7000.0;
+  quadtree_update(tree, moved);
+  g_assert_true(test_rect_finds(tree, moved, -4990.0, 7005.0, 1, 1));
+  g_assert_false(test_rect_finds(tree, moved, 905.0, 45.0, 1, 1));
+
+  // An unchanged update is a no-op and an unknown element is inserted
+  quadtree_update(tree, moved);
+  g_assert_true(test_rect_finds(tree, moved, -4990.0, 7005.0, 1, 1));
+  Element fresh = { .type = ELEMENT_NOTE, .x = 300, .y = 300, .width = 10, .height = 10 };
+  quadtree_update(tree, &fresh);
+  g_assert_true(quadtree_contains(tree, &fresh));
+  g_assert_true(test_rect_finds(tree, &fresh, 305, 305, 1, 1));
+
+  quadtree_free(tree);
+  g_free(elements);
+}
+
+// Test: A subdivided node thinned to QUADTREE_MERGE_ELEMENTS folds into a leaf
+static void test_quadtree_merge(void) {
+  QuadTree *tree = quadtree_new(0, 0, TEST_EXTENT, TEST_EXTENT);
+  const guint count = QUADTREE_LEAF_CAPACITY * 3;
+  // Spacing keeps every element inside one leaf at any depth
+  Element *elements = test_make_grid(count, 64.0);
+  for (guint i = 0; i < count; i++) {
+    quadtree_insert(tree, &elements[i]);
+  }
+  g_assert_cmpint(test_root(tree)->first_child, !=, QUADTREE_NONE);
+
+  guint keep = QUADTREE_MERGE_ELEMENTS;
+  for (guint i = keep; i < count; i++) {
+    quadtree_remove(tree, &elements[i]);
+  }
+
+  QuadTreeNode *root = test_root(tree);
+  g_assert_cmpint(root->first_child, ==, QUADTREE_NONE);
+  g_assert_cmpuint(root->count, ==, keep);
+  g_assert_cmpuint(tree->free_groups->len, >, 0);
+
+  for (guint i = 0; i < keep; i++) {
+    g_assert_true(quadtree_contains(tree, &elements[i]));
+    g_assert_true(test_rect_finds(tree, &elements[i], elements[i].x + 1, elements[i].y + 1, 1, 1));
+  }
+
+  // Released child groups are reused when the leaf splits again
+  guint free_before = tree->free_groups->len;
+  for (guint i = keep; i < count; i++) {
+    quadtree_insert(tree, &elements[i]);
+  }
+  g_assert_cmpint(test_root(tree)->first_child, !=, QUADTREE_NONE);
+  g_assert_cmpuint(tree->free_groups->len, <, free_before);
+
+  quadtree_free(tree);
+  g_free(elements);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_func("/quadtree/remove", test_quadtree_remove);
+  g_test_add_func("/quadtree/update", test_quadtree_update);
+  g_test_add_func("/quadtree/merge", test_quadtree_merge);
+
+  return g_test_run();
+}
@@ -0,0 +1,192 @@
+#include "rtree.h"
+#include <glib.h>
+
+#define TEST_ELEMENTS 2000
+#define TEST_STEPS 5000
+// Unions store x and width, so the far edge can be off by rounding
+#define TEST_EDGE_EPSILON 1e-9
+
+// Scatter elements deterministically; some are degenerate lines or points
+static void test_place(Element *element, guint seed) {
+  element->x = (double)(seed * 37 % 211) * 40.0 - 4000.0;
+  element->y = (double)(seed * 53 % 199) * 40.0 - 4000.0;
+  element->width = seed % 8 == 0 ? 0.0 : (double)(seed % 13) * 20.0 + 1.0;
+  element->height = seed % 8 == 3 ? 0.0 : (double)(seed % 11) * 25.0 + 1.0;
+  element->rotation_degrees = seed % 5 == 0 ? (double)(seed % 360) : 0.0;
+}
+
+static gboolean test_bounds_within(const SpatialBounds *outer, const SpatialBounds *inner) {
+  return inner->x >= outer->x && inner->y >= outer->y &&
+         inner->x + inner->width <= outer->x + outer->width + TEST_EDGE_EPSILON &&
+         inner->y + inner->height <= outer->y + outer->height + TEST_EDGE_EPSILON;
+}
+
+// Walk the tree checking parent links, node bounds and the leaf map; returns
+// the number of elements stored below node
+static guint test_check_node(RTree *tree, RTreeNode *node, guint depth, guint *leaf_depth) {
+  g_assert_cmpuint(node->count, <=, RTREE_MAX_ENTRIES);
+  if (node != tree->root) {
+    g_assert_cmpuint(node->count, >, 0);
+  }
+
+  guint elements = 0;
+  for (guint i = 0; i < node->count; i++) {
+    g_assert_true(test_bounds_within(&node->bounds, &node->entry_bounds[i]));
+    if (node->leaf) {
+      Element *element = node->entries[i];
+      g_assert_true(g_hash_table_lookup(tree->leaves, element) == node);
+      SpatialBounds bounds;
+      spatial_index_element_bounds(element, &bounds);
+      g_assert_cmpfloat(node->entry_bounds[i].x, ==, bounds.x);
+      g_assert_cmpfloat(node->entry_bounds[i].y, ==, bounds.y);
+      g_assert_cmpfloat(node->entry_bounds[i].width, ==, bounds.width);
+      g_assert_cmpfloat(node->entry_bounds[i].height, ==, bounds.height);
+      elements++;
+    } else {
+      RTreeNode *child = node->entries[i];
+      g_assert_true(child->parent == node);
+      g_assert_true(test_bounds_within(&node->entry_bounds[i], &child->bounds));
+      elements += test_check_node(tree, child, depth + 1, leaf_depth);
+    }
+  }
+
+  // Every leaf sits at the same depth
+  if (node->leaf && node->count > 0) {
+    if (*leaf_depth == 0) *leaf_depth = depth;
+    g_assert_cmpuint(depth, ==, *leaf_depth);
+  }
+  return elements;
+}
+
+static void test_check_structure(RTree *tree) {
+  g_assert_null(tree->root->parent);
+  guint leaf_depth = 0;
+  g_assert_cmpuint(test_check_node(tree, tree->root, 1, &leaf_depth), ==, g_hash_table_size(tree->leaves));
+}
+
+// Test: Empty trees and degenerate input keep a valid leaf root
+static void test_rtree_empty(void) {
+  RTree *tree = rtree_new();
+  Element element = { .type = ELEMENT_NOTE, .x = 10, .y = 10, .width = 0, .height = 0 };
+
+  test_check_structure(tree);
+  g_assert_true(tree->root->leaf);
+  rtree_remove(tree, &element);
+  g_assert_false(rtree_contains(tree, &element));
+
+  rtree_bulk_load(tree, NULL, 0);
+  test_check_structure(tree);
+  g_assert_true(tree->root->leaf);
+  g_assert_cmpuint(tree->root->count, ==, 0);
+
+  rtree_update(tree, &element);
+  test_check_structure(tree);
+  g_assert_true(rtree_contains(tree, &element));
+  g_assert_cmpuint(tree->root->count, ==, 1);
+
+  // Removing the last element leaves a usable empty root
+  rtree_remove(tree, &element);
+  test_check_structure(tree);
+  g_assert_true(tree->root->leaf);
+  g_assert_cmpuint(tree->root->count, ==, 0);
+
+  rtree_free(tree);
+}
+
+// Test: Bulk loading skips duplicate pointers and replaces the leaf map
+static void test_rtree_bulk_load_duplicates(void) {
+  RTree *tree = rtree_new();
+  Element elements[3] = {
+    { .type = ELEMENT_NOTE, .x = 0, .y = 0, .width = 10, .height = 10 },
+    { .type = ELEMENT_NOTE, .x = 50, .y = 0, .width = 10, .height = 10 },
+    { .type = ELEMENT_NOTE, .x = 100, .y = 0, .width = 10, .height = 10 },
+  };
+  Element *pointers[] = { &elements[0], &elements[1], &elements[0], &elements[1] };
+
+  rtree_bulk_load(tree, pointers, G_N_ELEMENTS(pointers));
+  test_check_structure(tree);
+  g_assert_cmpuint(g_hash_table_size(tree->leaves), ==, 2);
+
+  Element *replacement[] = { &elements[2] };
+  rtree_bulk_load(tree, replacement, 1);
+  test_check_structure(tree);
+  g_assert_cmpuint(g_hash_table_size(tree->leaves), ==, 1);
+  g_assert_false(rtree_contains(tree, &elements[0]));
+  g_assert_true(rtree_contains(tree, &elements[2]));
+
+  rtree_free(tree);
+}
+
+// Test: Bulk load, edits and repacking keep node bounds, parent links, the
+// leaf map and leaf depth consistent
+static void test_rtree_edits(void) {
+  Element *elements = g_new0(Element, TEST_ELEMENTS);
+  Element **pointers = g_new(Element*, TEST_ELEMENTS);
+  gboolean *live = g_new0(gboolean, TEST_ELEMENTS);
+
+  // Bulk load three quarters of the elements, several levels deep
+  guint loaded = TEST_ELEMENTS * 3 / 4;
+  for (guint i = 0; i < TEST_ELEMENTS; i++) {
+    elements[i].type = i % 6 == 0 ? ELEMENT_CONNECTION : ELEMENT_NOTE;
+    test_place(&elements[i], i);
+    pointers[i] = &elements[i];
+    live[i] = i < loaded;
+  }
+
+  RTree *tree = rtree_new();
+  rtree_bulk_load(tree, pointers, loaded);
+  test_check_structure(tree);
+  g_assert_false(tree->root->leaf);
+
+  for (guint step = 0; step < TEST_STEPS; step++) {
+    guint i = step * 7919 % TEST_ELEMENTS;
+    if (step % 3 == 0) {
+      rtree_remove(tree, &elements[i]);
+      live[i] = FALSE;
+    } else {
+      // Moves live elements and inserts dead ones; some keep their bounds
+      if (step % 4 != 0) {
+        test_place(&elements[i], i + step);
+      }
+      rtree_update(tree, &elements[i]);
+      live[i] = TRUE;
+    }
+    g_assert_cmpint(rtree_contains(tree, &elements[i]), ==, live[i]);
+
+    if (step % 100 == 0) {
+      test_check_structure(tree);
+    }
+  }
+  test_check_structure(tree);
+
+  guint live_count = 0;
+  for (guint i = 0; i < TEST_ELEMENTS; i++) {
+    if (live[i]) pointers[live_count++] = &elements[i];
+  }
+  rtree_bulk_load(tree, pointers, live_count);
+  test_check_structure(tree);
+  g_assert_cmpuint(g_hash_table_size(tree->leaves), ==, live_count);
+
+  // Removing everything collapses back to an empty leaf root
+  for (guint i = 0; i < TEST_ELEMENTS; i++) {
+    rtree_remove(tree, &elements[i]);
+  }
+  test_check_structure(tree);
+  g_assert_true(tree->root->leaf);
+  g_assert_cmpuint(tree->root->count, ==, 0);
+
+  rtree_free(tree);
+  g_free(live);
+  g_free(pointers);
+  g_free(elements);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_func("/rtree/empty", test_rtree_empty);
+  g_test_add_func("/rtree/bulk-load-duplicates", test_rtree_bulk_load_duplicates);
+  g_test_add_func("/rtree/edits", test_rtree_edits);
+
+  return g_test_run();
+}
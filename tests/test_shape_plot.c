@@ -0,0 +1,169 @@
+#include "elements/shape.h"
+#include <glib.h>
+#include <math.h>
+
+#define TEST_SERIES_LENGTH 1000
+#define TEST_THRESHOLD 50
+
+static void test_make_series(GArray *xs, GArray *ys, guint count) {
+  for (guint i = 0; i < count; i++) {
+    double x = i;
+    double y = sin(i * 0.05);
+    g_array_append_val(xs, x);
+    g_array_append_val(ys, y);
+  }
+}
+
+// Test: LTTB keeps both endpoints, returns at most threshold points in order
+// and keeps an isolated peak
+static void test_downsample_bounds(void) {
+  GArray *xs = g_array_new(FALSE, FALSE, sizeof(double));
+  GArray *ys = g_array_new(FALSE, FALSE, sizeof(double));
+  test_make_series(xs, ys, TEST_SERIES_LENGTH);
+  g_array_index(ys, double, 437) = 25.0;
+
+  GArray *out_x = g_array_new(FALSE, FALSE, sizeof(double));
+  GArray *out_y = g_array_new(FALSE, FALSE, sizeof(double));
+  shape_plot_downsample((const double*)xs->data, (const double*)ys->data, xs->len,
+                        TEST_THRESHOLD, out_x, out_y);
+
+  g_assert_cmpuint(out_x->len, ==, out_y->len);
+  g_assert_cmpuint(out_x->len, <=, TEST_THRESHOLD);
+  g_assert_cmpuint(out_x->len, >=, 3);
+  g_assert_cmpfloat(g_array_index(out_x, double, 0), ==, 0.0);
+  g_assert_cmpfloat(g_array_index(out_y, double, 0), ==, g_array_index(ys, double, 0));
+  g_assert_cmpfloat(g_array_index(out_x, double, out_x->len - 1), ==, TEST_SERIES_LENGTH - 1);
+  g_assert_cmpfloat(g_array_index(out_y, double, out_y->len - 1), ==,
+                    g_array_index(ys, double, TEST_SERIES_LENGTH - 1));
+
+  gboolean peak = FALSE;
+  for (guint i = 0; i < out_x->len; i++) {
+    double x = g_array_index(out_x, double, i);
+    if (i > 0) {
+      g_assert_cmpfloat(x, >, g_array_index(out_x, double, i - 1));
+    }
+    // Every kept point comes from the input
+    g_assert_cmpfloat(g_array_index(out_y, double, i), ==, g_array_index(ys, double, (guint)x));
+    if (x == 437.0) peak = TRUE;
+  }
+  g_assert_true(peak);
+
+  g_array_free(out_x, TRUE);
+  g_array_free(out_y, TRUE);
+  g_array_free(xs, TRUE);
+  g_array_free(ys, TRUE);
+}
+
+// Test: Series no longer than the threshold come back unchanged
+static void test_downsample_short_input(void) {
+  GArray *xs = g_array_new(FALSE, FALSE, sizeof(double));
+  GArray *ys = g_array_new(FALSE, FALSE, sizeof(double));
+  test_make_series(xs, ys, TEST_THRESHOLD);
+
+  const guint thresholds[] = { TEST_THRESHOLD, TEST_THRESHOLD * 2, 2 };
+  for (guint t = 0; t < G_N_ELEMENTS(thresholds); t++) {
+    GArray *out_x = g_array_new(FALSE, FALSE, sizeof(double));
+    GArray *out_y = g_array_new(FALSE, FALSE, sizeof(double));
+    shape_plot_downsample((const double*)xs->data, (const double*)ys->data, xs->len,
+                          thresholds[t], out_x, out_y);
+    g_assert_cmpmem(out_x->data, out_x->len * sizeof(double), xs->data, xs->len * sizeof(double));
+    g_assert_cmpmem(out_y->data, out_y->len * sizeof(double), ys->data, ys->len * sizeof(double));
+    g_array_free(out_x, TRUE);
+    g_array_free(out_y, TRUE);
+  }
+
+  g_array_free(xs, TRUE);
+  g_array_free(ys, TRUE);
+}
+
+#define TEST_PLOT_SIZE 200
+
+static Shape* test_plot_shape(const char *text) {
+  ElementPosition position = {0, 0, 0};
+  ElementSize size = {TEST_PLOT_SIZE, TEST_PLOT_SIZE};
+  ElementColor color = {1.0, 1.0, 1.0, 1.0};
+  ElementText element_text = {(char*)text, {0.0, 0.0, 0.0, 1.0}, "Sans 8"};
+  ElementShape shape_config = {
+    .shape_type = SHAPE_PLOT,
+    .stroke_width = 2,
+    .stroke_color = {0.0, 0.0, 0.0, 1.0},
+  };
+  return shape_create(position, size, color, 2, SHAPE_PLOT, FALSE, element_text, shape_config, NULL, NULL);
+}
+
+static GBytes* test_render(Shape *shape) {
+  cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, TEST_PLOT_SIZE, TEST_PLOT_SIZE);
+  cairo_t *cr = cairo_create(surface);
+  element_draw((Element*)shape, cr, FALSE);
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+  GBytes *pixels = g_bytes_new(cairo_image_surface_get_data(surface),
+                               cairo_image_surface_get_stride(surface) * TEST_PLOT_SIZE);
+  cairo_surface_destroy(surface);
+  return pixels;
+}
+
+// Render of a freshly created plot with the shape's current text
+static GBytes* test_render_fresh(Shape *shape) {
+  Shape *fresh = test_plot_shape(shape->text);
+  GBytes *pixels = test_render(fresh);
+  shape_free((Element*)fresh);
+  return pixels;
+}
+
+static void test_assert_renders_current_text(Shape *shape) {
+  GBytes *cached = test_render(shape);
+  GBytes *fresh = test_render_fresh(shape);
+  g_assert_true(g_bytes_equal(cached, fresh));
+  g_bytes_unref(cached);
+  g_bytes_unref(fresh);
+}
+
+// Test: A drawn plot follows text replacement and in-place edits once the
+// element is invalidated, as every text writer does
+static void test_plot_cache_invalidation(void) {
+  Shape *shape = test_plot_shape("1,2\n3,4");
+  GBytes *first = test_render(shape);
+  g_assert_nonnull(shape->plot_data);
+
+  // Unchanged text draws the same from the cached parse
+  GBytes *again = test_render(shape);
+  g_assert_true(g_bytes_equal(first, again));
+  g_bytes_unref(again);
+
+  // New text is reparsed
+  g_free(shape->text);
+  shape->text = g_strdup("line \"a\" -5,0 10,20");
+  element_invalidate((Element*)shape);
+  GBytes *replaced = test_render(shape);
+  g_assert_false(g_bytes_equal(first, replaced));
+  test_assert_renders_current_text(shape);
+
+  // An edit in the same buffer is picked up as well
+  shape->text[10] = '7';
+  element_invalidate((Element*)shape);
+  GBytes *edited = test_render(shape);
+  g_assert_false(g_bytes_equal(replaced, edited));
+  test_assert_renders_current_text(shape);
+
+  // Empty text falls back to the bare axes
+  g_free(shape->text);
+  shape->text = g_strdup("");
+  element_invalidate((Element*)shape);
+  test_assert_renders_current_text(shape);
+
+  g_bytes_unref(first);
+  g_bytes_unref(replaced);
+  g_bytes_unref(edited);
+  shape_free((Element*)shape);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_func("/shape_plot/downsample-bounds", test_downsample_bounds);
+  g_test_add_func("/shape_plot/downsample-short-input", test_downsample_short_input);
+  g_test_add_func("/shape_plot/cache-invalidation", test_plot_cache_invalidation);
+
+  return g_test_run();
+}
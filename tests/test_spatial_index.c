@@ -0,0 +1,258 @@
+#include "spatial_index.h"
+#include <glib.h>
+#include <math.h>
+
+// Every backend is driven through the SpatialIndex interface and checked
+// against a linear scan; backend internals are covered by test_quadtree.c and
+// test_rtree.c
+
+#define TEST_EXTENT 4096.0
+// Large enough to cover elements placed outside the initial extent
+#define TEST_WORLD (4 * SPATIAL_INDEX_INITIAL_EXTENT)
+// Fixed seed so a failure replays the same operation sequence
+#define TEST_RANDOM_SEED 20240612
+#define TEST_RANDOM_ELEMENTS 2000
+#define TEST_RANDOM_STEPS 5000
+
+static SpatialIndex* test_index_new(gconstpointer data) {
+  SpatialIndex *index = spatial_index_new((SpatialIndexKind)GPOINTER_TO_INT(data));
+  g_assert_nonnull(index);
+  return index;
+}
+
+static void test_random_place(Element *element, GRand *rand) {
+  // A few elements land past the initial extent so bounded backends have to grow
+  double extent = g_rand_int_range(rand, 0, 40) == 0 ? SPATIAL_INDEX_INITIAL_EXTENT : TEST_EXTENT;
+  element->x = g_rand_double_range(rand, -extent, extent);
+  element->y = g_rand_double_range(rand, -extent, extent);
+  // Some elements are degenerate lines or points
+  element->width = g_rand_int_range(rand, 0, 8) == 0 ? 0.0 : g_rand_double_range(rand, 1.0, 300.0);
+  element->height = g_rand_int_range(rand, 0, 8) == 0 ? 0.0 : g_rand_double_range(rand, 1.0, 300.0);
+  element->rotation_degrees = g_rand_int_range(rand, 0, 5) == 0 ? g_rand_double_range(rand, 0.0, 360.0) : 0.0;
+}
+
+// Rect queries report exactly the live elements whose bounds intersect, once each
+static void test_check_rect(SpatialIndex *index, Element *elements, const gboolean *live, guint count,
+                            double x, double y, double width, double height) {
+  GPtrArray *results = g_ptr_array_new();
+  spatial_index_query_rect(index, x, y, width, height, results);
+
+  GHashTable *seen = g_hash_table_new(NULL, NULL);
+  for (guint i = 0; i < results->len; i++) {
+    g_assert_true(g_hash_table_add(seen, g_ptr_array_index(results, i)));
+  }
+
+  SpatialBounds rect = { x, y, width, height };
+  guint expected = 0;
+  for (guint i = 0; i < count; i++) {
+    gboolean hit = live[i] && spatial_bounds_intersects_element(&rect, &elements[i]);
+    g_assert_cmpint(g_hash_table_contains(seen, &elements[i]), ==, hit);
+    if (hit) expected++;
+  }
+  g_assert_cmpuint(results->len, ==, expected);
+
+  g_hash_table_destroy(seen);
+  g_ptr_array_free(results, TRUE);
+}
+
+// Point queries return picking candidates: never a removed element or a
+// duplicate, and never missing an element whose bounds cover the point
+static void test_check_point(SpatialIndex *index, Element *elements, const gboolean *live, guint count,
+                             double x, double y) {
+  GPtrArray *results = g_ptr_array_new();
+  spatial_index_query_point(index, x, y, results);
+
+  GHashTable *seen = g_hash_table_new(NULL, NULL);
+  for (guint i = 0; i < results->len; i++) {
+    g_assert_true(g_hash_table_add(seen, g_ptr_array_index(results, i)));
+  }
+
+  for (guint i = 0; i < count; i++) {
+    if (!live[i]) {
+      g_assert_false(g_hash_table_contains(seen, &elements[i]));
+      continue;
+    }
+    SpatialBounds bounds;
+    spatial_index_element_bounds(&elements[i], &bounds);
+    if (spatial_bounds_contains_point(&bounds, x, y)) {
+      g_assert_true(g_hash_table_contains(seen, &elements[i]));
+    }
+  }
+
+  g_hash_table_destroy(seen);
+  g_ptr_array_free(results, TRUE);
+}
+
+static void test_check_random_queries(SpatialIndex *index, Element *elements, const gboolean *live,
+                                      guint count, GRand *rand) {
+  for (guint q = 0; q < 4; q++) {
+    // Zero-sized query rects are points and lines
+    double width = q == 0 ? 0.0 : g_rand_double_range(rand, 1.0, TEST_EXTENT / 2);
+    double height = q <= 1 ? 0.0 : g_rand_double_range(rand, 1.0, TEST_EXTENT / 2);
+    test_check_rect(index, elements, live, count,
+                    g_rand_double_range(rand, -TEST_EXTENT, TEST_EXTENT),
+                    g_rand_double_range(rand, -TEST_EXTENT, TEST_EXTENT), width, height);
+  }
+  test_check_point(index, elements, live, count,
+                   g_rand_double_range(rand, -TEST_EXTENT, TEST_EXTENT),
+                   g_rand_double_range(rand, -TEST_EXTENT, TEST_EXTENT));
+}
+
+// Test: Empty indexes and degenerate input answer queries without crashing
+static void test_spatial_index_empty(gconstpointer data) {
+  SpatialIndex *index = test_index_new(data);
+  gboolean live[1] = { FALSE };
+  Element element = { .type = ELEMENT_NOTE, .x = 10, .y = 10, .width = 0, .height = 0 };
+
+  test_check_rect(index, &element, live, 1, -100, -100, 200, 200);
+  test_check_point(index, &element, live, 1, 10, 10);
+  spatial_index_remove(index, &element);
+  g_assert_false(spatial_index_contains(index, &element));
+
+  spatial_index_bulk_load(index, NULL, 0);
+  test_check_rect(index, &element, live, 1, 0, 0, 0, 0);
+
+  // A point-sized element is found by rects touching it and by its own point
+  spatial_index_update(index, &element);
+  live[0] = TRUE;
+  g_assert_true(spatial_index_contains(index, &element));
+  test_check_rect(index, &element, live, 1, 10, 10, 0, 0);
+  test_check_rect(index, &element, live, 1, 0, 0, 10, 10);
+  test_check_rect(index, &element, live, 1, 11, 11, 5, 5);
+  test_check_point(index, &element, live, 1, 10, 10);
+
+  // Removing the last element leaves a usable empty index
+  spatial_index_remove(index, &element);
+  live[0] = FALSE;
+  test_check_rect(index, &element, live, 1, -100, -100, 200, 200);
+  spatial_index_update(index, &element);
+  live[0] = TRUE;
+  test_check_point(index, &element, live, 1, 10, 10);
+
+  spatial_index_clear(index);
+  live[0] = FALSE;
+  g_assert_false(spatial_index_contains(index, &element));
+  test_check_rect(index, &element, live, 1, -100, -100, 200, 200);
+
+  spatial_index_free(index);
+}
+
+// Test: Bulk loading skips duplicate pointers and replaces earlier content
+static void test_spatial_index_bulk_load(gconstpointer data) {
+  SpatialIndex *index = test_index_new(data);
+  Element elements[3] = {
+    { .type = ELEMENT_NOTE, .x = 0, .y = 0, .width = 10, .height = 10 },
+    { .type = ELEMENT_NOTE, .x = 50, .y = 0, .width = 10, .height = 10 },
+    { .type = ELEMENT_NOTE, .x = 100, .y = 0, .width = 10, .height = 10 },
+  };
+  Element *pointers[] = { &elements[0], &elements[1], &elements[0], &elements[1] };
+  gboolean live[3] = { TRUE, TRUE, FALSE };
+
+  spatial_index_bulk_load(index, pointers, G_N_ELEMENTS(pointers));
+  test_check_rect(index, elements, live, 3, -10, -10, 200, 30);
+
+  Element *replacement[] = { &elements[2] };
+  spatial_index_bulk_load(index, replacement, 1);
+  live[0] = live[1] = FALSE;
+  live[2] = TRUE;
+  for (guint i = 0; i < 3; i++) {
+    g_assert_cmpint(spatial_index_contains(index, &elements[i]), ==, live[i]);
+  }
+  test_check_rect(index, elements, live, 3, -10, -10, 200, 30);
+
+  spatial_index_free(index);
+}
+
+// Test: Bulk load followed by random updates and removes agrees with a brute-force scan
+static void test_spatial_index_random(gconstpointer data) {
+  GRand *rand = g_rand_new_with_seed(TEST_RANDOM_SEED);
+  Element *elements = g_new0(Element, TEST_RANDOM_ELEMENTS);
+  Element **pointers = g_new(Element*, TEST_RANDOM_ELEMENTS);
+  gboolean *live = g_new0(gboolean, TEST_RANDOM_ELEMENTS);
+
+  guint loaded = TEST_RANDOM_ELEMENTS * 3 / 4;
+  for (guint i = 0; i < TEST_RANDOM_ELEMENTS; i++) {
+    elements[i].type = g_rand_int_range(rand, 0, 6) == 0 ? ELEMENT_CONNECTION : ELEMENT_NOTE;
+    test_random_place(&elements[i], rand);
+    pointers[i] = &elements[i];
+    live[i] = i < loaded;
+  }
+
+  SpatialIndex *index = test_index_new(data);
+  spatial_index_bulk_load(index, pointers, loaded);
+  for (guint q = 0; q < 20; q++) {
+    test_check_random_queries(index, elements, live, TEST_RANDOM_ELEMENTS, rand);
+  }
+
+  for (guint step = 0; step < TEST_RANDOM_STEPS; step++) {
+    guint i = g_rand_int_range(rand, 0, TEST_RANDOM_ELEMENTS);
+    if (g_rand_int_range(rand, 0, 3) == 0) {
+      spatial_index_remove(index, &elements[i]);
+      live[i] = FALSE;
+    } else {
+      // Moves live elements and inserts dead ones; some keep their bounds
+      if (g_rand_int_range(rand, 0, 4) != 0) {
+        test_random_place(&elements[i], rand);
+      }
+      spatial_index_update(index, &elements[i]);
+      live[i] = TRUE;
+    }
+    g_assert_cmpint(spatial_index_contains(index, &elements[i]), ==, live[i]);
+
+    if (step % 100 == 0) {
+      test_check_random_queries(index, elements, live, TEST_RANDOM_ELEMENTS, rand);
+    }
+  }
+  test_check_rect(index, elements, live, TEST_RANDOM_ELEMENTS,
+                  -TEST_WORLD, -TEST_WORLD, 2 * TEST_WORLD, 2 * TEST_WORLD);
+
+  // Reloading the edited content gives the same answers
+  guint live_count = 0;
+  for (guint i = 0; i < TEST_RANDOM_ELEMENTS; i++) {
+    if (live[i]) pointers[live_count++] = &elements[i];
+  }
+  spatial_index_bulk_load(index, pointers, live_count);
+  for (guint q = 0; q < 20; q++) {
+    test_check_random_queries(index, elements, live, TEST_RANDOM_ELEMENTS, rand);
+  }
+
+  // An emptied index finds nothing
+  for (guint i = 0; i < TEST_RANDOM_ELEMENTS; i++) {
+    spatial_index_remove(index, &elements[i]);
+    live[i] = FALSE;
+  }
+  test_check_rect(index, elements, live, TEST_RANDOM_ELEMENTS,
+                  -TEST_WORLD, -TEST_WORLD, 2 * TEST_WORLD, 2 * TEST_WORLD);
+
+  spatial_index_free(index);
+  g_free(live);
+  g_free(pointers);
+  g_free(elements);
+  g_rand_free(rand);
+}
+
+static void test_add_backend(const char *name, SpatialIndexKind kind) {
+  gconstpointer data = GINT_TO_POINTER(kind);
+  gchar *path;
+
+  path = g_strdup_printf("/spatial-index/%s/empty", name);
+  g_test_add_data_func(path, data, test_spatial_index_empty);
+  g_free(path);
+
+  path = g_strdup_printf("/spatial-index/%s/bulk-load", name);
+  g_test_add_data_func(path, data, test_spatial_index_bulk_load);
+  g_free(path);
+
+  path = g_strdup_printf("/spatial-index/%s/random", name);
+  g_test_add_data_func(path, data, test_spatial_index_random);
+  g_free(path);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  test_add_backend("quadtree", SPATIAL_INDEX_QUADTREE);
+  test_add_backend("rtree", SPATIAL_INDEX_RTREE);
+
+  return g_test_run();
+}
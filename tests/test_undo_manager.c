@@ -13,7 +13,7 @@ typedef struct {
 
 static void test_setup(TestFixture *fixture, gconstpointer user_data) {
   fixture->model = g_new0(Model, 1);
-  fixture->model->elements = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  fixture->model->elements = g_hash_table_new(g_direct_hash, g_direct_equal);
   fixture->undo_manager = undo_manager_new(fixture->model);
 }
 
@@ -145,7 +145,7 @@ static void test_complex_undo_redo(TestFixture *fixture, gconstpointer user_data
   element->bg_color->a = 1.0;
 
   // Add element to model's hash table - the hash table will own the element
-  g_hash_table_insert(fixture->model->elements, g_strdup(element->uuid), element);
+  model_insert_element(fixture->model, element);
 
   // Push multiple actions
   undo_manager_push_move_action(fixture->undo_manager, element, 100, 200, 150, 250);